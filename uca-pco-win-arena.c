@@ -0,0 +1,251 @@
+/**
+Copyright (C) 2016  Sai Sasidhar Maddali <sai.sasidhar92@gmail.com>
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+**/
+
+#include <windows.h>
+
+#include "uca-pco-win-camera.h"
+#include "uca-pco-win-arena.h"
+
+// Allocations are page aligned like the buffers the SDK allocates itself
+#define ARENA_ALIGNMENT     4096
+
+typedef struct {
+    gchar *base;
+    gsize size;
+    gsize used;
+} ArenaChunk;
+
+struct _UcaPcowinArena {
+    gboolean large_pages;
+    gint numa_node;
+    gsize chunk_size;
+    gsize page_size;
+
+    GArray *chunks;
+    guint current;
+};
+
+/*
+ * Large pages need SeLockMemoryPrivilege, which must be granted by policy and
+ * still be enabled in the process token before the first allocation.
+ */
+static gboolean
+enable_lock_memory_privilege (void)
+{
+    TOKEN_PRIVILEGES privileges;
+    HANDLE token;
+    gboolean enabled;
+
+    if (!OpenProcessToken (GetCurrentProcess (), TOKEN_ADJUST_PRIVILEGES | TOKEN_QUERY, &token))
+        return FALSE;
+
+    privileges.PrivilegeCount = 1;
+    privileges.Privileges[0].Attributes = SE_PRIVILEGE_ENABLED;
+
+    enabled = LookupPrivilegeValue (NULL, SE_LOCK_MEMORY_NAME, &privileges.Privileges[0].Luid) &&
+              AdjustTokenPrivileges (token, FALSE, &privileges, 0, NULL, NULL) &&
+              GetLastError () == ERROR_SUCCESS;
+
+    CloseHandle (token);
+
+    return enabled;
+}
+
+static gpointer
+allocate_pages (UcaPcowinArena *arena, gsize size)
+{
+    DWORD type = MEM_RESERVE | MEM_COMMIT;
+
+    if (arena->large_pages)
+        type |= MEM_LARGE_PAGES;
+
+    if (arena->numa_node != UCA_PCOWIN_ARENA_ANY_NODE)
+        return VirtualAllocExNuma (GetCurrentProcess (), NULL, size, type, PAGE_READWRITE, (DWORD) arena->numa_node);
+
+    return VirtualAlloc (NULL, size, type, PAGE_READWRITE);
+}
+
+/*
+ * Adds a chunk of at least @size bytes. Large pages and node binding are given
+ * up for good the first time they cannot be had, so the arena degrades to
+ * ordinary pageable memory instead of failing.
+ */
+static ArenaChunk *
+add_chunk (UcaPcowinArena *arena, gsize size, GError **error)
+{
+    ArenaChunk chunk = { NULL, 0, 0 };
+
+    for (;;) {
+        chunk.size = (MAX (size, arena->chunk_size) + arena->page_size - 1) / arena->page_size * arena->page_size;
+        chunk.base = allocate_pages (arena, chunk.size);
+
+        if (chunk.base != NULL)
+            break;
+
+        if (arena->large_pages) {
+            g_warning ("Could not allocate %" G_GSIZE_FORMAT " bytes of large pages (error %lu), using normal pages",
+                       chunk.size, (gulong) GetLastError ());
+            arena->large_pages = FALSE;
+            arena->page_size = ARENA_ALIGNMENT;
+        }
+        else if (arena->numa_node != UCA_PCOWIN_ARENA_ANY_NODE) {
+            g_warning ("Could not allocate memory on NUMA node %i (error %lu), using any node",
+                       arena->numa_node, (gulong) GetLastError ());
+            arena->numa_node = UCA_PCOWIN_ARENA_ANY_NODE;
+        }
+        else {
+            g_set_error (error, UCA_PCOWIN_CAMERA_ERROR, UCA_PCOWIN_CAMERA_ERROR_GENERAL,
+                         "Allocating %" G_GSIZE_FORMAT " bytes failed (error %lu)", chunk.size, (gulong) GetLastError ());
+            return NULL;
+        }
+    }
+
+    g_array_append_val (arena->chunks, chunk);
+
+    return &g_array_index (arena->chunks, ArenaChunk, arena->chunks->len - 1);
+}
+
+UcaPcowinArena *
+uca_pcowin_arena_new (gboolean large_pages, gint numa_node, gsize chunk_size)
+{
+    UcaPcowinArena *arena;
+    gsize large_page_size;
+
+    arena = g_new0 (UcaPcowinArena, 1);
+    arena->chunks = g_array_new (FALSE, FALSE, sizeof (ArenaChunk));
+    arena->numa_node = numa_node;
+    arena->chunk_size = chunk_size;
+    arena->page_size = ARENA_ALIGNMENT;
+
+    if (large_pages) {
+        large_page_size = GetLargePageMinimum ();
+
+        if (large_page_size == 0)
+            g_warning ("Large pages are not supported, using normal pages");
+        else if (!enable_lock_memory_privilege ())
+            g_warning ("SeLockMemoryPrivilege is not granted, using normal pages");
+        else {
+            arena->large_pages = TRUE;
+            arena->page_size = large_page_size;
+        }
+    }
+
+    return arena;
+}
+
+void
+uca_pcowin_arena_free (UcaPcowinArena *arena)
+{
+    if (arena == NULL)
+        return;
+
+    for (guint i = 0; i < arena->chunks->len; i++)
+        VirtualFree (g_array_index (arena->chunks, ArenaChunk, i).base, 0, MEM_RELEASE);
+
+    g_array_free (arena->chunks, TRUE);
+    g_free (arena);
+}
+
+// Memory lives until the arena is reset or freed
+gpointer
+uca_pcowin_arena_alloc (UcaPcowinArena *arena, gsize size, GError **error)
+{
+    ArenaChunk *chunk = NULL;
+    gpointer data;
+
+    size = (size + ARENA_ALIGNMENT - 1) / ARENA_ALIGNMENT * ARENA_ALIGNMENT;
+
+    // Chunks are reused in order after a reset
+    for (; arena->current < arena->chunks->len; arena->current++) {
+        chunk = &g_array_index (arena->chunks, ArenaChunk, arena->current);
+
+        if (chunk->size - chunk->used >= size)
+            break;
+
+        chunk = NULL;
+    }
+
+    if (chunk == NULL) {
+        chunk = add_chunk (arena, size, error);
+
+        if (chunk == NULL)
+            return NULL;
+
+        arena->current = arena->chunks->len - 1;
+    }
+
+    data = chunk->base + chunk->used;
+    chunk->used += size;
+
+    return data;
+}
+
+// Recycles all allocations while keeping the memory committed
+void
+uca_pcowin_arena_reset (UcaPcowinArena *arena)
+{
+    for (guint i = 0; i < arena->chunks->len; i++)
+        g_array_index (arena->chunks, ArenaChunk, i).used = 0;
+
+    arena->current = 0;
+}
+
+void
+uca_pcowin_arena_get_stats (UcaPcowinArena *arena, UcaPcowinArenaStats *stats)
+{
+    stats->page_size = arena->page_size;
+    stats->numa_node = arena->numa_node;
+    stats->n_chunks = arena->chunks->len;
+    stats->bytes_reserved = 0;
+    stats->bytes_used = 0;
+
+    for (guint i = 0; i < arena->chunks->len; i++) {
+        ArenaChunk *chunk = &g_array_index (arena->chunks, ArenaChunk, i);
+
+        stats->bytes_reserved += chunk->size;
+        stats->bytes_used += chunk->used;
+    }
+
+    stats->n_pages = stats->bytes_reserved / arena->page_size;
+}
+
+/*
+ * NUMA node of the lowest CPU in @cpu_mask, or of the CPU the calling thread
+ * currently runs on if @cpu_mask is 0.
+ */
+gint
+uca_pcowin_arena_get_thread_node (guint64 cpu_mask)
+{
+    PROCESSOR_NUMBER processor = { 0, 0, 0 };
+    USHORT node;
+
+    if (cpu_mask != 0) {
+        while (!(cpu_mask & 1)) {
+            cpu_mask >>= 1;
+            processor.Number++;
+        }
+    }
+    else
+        GetCurrentProcessorNumberEx (&processor);
+
+    if (!GetNumaProcessorNodeEx (&processor, &node) || node == 0xFFFF)
+        return UCA_PCOWIN_ARENA_ANY_NODE;
+
+    return node;
+}
@@ -0,0 +1,60 @@
+/*
+Copyright (C) 2016  Sai Sasidhar Maddali <sai.sasidhar92@gmail.com>
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+
+#ifndef __UCA_PCOWIN_ARENA_H
+#define __UCA_PCOWIN_ARENA_H
+
+#include <glib.h>
+
+G_BEGIN_DECLS
+
+#define UCA_PCOWIN_ARENA_ANY_NODE   (-1)
+
+/*
+ * Memory actually obtained by an arena. @page_size is the large page size if
+ * large pages were granted, @numa_node is UCA_PCOWIN_ARENA_ANY_NODE if the
+ * memory is not bound to a node.
+ */
+typedef struct {
+    gsize page_size;
+    guint64 n_pages;
+    guint64 bytes_reserved;
+    guint64 bytes_used;
+    gint numa_node;
+    guint n_chunks;
+} UcaPcowinArenaStats;
+
+typedef struct _UcaPcowinArena UcaPcowinArena;
+
+UcaPcowinArena     *uca_pcowin_arena_new            (gboolean            large_pages,
+                                                     gint                numa_node,
+                                                     gsize               chunk_size);
+void                uca_pcowin_arena_free           (UcaPcowinArena     *arena);
+gpointer            uca_pcowin_arena_alloc          (UcaPcowinArena     *arena,
+                                                     gsize               size,
+                                                     GError            **error);
+void                uca_pcowin_arena_reset          (UcaPcowinArena     *arena);
+void                uca_pcowin_arena_get_stats      (UcaPcowinArena     *arena,
+                                                     UcaPcowinArenaStats *stats);
+gint                uca_pcowin_arena_get_thread_node
+                                                    (guint64             cpu_mask);
+
+G_END_DECLS
+
+#endif
@@ -0,0 +1,154 @@
+/**
+Copyright (C) 2016  Sai Sasidhar Maddali <sai.sasidhar92@gmail.com>
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+**/
+
+#include <glib/gstdio.h>
+#include <string.h>
+
+#include "uca-pco-win-cache.h"
+
+#define CACHE_MAGIC     "UCAPCODC"
+#define CACHE_VERSION   2
+
+/*
+ * The structure sizes are part of the header so that a cache written against
+ * another SDK version is rejected rather than misread.
+ */
+typedef struct {
+    gchar magic[8];
+    guint32 version;
+    guint32 description_size;
+    guint32 sensor_size;
+    guint32 storage_size;
+    guint32 camera_setup;
+    PCO_CameraType camera_type;
+} CacheHeader;
+
+typedef struct {
+    CacheHeader header;
+    PCO_Description description;
+    PCO_Sensor sensor;
+    PCO_Storage storage;
+} CacheFile;
+
+/*
+ * Firmware updates and the pco.edge shutter mode change the description, so
+ * they get a file of their own
+ */
+static gchar *
+get_cache_filename (const PCO_CameraType *camera_type, guint32 camera_setup)
+{
+    gchar *name;
+    gchar *filename;
+
+    name = g_strdup_printf ("%u-%08x-%08x.bin", (guint) camera_type->dwSerialNumber, (guint) camera_type->dwFWVersion, (guint) camera_setup);
+    filename = g_build_filename (g_get_user_cache_dir (), "uca-pco-win", name, NULL);
+    g_free (name);
+
+    return filename;
+}
+
+static gboolean
+same_camera (const PCO_CameraType *a, const PCO_CameraType *b)
+{
+    return a->wCamType == b->wCamType &&
+           a->wCamSubType == b->wCamSubType &&
+           a->dwSerialNumber == b->dwSerialNumber &&
+           a->dwHWVersion == b->dwHWVersion &&
+           a->dwFWVersion == b->dwFWVersion;
+}
+
+/*
+ * Fills in the static parts of @description, @sensor and @storage from the
+ * cache, i.e. the descriptions and the camRAM size but none of the current
+ * settings. Returns FALSE if there is no valid cache for @camera_type.
+ */
+gboolean
+uca_pcowin_description_cache_load (const PCO_CameraType *camera_type, guint32 camera_setup, PCO_Description *description, PCO_Sensor *sensor, PCO_Storage *storage)
+{
+    gchar *filename;
+    gchar *contents = NULL;
+    gsize length = 0;
+    CacheFile *cache;
+    gboolean valid;
+
+    filename = get_cache_filename (camera_type, camera_setup);
+
+    if (!g_file_get_contents (filename, &contents, &length, NULL)) {
+        g_free (filename);
+        return FALSE;
+    }
+
+    cache = (CacheFile *) contents;
+    valid = length == sizeof (CacheFile) &&
+            memcmp (cache->header.magic, CACHE_MAGIC, sizeof (cache->header.magic)) == 0 &&
+            cache->header.version == CACHE_VERSION &&
+            cache->header.description_size == sizeof (PCO_Description) &&
+            cache->header.sensor_size == sizeof (PCO_Sensor) &&
+            cache->header.storage_size == sizeof (PCO_Storage) &&
+            cache->header.camera_setup == camera_setup &&
+            same_camera (&cache->header.camera_type, camera_type);
+
+    if (valid) {
+        *description = cache->description;
+        sensor->strDescription = cache->sensor.strDescription;
+        sensor->strDescription2 = cache->sensor.strDescription2;
+        storage->dwRamSize = cache->storage.dwRamSize;
+        storage->wPageSize = cache->storage.wPageSize;
+    }
+    else
+        g_debug ("Ignoring stale description cache `%s'", filename);
+
+    g_free (contents);
+    g_free (filename);
+
+    return valid;
+}
+
+gboolean
+uca_pcowin_description_cache_save (const PCO_CameraType *camera_type, guint32 camera_setup, const PCO_Description *description, const PCO_Sensor *sensor, const PCO_Storage *storage, GError **error)
+{
+    CacheFile cache;
+    gchar *filename;
+    gchar *directory;
+    gboolean success;
+
+    memset (&cache, 0, sizeof (cache));
+    memcpy (cache.header.magic, CACHE_MAGIC, sizeof (cache.header.magic));
+    cache.header.version = CACHE_VERSION;
+    cache.header.description_size = sizeof (PCO_Description);
+    cache.header.sensor_size = sizeof (PCO_Sensor);
+    cache.header.storage_size = sizeof (PCO_Storage);
+    cache.header.camera_setup = camera_setup;
+    cache.header.camera_type = *camera_type;
+    cache.description = *description;
+    cache.sensor = *sensor;
+    cache.storage = *storage;
+
+    filename = get_cache_filename (camera_type, camera_setup);
+    directory = g_path_get_dirname (filename);
+    g_mkdir_with_parents (directory, 0755);
+
+    // Written to a temporary file and renamed, so concurrent readers never see half a cache
+    success = g_file_set_contents (filename, (const gchar *) &cache, sizeof (cache), error);
+
+    g_free (directory);
+    g_free (filename);
+
+    return success;
+}
@@ -0,0 +1,45 @@
+/*
+Copyright (C) 2016  Sai Sasidhar Maddali <sai.sasidhar92@gmail.com>
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+
+#ifndef __UCA_PCOWIN_CACHE_H
+#define __UCA_PCOWIN_CACHE_H
+
+#include <glib.h>
+#include <minwindef.h>
+#include <sc2_SDKStructures.h>
+
+G_BEGIN_DECLS
+
+gboolean            uca_pcowin_description_cache_load
+                                                    (const PCO_CameraType *camera_type,
+                                                     guint32             camera_setup,
+                                                     PCO_Description    *description,
+                                                     PCO_Sensor         *sensor,
+                                                     PCO_Storage        *storage);
+gboolean            uca_pcowin_description_cache_save
+                                                    (const PCO_CameraType *camera_type,
+                                                     guint32             camera_setup,
+                                                     const PCO_Description *description,
+                                                     const PCO_Sensor   *sensor,
+                                                     const PCO_Storage  *storage,
+                                                     GError            **error);
+
+G_END_DECLS
+
+#endif
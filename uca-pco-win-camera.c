@@ -38,6 +38,19 @@ Notes:
 
 #include "uca-pco-win-camera.h"
 #include "uca-pco-enums.h"
+#include "uca-pco-win-preview.h"
+#include "uca-pco-win-shm.h"
+#include "uca-pco-win-recorder.h"
+#include "uca-pco-win-dump.h"
+#include "uca-pco-win-compress.h"
+#include "uca-pco-win-trigger.h"
+#include "uca-pco-win-health.h"
+#include "uca-pco-win-scheduler.h"
+#include "uca-pco-win-arena.h"
+#include "uca-pco-win-cache.h"
+#include "uca-pco-win-transfer.h"
+#include "uca-pco-win-decode.h"
+#include "uca-pco-win-snapshot.h"
 
 #define TRIGGER_MODE_AUTOTRIGGER        0x0000
 #define TRIGGER_MODE_SOFTWARETRIGGER    0x0001
@@ -48,32 +61,57 @@ Notes:
 
 #define SET_ERROR_AND_RETURN_ON_SDK_ERROR(err)                          \
     if (err != 0) {                                                     \
-        PCO_GetErrorText (err, error_text, ERROR_TEXT_BUFFER_SIZE);     \
+        PCO_GetErrorText (err, priv->error_text, ERROR_TEXT_BUFFER_SIZE);\
         g_set_error (error, UCA_PCOWIN_CAMERA_ERROR,                    \
                      UCA_PCOWIN_CAMERA_ERROR_SDKERROR,                  \
-                     "PCO SDK error code 0x%X: %s", err, error_text);   \
+                     "PCO SDK error code 0x%X: %s", err, priv->error_text); \
         return;                                                         \
     }
 
 #define SET_ERROR_AND_RETURN_VAL_ON_SDK_ERROR(err, val)                 \
     if (err != 0) {                                                     \
-        PCO_GetErrorText (err, error_text, ERROR_TEXT_BUFFER_SIZE);     \
+        PCO_GetErrorText (err, priv->error_text, ERROR_TEXT_BUFFER_SIZE);\
         g_set_error (error, UCA_PCOWIN_CAMERA_ERROR,                    \
                      UCA_PCOWIN_CAMERA_ERROR_SDKERROR,                  \
-                     "PCO SDK error code 0x%X: %s", err, error_text);   \
+                     "PCO SDK error code 0x%X: %s", err, priv->error_text); \
         return val;                                                     \
     }
 
+/*
+ * Every SDK call goes through the camera's scheduler so that buffer handling
+ * is never stuck behind property reads issued from other threads.
+ */
+#define TRANSFER_CALL(call) UCA_PCOWIN_SCHEDULE (priv->scheduler, UCA_PCOWIN_PRIORITY_TRANSFER, call)
+#define CONTROL_CALL(call)  UCA_PCOWIN_SCHEDULE (priv->scheduler, UCA_PCOWIN_PRIORITY_CONTROL, call)
+#define QUERY_CALL(call)    UCA_PCOWIN_SCHEDULE (priv->scheduler, UCA_PCOWIN_PRIORITY_QUERY, call)
+
+#define MAX_CAMERAS                     16
+#define MAX_TIME_TABLE_ENTRIES          16
+#define MAX_RAM_SEGMENTS                4
+#define MAX_STREAM_BUFFERS              14      // The SDK allows 16 buffers, buffer 1 is kept for readout
+#define FIFO_CHECK_INTERVAL_US          200000
+#define FIFO_WARN_FILL_LEVEL            0.8
+#define RECORD_STOP_POLL_US             5000
+#define HEALTH_HISTORY_LENGTH           120
+#define ARENA_CHUNK_SIZE                (64 * 1024 * 1024)
+#define RECONNECT_FIRST_DELAY_MS        1000
+#define RECONNECT_MAX_DELAY_MS          8000
+#define DECODE_BENCHMARK_FRAMES         4
+#define FRAME_RATE_MODE_FRAME_RATE      0x0001
+
 #define CHECK_FOR_PCO_SDK_ERROR_DURING_SETUP(err)   \
     if (err != 0) {                                 \
         return err;                                 \
     }                                               \
 
 static void uca_pcowin_initable_iface_init (GInitableIface *iface);
+static void uca_pcowin_async_initable_iface_init (GAsyncInitableIface *iface);
 
 G_DEFINE_TYPE_WITH_CODE (UcaPcowinCamera, uca_pcowin_camera, UCA_TYPE_CAMERA,
                          G_IMPLEMENT_INTERFACE (G_TYPE_INITABLE,
-                                                uca_pcowin_initable_iface_init))
+                                                uca_pcowin_initable_iface_init)
+                         G_IMPLEMENT_INTERFACE (G_TYPE_ASYNC_INITABLE,
+                                                uca_pcowin_async_initable_iface_init))
 
 
 
@@ -103,6 +141,67 @@ enum {
     PROP_TIMESTAMP_MODE,
     PROP_VERSION,
     PROP_EDGE_GLOBAL_SHUTTER,
+    PROP_PREVIEW_DECIMATION,
+    PROP_PREVIEW_MAX_FPS,
+    PROP_PREVIEW_DOWNSAMPLING,
+    PROP_PREVIEW_EIGHT_BIT,
+    PROP_SHARED_MEMORY_NAME,
+    PROP_SHARED_MEMORY_SLOTS,
+    PROP_RECORD_FILE,
+    PROP_RECORD_BUFFERS,
+    PROP_RECORD_THROUGHPUT,
+    PROP_RECORD_QUEUE_DEPTH,
+    PROP_READOUT_DUMP_FILE,
+    PROP_COMPRESSION,
+    PROP_COMPRESSION_THREADS,
+    PROP_COMPRESSION_RATIO,
+    PROP_COMPRESSION_THROUGHPUT,
+    PROP_COMPRESSION_DROPPED,
+    PROP_CAMERA_INDEX,
+    PROP_SERIAL_NUMBER,
+    PROP_GRAB_TIMEOUT,
+    PROP_CAMRAM_SEGMENT_SIZES,
+    PROP_CAMRAM_ROTATE_SEGMENTS,
+    PROP_READOUT_SEGMENT,
+    PROP_FIFO_BUFFERS,
+    PROP_FIFO_FILL_LEVEL,
+    PROP_RECORD_STOP_EVENT,
+    PROP_EVENT_PRE_FRAMES,
+    PROP_EVENT_POST_FRAMES,
+    PROP_HEALTH_MONITOR,
+    PROP_HEALTH_POLL_INTERVAL,
+    PROP_HEALTH_POLL_INTERVAL_RECORDING,
+    PROP_CAMERA_TEMPERATURE,
+    PROP_POWER_SUPPLY_TEMPERATURE,
+    PROP_HEALTH_WARNINGS,
+    PROP_HEALTH_ERRORS,
+    PROP_HEALTH_STATUS,
+    PROP_ACQUISITION_CPU_MASK,
+    PROP_ACQUISITION_PRIORITY,
+    PROP_LOCK_BUFFERS,
+    PROP_ACQUISITION_CPU_MASK_APPLIED,
+    PROP_ACQUISITION_PRIORITY_APPLIED,
+    PROP_LOCKED_BUFFER_SIZE,
+    PROP_BUFFER_ALLOCATION,
+    PROP_BUFFER_PAGE_SIZE,
+    PROP_BUFFER_PAGES,
+    PROP_BUFFER_NUMA_NODE,
+    PROP_DESCRIPTION_CACHE,
+    PROP_DESCRIPTION_CACHE_HIT,
+    PROP_INIT_TIMINGS,
+    PROP_CAMERA_READY,
+    PROP_RECONNECT_TIMEOUT,
+    PROP_RECONNECT_DOWNTIME,
+    PROP_TRANSFER_SELECTION,
+    PROP_TRANSFER_FORMAT,
+    PROP_TRANSFER_LUT,
+    PROP_TRANSFER_CLOCK,
+    PROP_TRANSFER_REPORT,
+    PROP_TRANSFER_DECODE,
+    PROP_DECODE_TABLE_FILE,
+    PROP_DECODE_SIMD,
+    PROP_DECODE_THROUGHPUT,
+    PROP_DECODE_MAX_FPS,
     N_PROPERTIES
 };
 
@@ -134,19 +233,32 @@ static gint base_overrideables[] = {
 // PCO Camera Structure with all available properties
 static GParamSpec *pco_properties[N_PROPERTIES] = { NULL };
 
+enum {
+    HEALTH_CHANGED,
+    RECONNECTED,
+    LAST_SIGNAL
+};
+
+static guint pco_signals[LAST_SIGNAL] = { 0 };
+
 GQuark uca_pcowin_camera_error_quark()
 {
     return g_quark_from_static_string("uca-pcowin-camera-error-quark");
 }
 
-static char error_text[ERROR_TEXT_BUFFER_SIZE];
-
 struct _UcaPcowinCameraPrivate {
 
     HANDLE pcoHandle;
+    guint camera_index;
+    guint32 serial_number;
+    gchar error_text[ERROR_TEXT_BUFFER_SIZE];
     HANDLE handle_event_0, handle_event_1;
 
-    GError *construct_error;
+    gboolean init_done;
+    GError *init_error;
+
+    // Properties set at construction, applied once the camera is open
+    GPtrArray *deferred_properties;
 
     PCO_CameraType strCamType;
     PCO_Description strDescription;
@@ -161,6 +273,7 @@ struct _UcaPcowinCameraPrivate {
     guint16 x_act, y_act;
     guint16 horizontal_binning, vertical_binning;
     GValueArray *possible_pixelrates;
+    guint32 default_pixelrate;
     guint16 bit_per_pixel;
 
     // Two buffers defined for future enchancement purposes. Currently, only buffer_number_0 is used
@@ -168,9 +281,149 @@ struct _UcaPcowinCameraPrivate {
     guint16 *buffer_pointer_0, *buffer_pointer_1;
     guint32 buffer_size;
     guint16 active_ram_segment;
+
+    // Driver buffers queued in turn while streaming, the first one is buffer 0
+    guint fifo_buffers;
+    guint n_stream_buffers, next_stream_buffer;
+
+    // Buffers before next_stream_buffer whose frame is still written to disk from them
+    guint n_recording_buffers;
+    gint16 stream_numbers[MAX_STREAM_BUFFERS];
+    guint16 *stream_pointers[MAX_STREAM_BUFFERS];
+    HANDLE stream_events[MAX_STREAM_BUFFERS];
+
+    // camRAM fill level in FIFO storage mode, checked at most every FIFO_CHECK_INTERVAL_US
+    gboolean fifo_mode;
+    gdouble fifo_fill_level;
+    gint64 fifo_last_check;
+    gboolean fifo_warned;
+
+    // Segment the last recording went to, read out while the next one records
+    guint16 readout_segment;
+    gboolean rotate_segments;
     guint32 numberof_recorded_images, camram_max_images, current_image;
+    guint32 readout_first_image;
+
+    // Pre/post-trigger window around a record stop event
+    UcaPcoCameraRecordStopEvent record_stop_event;
+    guint32 event_pre_frames, event_post_frames;
+    guint32 event_first_image, event_last_image;
+    gboolean has_event_window;
+
+    UcaPcowinScheduler *scheduler;
+
+    // Background temperature and health status polling
+    UcaPcowinHealth *health;
+    gboolean health_monitor;
+    guint health_poll_interval, health_poll_interval_recording;
+
+    // Tuning of the thread that grabs and of the host frame buffers
+    guint64 acquisition_cpu_mask;
+    UcaPcoCameraThreadPriority acquisition_priority;
+    gboolean lock_buffers;
+    HANDLE tuned_thread;
+    DWORD tuned_thread_id;
+    DWORD_PTR saved_cpu_mask;
+    int saved_thread_priority;
+    guint64 applied_cpu_mask;
+    UcaPcoCameraThreadPriority applied_priority;
+    gpointer locked_buffers[MAX_STREAM_BUFFERS + 1];
+    guint n_locked_buffers;
+    gsize locked_buffer_size;
+    SIZE_T working_set_growth;
+
+    // Host memory behind the SDK image buffers unless the SDK allocates it
+    UcaPcoCameraBufferAllocation buffer_allocation;
+    UcaPcowinArena *arena;
+    gboolean arena_large_pages;
+    gint arena_node;
+    gboolean arena_buffers;
+
+    // Startup: descriptions cached on disk and how long each step took
+    gboolean description_cache;
+    gboolean description_cache_hit;
+    GString *init_timings;
+    gint64 init_step_start;
+    guint32 camera_setup;
+
+    // Reopening the pco.edge after it rebooted into another shutter mode
+    GThread *reconnect_thread;
+    GMutex reconnect_lock;
+    GCond reconnect_cond;
+    gboolean ready;
+    gboolean reconnecting;
+    gboolean reconnect_quit;
+    guint reconnect_timeout;
+    gint64 reconnect_started;
+    gdouble reconnect_downtime;
+    guint32 saved_framerate;
+    guint32 saved_exposure;
+
+    // How the CameraLink transfer parameters are chosen when recording starts
+    UcaPcoCameraTransferSelection transfer_selection;
+
+    // Expansion of LUT compressed transfers on the host
+    UcaPcoCameraTransferDecode transfer_decode;
+    gchar *decode_table_file;
+    UcaPcowinDecoder *decoder;
+    guint decode_code_bits;
+    gboolean decode_active;
+    gdouble decode_max_fps;
 
     UcaCameraTriggerSource trigger_source;
+
+    // Decimated live view fed from the grab path
+    UcaPcowinPreview *preview;
+    guint preview_decimation, preview_downsampling;
+    gdouble preview_max_fps;
+    gboolean preview_eight_bit;
+
+    // Named shared-memory ring that other processes can map
+    gchar *shm_name;
+    guint shm_slots;
+    UcaPcowinShmRing *shm_ring;
+
+    // Direct-to-disk recording of delivered frames
+    gchar *record_file;
+    guint record_buffers;
+    UcaPcowinRecorder *recorder;
+
+    // camRAM segment dumped during start_readout, served instead of the camera
+    gchar *dump_file;
+    UcaPcowinDump *dump;
+
+    // Lossless compression of delivered frames on a thread pool
+    gboolean compression;
+    guint compression_threads;
+    UcaPcowinCompressor *compressor;
+
+    // Asynchronous grabs are served by a thread per camera
+    guint grab_timeout;
+    GThread *grab_thread;
+    GAsyncQueue *grab_queue;
+    HANDLE cancel_event;
+    GMutex grab_lock;
+    GCond grab_cond;
+    gboolean grab_busy;
+
+    // Exposure bracketing, cycled by the camera's time table or per software trigger
+    gdouble *exposure_sequence, *delay_sequence;
+    guint n_exposures;
+    guint exposure_step;
+    gboolean exposure_table;
+
+    // Fixed delay/exposure in effect before a sequence was loaded
+    gboolean fixed_timing_saved;
+    guint32 fixed_delay, fixed_exposure;
+    guint16 fixed_delay_timebase, fixed_exposure_timebase;
+
+    // Software triggers issued from a time-critical thread
+    UcaPcowinTriggerSequence *trigger_sequence;
+
+    // Frame bookkeeping, timestamp settings are cached when recording starts
+    guint64 frame_count;
+    guint16 timestamp_mode;
+    guint timestamp_shift;
 };
 
 static gboolean
@@ -179,305 +432,2587 @@ check_camera_type (int camera_type, int type)
     return camera_type == type;
 }
 
-static void
-uca_pcowin_camera_start_recording(UcaCamera *camera, GError **error)
+static guint
+bcd_to_uint (guint16 pixel, guint shift)
 {
-    UcaPcowinCameraPrivate *priv;
+    guint value = (pixel >> shift) & 0xFF;
+    return (value >> 4) * 10 + (value & 0x0F);
+}
 
-    guint16 binned_width, binned_height;
-    gboolean use_extended_sensor_format;
-    gboolean transfer_async;
-    int library_errors;
+static gboolean
+is_valid_bcd (guint16 pixel, guint shift)
+{
+    guint value = (pixel >> shift) & 0xFF;
+    return (value >> 4) < 10 && (value & 0x0F) < 10;
+}
 
-    g_return_if_fail (UCA_IS_PCOWIN_CAMERA (camera));
+/*
+ * The binary timestamp occupies the first 14 pixels of a frame, each pixel
+ * holding two BCD digits: 4 pixels image counter, then year (2), month, day,
+ * hour, minute, second and microseconds (3).
+ */
+static gboolean
+decode_binary_timestamp (const guint16 *frame, guint shift, guint32 *image_number, gint64 *timestamp)
+{
+    GDateTime *date_time;
+    guint32 number = 0;
 
-    priv = UCA_PCOWIN_CAMERA_GET_PRIVATE (camera);
+    for (guint i = 0; i < 14; i++) {
+        if (!is_valid_bcd (frame[i], shift))
+            return FALSE;
+    }
 
-    g_object_get (camera,
-                  "trigger-source", &priv->trigger_source,
-                  "sensor-extended", &use_extended_sensor_format,
-                  "transfer-asynchronously", &transfer_async,
-                  NULL);
+    for (guint i = 0; i < 4; i++)
+        number = number * 100 + bcd_to_uint (frame[i], shift);
 
-    // All camera's except pco.edge support camram
-    if (!check_camera_type (priv->strCamType.wCamType & 0xFF00, CAMERATYPE_PCO_EDGE))
-        PCO_ClearRamSegment(priv->pcoHandle);
+    if (image_number)
+        *image_number = number;
 
-    if (use_extended_sensor_format) {
-        binned_width = priv->width_ex;
-        binned_height = priv->height_ex;
-    }
-    else {
-        binned_width = priv->width;
-        binned_height = priv->height;
-    }
+    if (timestamp) {
+        date_time = g_date_time_new_utc (bcd_to_uint (frame[4], shift) * 100 + bcd_to_uint (frame[5], shift),
+                                         bcd_to_uint (frame[6], shift), bcd_to_uint (frame[7], shift),
+                                         bcd_to_uint (frame[8], shift), bcd_to_uint (frame[9], shift),
+                                         bcd_to_uint (frame[10], shift));
 
-    // The following peice of code make sures that the ROI defined is not beyond the limits of available area binning
-    binned_width /= priv->horizontal_binning;
-    binned_height /= priv->vertical_binning;
+        if (date_time == NULL)
+            return FALSE;
 
-    if ((priv->roi_x + priv->roi_width > binned_width) || (priv->roi_y + priv->roi_height > binned_height)) {
-        g_set_error (error, UCA_PCOWIN_CAMERA_ERROR, UCA_PCOWIN_CAMERA_ERROR_UNSUPPORTED,
-                     "ROI of size %ix%i @ (%i, %i) is outside of (binned) sensor size %ix%i\n",
-                     priv->roi_width, priv->roi_height, priv->roi_x, priv->roi_y, binned_width, binned_height);
-        return;
+        *timestamp = g_date_time_to_unix (date_time) * G_USEC_PER_SEC +
+                     bcd_to_uint (frame[11], shift) * 10000 + bcd_to_uint (frame[12], shift) * 100 + bcd_to_uint (frame[13], shift);
+        g_date_time_unref (date_time);
     }
 
-    library_errors = PCO_SetBinning (priv->pcoHandle, priv->horizontal_binning, priv->vertical_binning);
-    SET_ERROR_AND_RETURN_ON_SDK_ERROR (library_errors);
+    return TRUE;
+}
 
-    guint16 roi[4] = { priv->roi_x + 1, priv->roi_y + 1, priv->roi_x + priv->roi_width, priv->roi_y + priv->roi_height };
-    library_errors = PCO_SetROI (priv->pcoHandle, roi[0], roi[1], roi[2], roi[3]);
-    SET_ERROR_AND_RETURN_ON_SDK_ERROR (library_errors);
+gpointer
+uca_pcowin_camera_pop_compressed_frame (UcaPcowinCamera *camera, gboolean wait, gsize *size, guint64 *index)
+{
+    UcaPcowinCameraPrivate *priv;
 
-    library_errors = PCO_ArmCamera (priv->pcoHandle);
-    SET_ERROR_AND_RETURN_ON_SDK_ERROR (library_errors);
+    g_return_val_if_fail (UCA_IS_PCOWIN_CAMERA (camera), NULL);
 
-    // Diagnostics
-    guint32 status, warnus, errnus;
-    library_errors = PCO_GetCameraHealthStatus (priv->pcoHandle, &warnus, &errnus, &status);
+    priv = UCA_PCOWIN_CAMERA_GET_PRIVATE (camera);
 
-    // Get actual armed (also locked and loaded, ready to fire the hell out) image sizes from camera. This data is used to allocate buffer
-    guint16 x_act, y_act, x_max, y_max;
-    library_errors = PCO_GetSizes (priv->pcoHandle, &x_act, &y_act, &x_max, &y_max);
-    SET_ERROR_AND_RETURN_ON_SDK_ERROR (library_errors);
-    priv->x_act = x_act;
-    priv->y_act = y_act;
+    if (priv->compressor == NULL)
+        return NULL;
 
-    // Allocation of buffer. Driver allocates a number if buffer number is set to -1
-    priv->buffer_number_0 = -1;
-    priv->buffer_number_1 = -1;
-    priv->buffer_pointer_0 = NULL;
-    priv->buffer_pointer_1 = NULL;
-    priv->handle_event_0 = NULL;
-    priv->handle_event_1 = NULL;
-    priv->buffer_size = x_act * y_act * 2;
+    return uca_pcowin_compressor_pop (priv->compressor, wait, size, index);
+}
 
-    library_errors = PCO_AllocateBuffer (priv->pcoHandle, &priv->buffer_number_0, priv->buffer_size, &priv->buffer_pointer_0, &priv->handle_event_0);
-    SET_ERROR_AND_RETURN_ON_SDK_ERROR (library_errors);
+gboolean
+uca_pcowin_camera_decode_timestamp (UcaPcowinCamera *camera, gconstpointer frame, guint32 *image_number, gint64 *timestamp)
+{
+    UcaPcowinCameraPrivate *priv;
 
-    library_errors = PCO_AllocateBuffer (priv->pcoHandle, &priv->buffer_number_1, priv->buffer_size, &priv->buffer_pointer_1, &priv->handle_event_1);
-    SET_ERROR_AND_RETURN_ON_SDK_ERROR (library_errors);
+    g_return_val_if_fail (UCA_IS_PCOWIN_CAMERA (camera), FALSE);
 
-    library_errors = PCO_CamLinkSetImageParameters (priv->pcoHandle, priv->x_act, priv->y_act);
-    SET_ERROR_AND_RETURN_ON_SDK_ERROR (library_errors);
+    priv = UCA_PCOWIN_CAMERA_GET_PRIVATE (camera);
 
-    /*
-     * Synchronous grab is the only way to read images because pco.edge does not
-     * have internal memory.  Therefore, in order to get the first image that
-     * was recorded by pco.edge PCO_AddBufferEx should
-     * be called before PCO_SetRecordingState(1).
-     *
-     * However, this order of function calls causes an error when ROI is changed
-     * back to a larger region from previously set smaller region in pco.dimax
-     * camera. This error in SDK could be avoided by
-     * reordering these functions as seen in else block(Ref. commit b88dd75).
-     *
-     * This workaround was only tested for pco.edge and pco.dimax
-     */
+    if (priv->timestamp_mode != TIMESTAMP_MODE_BINARY && priv->timestamp_mode != TIMESTAMP_MODE_BINARYANDASCII)
+        return FALSE;
 
-    if (check_camera_type (priv->strCamType.wCamType & 0xFF00, CAMERATYPE_PCO_EDGE)) {
-        /*
-         *  There are quite a few CL transfer settings available for PCO Edge, which can be found here:
-         *  https://www.pco.de/fileadmin/user_upload/db/download/MA_pco.edge_CameraLink_Interface_401_01.pdf : Page 23
-         *
-         *  PCO_SetTransferParametersAuto selects appropriate parameters for
-         *  transfer, compression and LUT automatically based on shutter mode
-         *  (rolling/global)
-         */
-        library_errors = PCO_SetTransferParametersAuto (priv->pcoHandle, NULL, 0);
-        SET_ERROR_AND_RETURN_ON_SDK_ERROR (library_errors);
+    return decode_binary_timestamp (frame, priv->timestamp_shift, image_number, timestamp);
+}
 
-        /*
-         * Camera is armed again because there is a chance that
-         * PCO_SetTransferParametersAuto modified some camera settings.  Not
-         * arming again results in an error when Global Shutter mode is used
-         */
-        library_errors = PCO_ArmCamera (priv->pcoHandle);
-        SET_ERROR_AND_RETURN_ON_SDK_ERROR (library_errors);
+/*
+ * Called for every frame handed out by grab or readout, after the driver buffer
+ * has been copied. @record_frame is the driver buffer if it is written to disk
+ * in place and only re-queued once that finished, %NULL to record a copy.
+ */
+static gboolean
+publish_frame (UcaPcowinCameraPrivate *priv, gconstpointer frame, gconstpointer record_frame, GError **error)
+{
+    priv->frame_count++;
 
-        library_errors = PCO_AddBufferEx (priv->pcoHandle, 0, 0, priv->buffer_number_0, priv->x_act, priv->y_act, priv->bit_per_pixel);
-        SET_ERROR_AND_RETURN_ON_SDK_ERROR (library_errors);
+    uca_pcowin_preview_push (priv->preview, frame, priv->x_act, priv->y_act, priv->bit_per_pixel);
 
-        library_errors = PCO_SetRecordingState (priv->pcoHandle, 0x0001);
-        SET_ERROR_AND_RETURN_ON_SDK_ERROR (library_errors);
-    }
-    else {
-        library_errors = PCO_SetRecordingState (priv->pcoHandle, 0x0001);
-        SET_ERROR_AND_RETURN_ON_SDK_ERROR (library_errors);
+    if (priv->shm_ring != NULL)
+        uca_pcowin_shm_ring_publish (priv->shm_ring, frame, priv->x_act, priv->y_act, 2);
 
-        library_errors = PCO_AddBufferEx(priv->pcoHandle, 0, 0, priv->buffer_number_0, priv->x_act, priv->y_act, priv->bit_per_pixel);
-        SET_ERROR_AND_RETURN_ON_SDK_ERROR (library_errors);
+    if (priv->recorder != NULL) {
+        guint32 image_number;
+        gint64 timestamp;
+        guint64 frame_counter = priv->frame_count;
+
+        // Fall back to our own count and host time if the camera does not stamp frames
+        if ((priv->timestamp_mode == TIMESTAMP_MODE_BINARY || priv->timestamp_mode == TIMESTAMP_MODE_BINARYANDASCII) &&
+            decode_binary_timestamp (frame, priv->timestamp_shift, &image_number, &timestamp))
+            frame_counter = image_number;
+        else
+            timestamp = g_get_real_time ();
+
+        if (record_frame != NULL) {
+            if (!uca_pcowin_recorder_write_in_place (priv->recorder, record_frame, frame_counter, timestamp, error))
+                return FALSE;
+        }
+        else if (!uca_pcowin_recorder_write (priv->recorder, frame, frame_counter, timestamp, error))
+            return FALSE;
     }
+
+    if (priv->compressor != NULL)
+        uca_pcowin_compressor_push (priv->compressor, frame, priv->frame_count);
+
+    return TRUE;
 }
 
+/*
+ * Caches what is needed to interpret frames without control channel calls
+ * from the grab path.
+ */
 static void
-uca_pcowin_camera_stop_recording(UcaCamera *camera, GError **error)
+update_frame_settings (UcaPcowinCameraPrivate *priv)
 {
-    UcaPcowinCameraPrivate *priv;
-    int library_errors;
+    guint16 alignment = BIT_ALIGNMENT_MSB;
 
-    g_return_if_fail (UCA_IS_PCOWIN_CAMERA (camera));
+    priv->frame_count = 0;
 
-    priv = UCA_PCOWIN_CAMERA_GET_PRIVATE (camera);
+    if (QUERY_CALL (PCO_GetTimestampMode (priv->pcoHandle, &priv->timestamp_mode)) != PCO_NOERROR)
+        priv->timestamp_mode = TIMESTAMP_MODE_OFF;
 
-    library_errors = PCO_CancelImages (priv->pcoHandle);
-    SET_ERROR_AND_RETURN_ON_SDK_ERROR (library_errors);
+    QUERY_CALL (PCO_GetBitAlignment (priv->pcoHandle, &alignment));
+    priv->timestamp_shift = alignment == BIT_ALIGNMENT_MSB && priv->bit_per_pixel < 16 ? 16 - priv->bit_per_pixel : 0;
+}
 
-    library_errors = PCO_SetRecordingState (priv->pcoHandle, 0x0000);
-    SET_ERROR_AND_RETURN_ON_SDK_ERROR (library_errors);
+/*
+ * (Re-)creates the shared-memory ring if a name is set. The slots are sized
+ * for the largest possible frame so that ROI changes do not require readers to
+ * re-open the mapping.
+ */
+static gboolean
+prepare_shared_memory (UcaPcowinCameraPrivate *priv, GError **error)
+{
+    gsize max_frame_size;
+
+    if (priv->shm_name == NULL || priv->shm_name[0] == '\0') {
+        g_clear_pointer (&priv->shm_ring, uca_pcowin_shm_ring_free);
+        return TRUE;
+    }
+
+    max_frame_size = (gsize) MAX (priv->width, priv->width_ex) * MAX (priv->height, priv->height_ex) * 2;
+
+    if (priv->shm_ring != NULL &&
+        g_strcmp0 (uca_pcowin_shm_ring_get_name (priv->shm_ring), priv->shm_name) == 0 &&
+        uca_pcowin_shm_ring_get_max_frame_size (priv->shm_ring) >= max_frame_size)
+        return TRUE;
+
+    g_clear_pointer (&priv->shm_ring, uca_pcowin_shm_ring_free);
+    priv->shm_ring = uca_pcowin_shm_ring_new (priv->shm_name, priv->shm_slots, max_frame_size, error);
+
+    return priv->shm_ring != NULL;
 }
 
-static void
-uca_pcowin_camera_start_readout(UcaCamera *camera, GError **error)
+/*
+ * Replaces the compressor for the current frame size. The previous one is
+ * dropped together with frames that have not been collected yet.
+ */
+static gboolean
+prepare_compressor (UcaPcowinCameraPrivate *priv, GError **error)
 {
-    UcaPcowinCameraPrivate *priv;
-    g_return_if_fail (UCA_IS_PCOWIN_CAMERA (camera));
-    priv = UCA_PCOWIN_CAMERA_GET_PRIVATE (camera);
+    guint n_threads;
 
-    PCO_GetNumberOfImagesInSegment (priv->pcoHandle, priv->active_ram_segment, &priv->numberof_recorded_images, &priv->camram_max_images);
-    priv->current_image = 1;
+    g_clear_pointer (&priv->compressor, uca_pcowin_compressor_free);
+
+    if (!priv->compression)
+        return TRUE;
+
+    n_threads = priv->compression_threads > 0 ? priv->compression_threads : g_get_num_processors ();
+    priv->compressor = uca_pcowin_compressor_new ((gsize) priv->x_act * priv->y_act * 2, n_threads, 4 * n_threads, error);
+
+    return priv->compressor != NULL;
 }
 
-static void
-uca_pcowin_camera_stop_readout(UcaCamera *camera, GError **error)
+/*
+ * Converts @seconds to the finest time base whose 32 bit counter can hold it.
+ */
+static guint16
+pco_timebase_for (gdouble seconds)
 {
+    if (seconds * 1e9 <= G_MAXUINT32)
+        return TIMEBASE_NS;
+
+    if (seconds * 1e6 <= G_MAXUINT32)
+        return TIMEBASE_US;
+
+    return TIMEBASE_MS;
 }
 
-static void
-uca_pcowin_camera_trigger (UcaCamera *camera, GError **error)
+static guint32
+seconds_to_pco_time (gdouble seconds, guint16 timebase)
 {
-    int library_errors;
-    UcaPcowinCameraPrivate *priv;
-    guint16 trigger_state;
-    guint16 is_camera_busy;
+    gdouble scale = timebase == TIMEBASE_NS ? 1e9 : (timebase == TIMEBASE_US ? 1e6 : 1e3);
 
-    g_return_if_fail (UCA_IS_PCOWIN_CAMERA (camera));
+    return (guint32) MIN (seconds * scale + 0.5, (gdouble) G_MAXUINT32);
+}
 
-    priv = UCA_PCOWIN_CAMERA_GET_PRIVATE (camera);
+static gboolean
+set_exposure_step (UcaPcowinCameraPrivate *priv, guint step, GError **error)
+{
+    guint16 delay_timebase, exposure_timebase;
+    int library_errors;
 
-    /*
-     * If a trigger fails it will not trigger future exposures. Therefore
-     * calling forcetrigger is prevented if camera is busy
-     */
-    library_errors = PCO_GetCameraBusyStatus (priv->pcoHandle, &is_camera_busy);
-    SET_ERROR_AND_RETURN_ON_SDK_ERROR (library_errors);
+    delay_timebase = pco_timebase_for (priv->delay_sequence[step]);
+    exposure_timebase = pco_timebase_for (priv->exposure_sequence[step]);
 
-    if (is_camera_busy) {
-        g_set_error (error, UCA_PCOWIN_CAMERA_ERROR, UCA_PCOWIN_CAMERA_ERROR_GENERAL,
-                     "Software trigger was prevented because camera is busy");
-    }
-    else {
-        library_errors = PCO_ForceTrigger(priv->pcoHandle, &trigger_state);
-        SET_ERROR_AND_RETURN_ON_SDK_ERROR (library_errors);
-    }
+    // A single call instead of the PCO_GetFrameRate/PCO_SetFrameRate pair of "exposure-time"
+    library_errors = CONTROL_CALL (PCO_SetDelayExposureTime (priv->pcoHandle,
+                                                             seconds_to_pco_time (priv->delay_sequence[step], delay_timebase),
+                                                             seconds_to_pco_time (priv->exposure_sequence[step], exposure_timebase),
+                                                             delay_timebase, exposure_timebase));
+    SET_ERROR_AND_RETURN_VAL_ON_SDK_ERROR (library_errors, FALSE);
+
+    priv->exposure_step = step;
+    return TRUE;
 }
 
+/*
+ * Puts back the delay/exposure that was set before the sequence was loaded.
+ * A single delay/exposure also clears the remaining time table entries.
+ */
 static gboolean
-uca_pcowin_camera_grab (UcaCamera *camera, gpointer data, GError **error)
+restore_fixed_timing (UcaPcowinCameraPrivate *priv, GError **error)
 {
     int library_errors;
-    UcaPcowinCameraPrivate *priv;
-    gboolean is_readout;
-    guint32 image_index_to_transfer = 0;
-    int result_event;
 
-    g_return_val_if_fail (UCA_IS_PCOWIN_CAMERA (camera), FALSE);
+    if (!priv->fixed_timing_saved)
+        return TRUE;
 
-    priv = UCA_PCOWIN_CAMERA_GET_PRIVATE (camera);
+    library_errors = CONTROL_CALL (PCO_SetDelayExposureTime (priv->pcoHandle, priv->fixed_delay, priv->fixed_exposure,
+                                                             priv->fixed_delay_timebase, priv->fixed_exposure_timebase));
+    SET_ERROR_AND_RETURN_VAL_ON_SDK_ERROR (library_errors, FALSE);
 
-    /*
-     * This function acts similar to AddBufferEx. i.e to view images while
-     * recording is enabled.  Except event handeling is not required.
-     *
-     * Fn returns only when the image is transferred to memory (5 sec timeout)
-     *
-     * 0,0 transfers most recent image. 1,1 could be used to transfer the first
-     * captured image ?  firstImage and LastImage of the segment can be used to
-     * bulk read images from camRAM. - This is not possible for dimax. Though
-     * mentioned in the SDK, it doesn't work as advertised Note. Make sure
-     * buffersize of appropriate buffernumber is sufficient enough when
-     * transferring multiple images.
-     */
+    priv->fixed_timing_saved = FALSE;
+    return TRUE;
+}
 
-    // "is_readout" is set in uca_camera_start_readout and unset in uca_camera_stop_readout.
-    g_object_get (G_OBJECT (camera), "is-readout", &is_readout, NULL);
+/*
+ * Loads the exposure sequence before the camera is armed. Cameras with a
+ * delay/exposure time table cycle through it on their own, all others are
+ * stepped before every software trigger.
+ */
+static gboolean
+apply_exposure_sequence (UcaPcowinCameraPrivate *priv, GError **error)
+{
+    guint32 delays[MAX_TIME_TABLE_ENTRIES], exposures[MAX_TIME_TABLE_ENTRIES];
+    gdouble max_delay = 0.0, max_exposure = 0.0;
+    guint16 delay_timebase, exposure_timebase;
+    int library_errors;
 
-    if (is_readout) {
-        /*
-         * Error set to convey that the readout index has reached last available
-         * frame on camRAM
-         */
-        if (priv->current_image > priv->numberof_recorded_images) {
-            // Should this is be used ?
-            g_set_error (error, UCA_CAMERA_ERROR, UCA_CAMERA_ERROR_END_OF_STREAM,
-                         "End of camRAM readout");
-            return FALSE;
-        }
+    priv->exposure_step = 0;
+    priv->exposure_table = FALSE;
 
-        image_index_to_transfer = priv->current_image;
-        priv->current_image++;
+    if (priv->n_exposures == 0)
+        return TRUE;
 
-        library_errors = PCO_GetImageEx (priv->pcoHandle, priv->active_ram_segment, image_index_to_transfer, image_index_to_transfer, priv->buffer_number_0, priv->x_act, priv->y_act, priv->bit_per_pixel);
+    if (!priv->fixed_timing_saved) {
+        library_errors = QUERY_CALL (PCO_GetDelayExposureTime (priv->pcoHandle, &priv->fixed_delay, &priv->fixed_exposure,
+                                                               &priv->fixed_delay_timebase, &priv->fixed_exposure_timebase));
         SET_ERROR_AND_RETURN_VAL_ON_SDK_ERROR (library_errors, FALSE);
-        memcpy((gchar *) data, (gchar *) priv->buffer_pointer_0, priv->buffer_size);
+        priv->fixed_timing_saved = TRUE;
     }
-    else {
-        /*
-         * Headsup, this is Windows API.  Implementing grab using
-         * WaitForSingleObject and AddBuffer is much much faster than GetImageEx
-         * Waits for buffer_0 event. Timeout set to 1000 msec
-         */
-        result_event = WaitForSingleObject (priv->handle_event_0, 1000);
 
-        if (result_event == WAIT_OBJECT_0) {
-            memcpy ((gchar *) data, (gchar *) priv->buffer_pointer_0, priv->buffer_size);
-
-            library_errors = PCO_AddBufferEx (priv->pcoHandle, 0, 0, priv->buffer_number_0, priv->x_act, priv->y_act, priv->bit_per_pixel);
-            SET_ERROR_AND_RETURN_VAL_ON_SDK_ERROR (library_errors, FALSE);
+    if (priv->strDescription.wTimeTableDESC && priv->n_exposures <= MAX_TIME_TABLE_ENTRIES) {
+        for (guint i = 0; i < priv->n_exposures; i++) {
+            max_delay = MAX (max_delay, priv->delay_sequence[i]);
+            max_exposure = MAX (max_exposure, priv->exposure_sequence[i]);
         }
-        else {
-            g_warning ("WaitForSingleObject Failed. Return Value = %X",result_event);
+
+        delay_timebase = pco_timebase_for (max_delay);
+        exposure_timebase = pco_timebase_for (max_exposure);
+
+        for (guint i = 0; i < priv->n_exposures; i++) {
+            delays[i] = seconds_to_pco_time (priv->delay_sequence[i], delay_timebase);
+            exposures[i] = seconds_to_pco_time (priv->exposure_sequence[i], exposure_timebase);
         }
+
+        library_errors = CONTROL_CALL (PCO_SetDelayExposureTimeTable (priv->pcoHandle, delays, exposures,
+                                                                      delay_timebase, exposure_timebase, priv->n_exposures));
+        SET_ERROR_AND_RETURN_VAL_ON_SDK_ERROR (library_errors, FALSE);
+
+        priv->exposure_table = TRUE;
+        return TRUE;
     }
 
-    return TRUE;
+    if (priv->trigger_source != UCA_CAMERA_TRIGGER_SOURCE_SOFTWARE) {
+        g_set_error (error, UCA_PCOWIN_CAMERA_ERROR, UCA_PCOWIN_CAMERA_ERROR_UNSUPPORTED,
+                     "Camera has no delay/exposure table for %u entries, exposure sequences require software trigger",
+                     priv->n_exposures);
+        return FALSE;
+    }
+
+    return set_exposure_step (priv, 0, error);
 }
 
-static gboolean
-uca_pcowin_camera_readout (UcaCamera *camera, gpointer data, guint index, GError **error)
+gboolean
+uca_pcowin_camera_set_exposure_sequence (UcaPcowinCamera *camera, const gdouble *exposures, const gdouble *delays,
+                                         guint n_exposures, GError **error)
 {
     UcaPcowinCameraPrivate *priv;
-    int library_errors;
+    gboolean is_recording;
 
     g_return_val_if_fail (UCA_IS_PCOWIN_CAMERA (camera), FALSE);
+    g_return_val_if_fail (n_exposures == 0 || exposures != NULL, FALSE);
 
     priv = UCA_PCOWIN_CAMERA_GET_PRIVATE (camera);
+    g_object_get (G_OBJECT (camera), "is-recording", &is_recording, NULL);
 
-    library_errors = PCO_GetImageEx (priv->pcoHandle, priv->active_ram_segment, index, index, priv->buffer_number_0, priv->x_act, priv->y_act, priv->bit_per_pixel);
-    SET_ERROR_AND_RETURN_VAL_ON_SDK_ERROR (library_errors, FALSE);
+    if (is_recording) {
+        g_set_error (error, UCA_PCOWIN_CAMERA_ERROR, UCA_PCOWIN_CAMERA_ERROR_SETTER,
+                     "Exposure sequence cannot be changed while recording");
+        return FALSE;
+    }
 
-    memcpy ((gchar *) data, (gchar *) priv->buffer_pointer_0, priv->buffer_size);
+    g_free (priv->exposure_sequence);
+    g_free (priv->delay_sequence);
+    priv->exposure_sequence = n_exposures > 0 ? g_memdup (exposures, n_exposures * sizeof (gdouble)) : NULL;
+    priv->delay_sequence = n_exposures > 0 ? g_new0 (gdouble, n_exposures) : NULL;
+    priv->n_exposures = n_exposures;
+
+    if (delays != NULL)
+        memcpy (priv->delay_sequence, delays, n_exposures * sizeof (gdouble));
+
+    // Normally restored when recording stops, unless starting failed after loading the sequence
+    if (n_exposures == 0)
+        return restore_fixed_timing (priv, error);
 
     return TRUE;
 }
 
-static void
-uca_pcowin_camera_set_property (GObject *object, guint property_id, const GValue *value, GParamSpec *pspec)
+gboolean
+uca_pcowin_camera_get_frame_exposure (UcaPcowinCamera *camera, gconstpointer frame, gdouble *exposure, gdouble *delay)
 {
-    UcaPcowinCameraPrivate *priv = UCA_PCOWIN_CAMERA_GET_PRIVATE (object);
-    int library_errors;
+    UcaPcowinCameraPrivate *priv;
+    guint32 image_number;
+    guint step;
 
-    if (uca_camera_is_recording (UCA_CAMERA (object)) && !uca_camera_is_writable_during_acquisition (UCA_CAMERA (object), pspec->name)) {
-        g_warning ("Property '%s' can not be changed during acquisition", pspec->name);
-        return;
-    }
+    g_return_val_if_fail (UCA_IS_PCOWIN_CAMERA (camera), FALSE);
+
+    priv = UCA_PCOWIN_CAMERA_GET_PRIVATE (camera);
+
+    if (priv->n_exposures == 0)
+        return FALSE;
+
+    // The image counter restarts at 1 with every recording
+    if (frame != NULL && uca_pcowin_camera_decode_timestamp (camera, frame, &image_number, NULL) && image_number > 0)
+        step = (image_number - 1) % priv->n_exposures;
+    else if (priv->frame_count > 0)
+        step = (priv->frame_count - 1) % priv->n_exposures;
+    else
+        return FALSE;
+
+    if (exposure)
+        *exposure = priv->exposure_sequence[step];
+
+    if (delay)
+        *delay = priv->delay_sequence[step];
+
+    return TRUE;
+}
+
+/*
+ * Makes the next segment with a non-zero size active, so that the segment of
+ * the previous recording survives and can be read out while recording.
+ */
+static gboolean
+switch_ram_segment (UcaPcowinCameraPrivate *priv, GError **error)
+{
+    guint32 sizes[MAX_RAM_SEGMENTS];
+    int library_errors;
+
+    library_errors = QUERY_CALL (PCO_GetCameraRamSegmentSize (priv->pcoHandle, sizes));
+    SET_ERROR_AND_RETURN_VAL_ON_SDK_ERROR (library_errors, FALSE);
+
+    for (guint i = 1; i < MAX_RAM_SEGMENTS; i++) {
+        guint16 segment = (priv->active_ram_segment - 1 + i) % MAX_RAM_SEGMENTS + 1;
+
+        if (sizes[segment - 1] > 0) {
+            library_errors = CONTROL_CALL (PCO_SetActiveRamSegment (priv->pcoHandle, segment));
+            SET_ERROR_AND_RETURN_VAL_ON_SDK_ERROR (library_errors, FALSE);
+            priv->active_ram_segment = segment;
+            break;
+        }
+    }
+
+    return TRUE;
+}
+
+/*
+ * Transfers image @index of the readout segment into @data. While recording,
+ * buffer 0 belongs to the running acquisition and buffer 1 is used instead.
+ */
+static gint
+transfer_camram_image (UcaPcowinCameraPrivate *priv, guint32 index, gboolean is_recording, gpointer data)
+{
+    gint16 buffer_number = is_recording ? priv->buffer_number_1 : priv->buffer_number_0;
+    gint library_errors;
+
+    library_errors = TRANSFER_CALL (PCO_GetImageEx (priv->pcoHandle, priv->readout_segment, index, index, buffer_number, priv->x_act, priv->y_act, priv->bit_per_pixel));
+
+    if (library_errors == PCO_NOERROR)
+        memcpy ((gchar *) data, is_recording ? priv->buffer_pointer_1 : priv->buffer_pointer_0, priv->buffer_size);
+
+    return library_errors;
+}
+
+/*
+ * Sets up the arena for the image buffers of the next recording. It is bound
+ * to the NUMA node of the acquisition CPUs, or of the calling thread if those
+ * are not pinned, and kept across recordings while that does not change.
+ */
+static void
+prepare_arena (UcaPcowinCameraPrivate *priv)
+{
+    gboolean large_pages;
+    gint node;
+
+    if (priv->buffer_allocation == UCA_PCO_CAMERA_BUFFER_ALLOCATION_SDK) {
+        uca_pcowin_arena_free (priv->arena);
+        priv->arena = NULL;
+        return;
+    }
+
+    large_pages = priv->buffer_allocation == UCA_PCO_CAMERA_BUFFER_ALLOCATION_LARGE_PAGES;
+    node = uca_pcowin_arena_get_thread_node (priv->acquisition_cpu_mask);
+
+    if (priv->arena != NULL && priv->arena_large_pages == large_pages && priv->arena_node == node) {
+        uca_pcowin_arena_reset (priv->arena);
+        return;
+    }
+
+    uca_pcowin_arena_free (priv->arena);
+    priv->arena = uca_pcowin_arena_new (large_pages, node, ARENA_CHUNK_SIZE);
+    priv->arena_large_pages = large_pages;
+    priv->arena_node = node;
+}
+
+// Host memory for an SDK buffer, NULL lets PCO_AllocateBuffer allocate it
+static gboolean
+get_buffer_memory (UcaPcowinCameraPrivate *priv, WORD **pointer, GError **error)
+{
+    *pointer = NULL;
+
+    if (priv->arena == NULL)
+        return TRUE;
+
+    *pointer = uca_pcowin_arena_alloc (priv->arena, priv->buffer_size, error);
+
+    return *pointer != NULL;
+}
+
+/*
+ * Allocates the streaming buffers beyond buffer 0. More than one is only used
+ * in FIFO storage mode, where the camera keeps recording into camRAM and the
+ * host has to drain it continuously.
+ */
+static gboolean
+allocate_stream_buffers (UcaPcowinCameraPrivate *priv, GError **error)
+{
+    guint16 storage_mode = STORAGE_MODE_RECORDER;
+    int library_errors;
+
+    if (!check_camera_type (priv->strCamType.wCamType & 0xFF00, CAMERATYPE_PCO_EDGE))
+        QUERY_CALL (PCO_GetStorageMode (priv->pcoHandle, &storage_mode));
+
+    priv->fifo_mode = storage_mode == STORAGE_MODE_FIFO_BUFFER;
+    priv->fifo_fill_level = 0.0;
+    priv->fifo_last_check = 0;
+    priv->fifo_warned = FALSE;
+    priv->n_stream_buffers = priv->fifo_mode ? priv->fifo_buffers : 1;
+    priv->next_stream_buffer = 0;
+
+    priv->stream_numbers[0] = priv->buffer_number_0;
+    priv->stream_pointers[0] = priv->buffer_pointer_0;
+    priv->stream_events[0] = priv->handle_event_0;
+
+    for (guint i = 1; i < priv->n_stream_buffers; i++) {
+        priv->stream_numbers[i] = -1;
+        priv->stream_events[i] = NULL;
+
+        if (!get_buffer_memory (priv, &priv->stream_pointers[i], error)) {
+            priv->n_stream_buffers = i;
+            return FALSE;
+        }
+
+        library_errors = CONTROL_CALL (PCO_AllocateBuffer (priv->pcoHandle, &priv->stream_numbers[i], priv->buffer_size,
+                                                           &priv->stream_pointers[i], &priv->stream_events[i]));
+
+        if (library_errors)
+            priv->n_stream_buffers = i;
+
+        SET_ERROR_AND_RETURN_VAL_ON_SDK_ERROR (library_errors, FALSE);
+    }
+
+    return TRUE;
+}
+
+static void
+free_stream_buffers (UcaPcowinCameraPrivate *priv)
+{
+    for (guint i = 1; i < priv->n_stream_buffers; i++)
+        CONTROL_CALL (PCO_FreeBuffer (priv->pcoHandle, priv->stream_numbers[i]));
+
+    priv->n_stream_buffers = MIN (priv->n_stream_buffers, 1);
+}
+
+static gboolean
+queue_stream_buffers (UcaPcowinCameraPrivate *priv, GError **error)
+{
+    int library_errors;
+
+    priv->n_recording_buffers = 0;
+
+    for (guint i = 0; i < priv->n_stream_buffers; i++) {
+        library_errors = TRANSFER_CALL (PCO_AddBufferEx (priv->pcoHandle, 0, 0, priv->stream_numbers[i], priv->x_act, priv->y_act, priv->bit_per_pixel));
+        SET_ERROR_AND_RETURN_VAL_ON_SDK_ERROR (library_errors, FALSE);
+    }
+
+    return TRUE;
+}
+
+/*
+ * Hands buffers that were recorded in place back to the driver in the order
+ * they were filled, as soon as their write finished. If the driver has no
+ * buffer left, waiting for the disk is unavoidable.
+ */
+static gboolean
+requeue_recorded_buffers (UcaPcowinCameraPrivate *priv, GError **error)
+{
+    int library_errors;
+
+    while (priv->n_recording_buffers > 0) {
+        guint slot = (priv->next_stream_buffer + priv->n_stream_buffers - priv->n_recording_buffers) % priv->n_stream_buffers;
+        gboolean released;
+
+        if (!uca_pcowin_recorder_release (priv->recorder, priv->stream_pointers[slot],
+                                          priv->n_recording_buffers == priv->n_stream_buffers, &released, error))
+            return FALSE;
+
+        if (!released)
+            break;
+
+        library_errors = TRANSFER_CALL (PCO_AddBufferEx (priv->pcoHandle, 0, 0, priv->stream_numbers[slot], priv->x_act, priv->y_act, priv->bit_per_pixel));
+        SET_ERROR_AND_RETURN_VAL_ON_SDK_ERROR (library_errors, FALSE);
+
+        priv->n_recording_buffers--;
+    }
+
+    return TRUE;
+}
+
+/*
+ * Touches every page of the SDK image buffers and locks them into the working
+ * set, so that neither the driver nor the copy in grab runs into page faults.
+ * Failing to lock is not fatal, the buffers are merely pageable then.
+ */
+static void
+lock_host_buffers (UcaPcowinCameraPrivate *priv)
+{
+    SYSTEM_INFO system_info;
+    SIZE_T min_working_set, max_working_set;
+    gpointer buffers[MAX_STREAM_BUFFERS + 1];
+    guint n_buffers = 0;
+
+    priv->n_locked_buffers = 0;
+    priv->locked_buffer_size = 0;
+
+    if (!priv->lock_buffers)
+        return;
+
+    buffers[n_buffers++] = priv->buffer_pointer_1;
+
+    for (guint i = 0; i < priv->n_stream_buffers; i++)
+        buffers[n_buffers++] = priv->stream_pointers[i];
+
+    GetSystemInfo (&system_info);
+
+    // VirtualLock is limited by the minimum working set size
+    if (GetProcessWorkingSetSize (GetCurrentProcess (), &min_working_set, &max_working_set)) {
+        SIZE_T required = (SIZE_T) n_buffers * (priv->buffer_size + system_info.dwPageSize);
+
+        if (SetProcessWorkingSetSize (GetCurrentProcess (), min_working_set + required, max_working_set + required))
+            priv->working_set_growth = required;
+        else
+            g_warning ("Could not grow working set by %" G_GSIZE_FORMAT " bytes to lock frame buffers", (gsize) required);
+    }
+
+    for (guint i = 0; i < n_buffers; i++) {
+        volatile gchar *page = buffers[i];
+
+        if (page == NULL)
+            continue;
+
+        for (gsize offset = 0; offset < priv->buffer_size; offset += system_info.dwPageSize)
+            page[offset] = 0;
+
+        if (!VirtualLock (buffers[i], priv->buffer_size)) {
+            g_warning ("Could not lock frame buffer %u (error %lu)", i, (gulong) GetLastError ());
+            continue;
+        }
+
+        priv->locked_buffers[priv->n_locked_buffers++] = buffers[i];
+        priv->locked_buffer_size += priv->buffer_size;
+    }
+}
+
+static void
+unlock_host_buffers (UcaPcowinCameraPrivate *priv)
+{
+    SIZE_T min_working_set, max_working_set;
+
+    for (guint i = 0; i < priv->n_locked_buffers; i++)
+        VirtualUnlock (priv->locked_buffers[i], priv->buffer_size);
+
+    /*
+     * Only the growth of this camera is given back, other cameras in the
+     * process may have grown the working set meanwhile as well.
+     */
+    if (priv->working_set_growth > 0 &&
+        GetProcessWorkingSetSize (GetCurrentProcess (), &min_working_set, &max_working_set) &&
+        min_working_set >= priv->working_set_growth && max_working_set >= priv->working_set_growth)
+        SetProcessWorkingSetSize (GetCurrentProcess (), min_working_set - priv->working_set_growth, max_working_set - priv->working_set_growth);
+
+    priv->n_locked_buffers = 0;
+    priv->locked_buffer_size = 0;
+    priv->working_set_growth = 0;
+}
+
+/*
+ * The priority class belongs to the process, so it is raised by the first
+ * camera that asks for realtime priority and put back by the last one.
+ */
+G_LOCK_DEFINE_STATIC (realtime_class);
+static guint realtime_class_users = 0;
+static DWORD saved_priority_class;
+
+static gboolean
+acquire_realtime_class (void)
+{
+    gboolean success = TRUE;
+
+    G_LOCK (realtime_class);
+
+    if (realtime_class_users == 0) {
+        saved_priority_class = GetPriorityClass (GetCurrentProcess ());
+
+        // Without the privilege to raise the base priority Windows silently grants HIGH_PRIORITY_CLASS only
+        if (!SetPriorityClass (GetCurrentProcess (), REALTIME_PRIORITY_CLASS) ||
+            GetPriorityClass (GetCurrentProcess ()) != REALTIME_PRIORITY_CLASS) {
+            SetPriorityClass (GetCurrentProcess (), saved_priority_class);
+            success = FALSE;
+        }
+    }
+
+    if (success)
+        realtime_class_users++;
+
+    G_UNLOCK (realtime_class);
+
+    return success;
+}
+
+static void
+release_realtime_class (void)
+{
+    G_LOCK (realtime_class);
+
+    if (--realtime_class_users == 0)
+        SetPriorityClass (GetCurrentProcess (), saved_priority_class);
+
+    G_UNLOCK (realtime_class);
+}
+
+static void
+restore_acquisition_thread (UcaPcowinCameraPrivate *priv)
+{
+    if (priv->tuned_thread != NULL) {
+        if (priv->applied_cpu_mask != 0)
+            SetThreadAffinityMask (priv->tuned_thread, priv->saved_cpu_mask);
+
+        if (priv->applied_priority == UCA_PCO_CAMERA_THREAD_PRIORITY_REALTIME)
+            release_realtime_class ();
+
+        if (priv->applied_priority != UCA_PCO_CAMERA_THREAD_PRIORITY_UNCHANGED)
+            SetThreadPriority (priv->tuned_thread, priv->saved_thread_priority);
+
+        CloseHandle (priv->tuned_thread);
+    }
+
+    priv->tuned_thread = NULL;
+    priv->tuned_thread_id = 0;
+    priv->applied_cpu_mask = 0;
+    priv->applied_priority = UCA_PCO_CAMERA_THREAD_PRIORITY_UNCHANGED;
+}
+
+/*
+ * Pins and prioritizes the thread that grabs frames, which is either the
+ * caller of uca_camera_grab() or the grab_async thread. The previous settings
+ * are restored when recording stops or another thread starts grabbing.
+ */
+static void
+tune_acquisition_thread (UcaPcowinCameraPrivate *priv)
+{
+    static const int thread_priorities[] = {
+        THREAD_PRIORITY_NORMAL,
+        THREAD_PRIORITY_ABOVE_NORMAL,
+        THREAD_PRIORITY_HIGHEST,
+        THREAD_PRIORITY_TIME_CRITICAL,
+        THREAD_PRIORITY_TIME_CRITICAL
+    };
+
+    HANDLE thread;
+
+    restore_acquisition_thread (priv);
+    priv->tuned_thread_id = GetCurrentThreadId ();
+
+    if (priv->acquisition_cpu_mask == 0 && priv->acquisition_priority == UCA_PCO_CAMERA_THREAD_PRIORITY_UNCHANGED)
+        return;
+
+    if (!DuplicateHandle (GetCurrentProcess (), GetCurrentThread (), GetCurrentProcess (), &thread, 0, FALSE, DUPLICATE_SAME_ACCESS)) {
+        g_warning ("Could not open acquisition thread (error %lu)", (gulong) GetLastError ());
+        return;
+    }
+
+    priv->tuned_thread = thread;
+
+    if (priv->acquisition_cpu_mask != 0) {
+        priv->saved_cpu_mask = SetThreadAffinityMask (thread, (DWORD_PTR) priv->acquisition_cpu_mask);
+
+        if (priv->saved_cpu_mask != 0)
+            priv->applied_cpu_mask = priv->acquisition_cpu_mask;
+        else
+            g_warning ("Could not pin acquisition thread to CPU mask 0x%" G_GINT64_MODIFIER "x (error %lu)",
+                       priv->acquisition_cpu_mask, (gulong) GetLastError ());
+    }
+
+    if (priv->acquisition_priority == UCA_PCO_CAMERA_THREAD_PRIORITY_UNCHANGED)
+        return;
+
+    priv->saved_thread_priority = GetThreadPriority (thread);
+
+    if (priv->acquisition_priority == UCA_PCO_CAMERA_THREAD_PRIORITY_REALTIME && acquire_realtime_class ())
+        priv->applied_priority = UCA_PCO_CAMERA_THREAD_PRIORITY_REALTIME;
+
+    if (SetThreadPriority (thread, thread_priorities[priv->acquisition_priority])) {
+        if (priv->applied_priority != UCA_PCO_CAMERA_THREAD_PRIORITY_REALTIME)
+            priv->applied_priority = MIN (priv->acquisition_priority, UCA_PCO_CAMERA_THREAD_PRIORITY_TIME_CRITICAL);
+    }
+    else
+        g_warning ("Could not raise acquisition thread priority (error %lu)", (gulong) GetLastError ());
+}
+
+/*
+ * Warns once the camRAM FIFO is about to overflow, i.e. the link does not keep
+ * up with the frame rate. The check costs a control channel round trip and is
+ * therefore rate limited.
+ */
+static void
+check_fifo_fill_level (UcaPcowinCameraPrivate *priv)
+{
+    guint32 valid_images, max_images;
+    gint64 now = g_get_monotonic_time ();
+
+    if (now - priv->fifo_last_check < FIFO_CHECK_INTERVAL_US)
+        return;
+
+    priv->fifo_last_check = now;
+
+    if (QUERY_CALL (PCO_GetNumberOfImagesInSegment (priv->pcoHandle, priv->active_ram_segment, &valid_images, &max_images)) || max_images == 0)
+        return;
+
+    priv->fifo_fill_level = (gdouble) valid_images / max_images;
+
+    if (priv->fifo_fill_level >= FIFO_WARN_FILL_LEVEL) {
+        if (!priv->fifo_warned)
+            g_warning ("camRAM FIFO is %.0f%% full (%u of %u images), frames will be lost on overflow",
+                       priv->fifo_fill_level * 100, valid_images, max_images);
+
+        priv->fifo_warned = TRUE;
+    }
+    else if (priv->fifo_fill_level < FIFO_WARN_FILL_LEVEL / 2) {
+        // Warn again only after the FIFO drained considerably
+        priv->fifo_warned = FALSE;
+    }
+}
+
+/*
+ * Arms the record stop event. The camera then records the post-trigger frames
+ * after the event and stops by itself, keeping the camRAM ring intact.
+ */
+static gboolean
+apply_record_stop_event (UcaPcowinCameraPrivate *priv, GError **error)
+{
+    guint16 mode;
+    int library_errors;
+
+    priv->has_event_window = FALSE;
+
+    if (!(priv->strDescription.dwGeneralCapsDESC1 & GENERALCAPS1_RECORD_STOP)) {
+        if (priv->record_stop_event == UCA_PCO_CAMERA_RECORD_STOP_EVENT_NONE)
+            return TRUE;
+
+        g_set_error (error, UCA_PCOWIN_CAMERA_ERROR, UCA_PCOWIN_CAMERA_ERROR_UNSUPPORTED,
+                     "Camera does not support record stop events");
+        return FALSE;
+    }
+
+    switch (priv->record_stop_event) {
+        case UCA_PCO_CAMERA_RECORD_STOP_EVENT_SOFTWARE:
+            mode = 0x0001;
+            break;
+        case UCA_PCO_CAMERA_RECORD_STOP_EVENT_EXTERNAL:
+            mode = 0x0002;
+            break;
+        default:
+            mode = 0x0000;
+    }
+
+    library_errors = CONTROL_CALL (PCO_SetRecordStopEvent (priv->pcoHandle, mode, priv->event_post_frames));
+    SET_ERROR_AND_RETURN_VAL_ON_SDK_ERROR (library_errors, FALSE);
+
+    return TRUE;
+}
+
+gboolean
+uca_pcowin_camera_trigger_event (UcaPcowinCamera *camera, GError **error)
+{
+    UcaPcowinCameraPrivate *priv;
+    guint16 reserved0 = 0;
+    guint32 reserved1 = 0;
+    int library_errors;
+
+    g_return_val_if_fail (UCA_IS_PCOWIN_CAMERA (camera), FALSE);
+
+    priv = UCA_PCOWIN_CAMERA_GET_PRIVATE (camera);
+
+    if (priv->record_stop_event != UCA_PCO_CAMERA_RECORD_STOP_EVENT_SOFTWARE) {
+        g_set_error (error, UCA_PCOWIN_CAMERA_ERROR, UCA_PCOWIN_CAMERA_ERROR_UNSUPPORTED,
+                     "\"record-stop-event\" is not set to software");
+        return FALSE;
+    }
+
+    library_errors = CONTROL_CALL (PCO_StopRecord (priv->pcoHandle, &reserved0, &reserved1));
+    SET_ERROR_AND_RETURN_VAL_ON_SDK_ERROR (library_errors, FALSE);
+
+    return TRUE;
+}
+
+gboolean
+uca_pcowin_camera_wait_event (UcaPcowinCamera *camera, guint timeout_ms, guint32 *first_image, guint32 *last_image, GError **error)
+{
+    UcaPcowinCameraPrivate *priv;
+    gint64 end_time;
+    guint16 recording_state;
+    guint32 valid_images, max_images, window;
+    int library_errors;
+
+    g_return_val_if_fail (UCA_IS_PCOWIN_CAMERA (camera), FALSE);
+
+    priv = UCA_PCOWIN_CAMERA_GET_PRIVATE (camera);
+    end_time = g_get_monotonic_time () + (gint64) timeout_ms * 1000;
+
+    for (;;) {
+        library_errors = QUERY_CALL (PCO_GetRecordingState (priv->pcoHandle, &recording_state));
+        SET_ERROR_AND_RETURN_VAL_ON_SDK_ERROR (library_errors, FALSE);
+
+        if (recording_state == 0)
+            break;
+
+        if (g_get_monotonic_time () >= end_time) {
+            g_set_error (error, UCA_PCOWIN_CAMERA_ERROR, UCA_PCOWIN_CAMERA_ERROR_TIMEOUT,
+                         "Camera did not stop within %u ms", timeout_ms);
+            return FALSE;
+        }
+
+        g_usleep (RECORD_STOP_POLL_US);
+    }
+
+    library_errors = QUERY_CALL (PCO_GetNumberOfImagesInSegment (priv->pcoHandle, priv->active_ram_segment, &valid_images, &max_images));
+    SET_ERROR_AND_RETURN_VAL_ON_SDK_ERROR (library_errors, FALSE);
+
+    // The camera stopped event-post-frames images after the event, the newest image is the last one
+    window = MIN (priv->event_pre_frames + priv->event_post_frames, valid_images);
+    priv->event_last_image = valid_images;
+    priv->event_first_image = valid_images - window + 1;
+    priv->has_event_window = window > 0;
+
+    if (first_image)
+        *first_image = priv->event_first_image;
+
+    if (last_image)
+        *last_image = priv->event_last_image;
+
+    return TRUE;
+}
+
+gboolean
+uca_pcowin_camera_wait_ready (UcaPcowinCamera *camera, guint timeout_ms, GError **error)
+{
+    UcaPcowinCameraPrivate *priv;
+    gint64 end_time;
+    gboolean ready;
+    gboolean reconnecting;
+
+    g_return_val_if_fail (UCA_IS_PCOWIN_CAMERA (camera), FALSE);
+
+    priv = UCA_PCOWIN_CAMERA_GET_PRIVATE (camera);
+    end_time = g_get_monotonic_time () + (gint64) timeout_ms * G_TIME_SPAN_MILLISECOND;
+
+    g_mutex_lock (&priv->reconnect_lock);
+
+    while (!priv->ready && priv->reconnecting && g_cond_wait_until (&priv->reconnect_cond, &priv->reconnect_lock, end_time))
+        ;
+
+    ready = priv->ready;
+    reconnecting = priv->reconnecting;
+    g_mutex_unlock (&priv->reconnect_lock);
+
+    if (ready)
+        return TRUE;
+
+    if (reconnecting)
+        g_set_error (error, UCA_PCOWIN_CAMERA_ERROR, UCA_PCOWIN_CAMERA_ERROR_TIMEOUT,
+                     "Camera did not come back within %u ms", timeout_ms);
+    else
+        g_set_error_literal (error, UCA_PCOWIN_CAMERA_ERROR, UCA_PCOWIN_CAMERA_ERROR_NOT_READY,
+                             "Camera is not open");
+
+    return FALSE;
+}
+
+static void
+emit_health_changed (const UcaPcowinHealthSample *sample, gpointer user_data)
+{
+    g_signal_emit (user_data, pco_signals[HEALTH_CHANGED], 0, sample->warnings, sample->errors, sample->status);
+}
+
+// Latest sample of the running monitor, FALSE if the camera must be asked directly
+static gboolean
+get_health_sample (UcaPcowinCameraPrivate *priv, UcaPcowinHealthSample *sample)
+{
+    return priv->health != NULL &&
+           uca_pcowin_health_is_running (priv->health) &&
+           uca_pcowin_health_get_latest (priv->health, sample);
+}
+
+void
+uca_pcowin_camera_get_command_stats (UcaPcowinCamera *camera, UcaPcowinPriority priority, UcaPcowinSchedulerStats *stats)
+{
+    UcaPcowinCameraPrivate *priv;
+
+    g_return_if_fail (UCA_IS_PCOWIN_CAMERA (camera));
+    g_return_if_fail (priority < UCA_PCOWIN_N_PRIORITIES);
+
+    priv = UCA_PCOWIN_CAMERA_GET_PRIVATE (camera);
+    uca_pcowin_scheduler_get_stats (priv->scheduler, priority, stats);
+}
+
+UcaPcowinHealthSample *
+uca_pcowin_camera_get_health_history (UcaPcowinCamera *camera, guint *n_samples)
+{
+    UcaPcowinCameraPrivate *priv;
+
+    g_return_val_if_fail (UCA_IS_PCOWIN_CAMERA (camera), NULL);
+
+    priv = UCA_PCOWIN_CAMERA_GET_PRIVATE (camera);
+
+    if (priv->health == NULL) {
+        *n_samples = 0;
+        return NULL;
+    }
+
+    return uca_pcowin_health_get_history (priv->health, n_samples);
+}
+
+static void
+configure_preview (UcaPcowinCameraPrivate *priv)
+{
+    uca_pcowin_preview_configure (priv->preview, priv->preview_decimation, priv->preview_max_fps,
+                                  priv->preview_downsampling, priv->preview_eight_bit);
+}
+
+// PCO data formats in the order of UcaPcoCameraTransferFormat
+static const guint32 transfer_formats[] = {
+    PCO_CL_DATAFORMAT_1x16,
+    PCO_CL_DATAFORMAT_2x12,
+    PCO_CL_DATAFORMAT_3x8,
+    PCO_CL_DATAFORMAT_4x16,
+    PCO_CL_DATAFORMAT_5x16,
+    PCO_CL_DATAFORMAT_5x12,
+    PCO_CL_DATAFORMAT_10x8,
+    PCO_CL_DATAFORMAT_5x12L,
+    PCO_CL_DATAFORMAT_5x12R,
+};
+
+static gint
+get_transfer_parameters (UcaPcowinCameraPrivate *priv, PCO_SC2_CL_TRANSFER_PARAM *params, guint16 *lut)
+{
+    guint16 lut_parameter;
+    gint error;
+
+    *lut = 0;
+    error = QUERY_CALL (PCO_GetTransferParameter (priv->pcoHandle, params, sizeof (*params)));
+
+    // Only the pco.edge has lookup tables
+    if (error == PCO_NOERROR && check_camera_type (priv->strCamType.wCamType & 0xFF00, CAMERATYPE_PCO_EDGE))
+        error = QUERY_CALL (PCO_GetActiveLookupTable (priv->pcoHandle, lut, &lut_parameter));
+
+    return error;
+}
+
+/*
+ * Changes the data format and LUT, and the clock unless @clock_frequency is
+ * 0. The sCMOS readout order in the data format is kept. The camera must be
+ * armed afterwards.
+ */
+static gint
+set_transfer_parameters (UcaPcowinCameraPrivate *priv, guint32 data_format, guint16 lut, guint32 clock_frequency)
+{
+    PCO_SC2_CL_TRANSFER_PARAM params;
+    guint16 current_lut;
+    guint16 lut_parameter = 0;
+    gint error;
+
+    error = get_transfer_parameters (priv, &params, &current_lut);
+
+    if (error != PCO_NOERROR)
+        return error;
+
+    params.DataFormat = (params.DataFormat & ~PCO_CL_DATAFORMAT_MASK) | data_format;
+
+    if (clock_frequency != 0)
+        params.ClockFrequency = clock_frequency;
+
+    error = CONTROL_CALL (PCO_SetTransferParameter (priv->pcoHandle, &params, sizeof (params)));
+
+    if (error == PCO_NOERROR && lut != current_lut)
+        error = CONTROL_CALL (PCO_SetActiveLookupTable (priv->pcoHandle, &lut, &lut_parameter));
+
+    return error;
+}
+
+static guint
+get_transfer_modes (UcaPcowinCameraPrivate *priv, UcaPcowinTransferMode *modes)
+{
+    UcaPcowinTransferLut luts[UCA_PCOWIN_TRANSFER_MAX_MODES];
+    guint n_luts = 0;
+
+    if (check_camera_type (priv->strCamType.wCamType & 0xFF00, CAMERATYPE_PCO_EDGE)) {
+        gchar description[20];
+        guint16 n_available = 0, identifier, format;
+        BYTE input_width, output_width;
+
+        // LUT 0 only reports how many there are, the tables are numbered from 1
+        QUERY_CALL (PCO_GetLookupTableInfo (priv->pcoHandle, 0, &n_available, description, sizeof (description),
+                                            &identifier, &input_width, &output_width, &format));
+
+        for (guint16 i = 1; i <= n_available && n_luts < G_N_ELEMENTS (luts); i++) {
+            if (QUERY_CALL (PCO_GetLookupTableInfo (priv->pcoHandle, i, &n_available, description, sizeof (description),
+                                                    &identifier, &input_width, &output_width, &format)) != PCO_NOERROR)
+                break;
+
+            luts[n_luts].identifier = identifier;
+            luts[n_luts].input_bits = input_width;
+            luts[n_luts].output_bits = output_width;
+            n_luts++;
+        }
+    }
+
+    return uca_pcowin_transfer_list_modes (priv->strCamType.wCamType, priv->bit_per_pixel, luts, n_luts, modes);
+}
+
+// Frame rate of the sensor for the armed settings, 0 if unknown
+static gdouble
+get_sensor_fps (UcaPcowinCameraPrivate *priv)
+{
+    guint32 seconds, nanoseconds;
+    gdouble cycle_time;
+
+    if (QUERY_CALL (PCO_GetCOCRuntime (priv->pcoHandle, &seconds, &nanoseconds)) != PCO_NOERROR)
+        return 0.0;
+
+    cycle_time = seconds + nanoseconds * 1e-9;
+
+    return cycle_time > 0.0 ? 1.0 / cycle_time : 0.0;
+}
+
+static gchar *
+get_transfer_report (UcaPcowinCameraPrivate *priv)
+{
+    UcaPcowinTransferMode modes[UCA_PCOWIN_TRANSFER_MAX_MODES];
+    UcaPcowinTransferMode active;
+    PCO_SC2_CL_TRANSFER_PARAM params;
+    gboolean has_active;
+    guint16 lut;
+    guint n_modes;
+
+    if (get_transfer_parameters (priv, &params, &lut) != PCO_NOERROR)
+        return g_strdup ("");
+
+    n_modes = get_transfer_modes (priv, modes);
+    has_active = uca_pcowin_transfer_describe (params.DataFormat, lut, priv->bit_per_pixel, &active);
+
+    return uca_pcowin_transfer_report (modes, n_modes, has_active ? &active : NULL, params.ClockFrequency,
+                                       (guint64) priv->roi_width * priv->roi_height, get_sensor_fps (priv));
+}
+
+/*
+ * Chooses a compressing transfer mode instead of letting the SDK pick one,
+ * preferring the widest codes.
+ */
+static gboolean
+request_compressed_transfer (UcaPcowinCameraPrivate *priv, GError **error)
+{
+    UcaPcowinTransferMode modes[UCA_PCOWIN_TRANSFER_MAX_MODES];
+    PCO_SC2_CL_TRANSFER_PARAM params;
+    guint16 lut;
+    guint n_modes;
+    gint best = -1;
+    int library_errors;
+
+    n_modes = get_transfer_modes (priv, modes);
+
+    for (guint i = 0; i < n_modes; i++) {
+        if (modes[i].lut != 0 && (best < 0 || modes[i].bits > modes[best].bits))
+            best = i;
+    }
+
+    if (best < 0) {
+        g_set_error_literal (error, UCA_PCOWIN_CAMERA_ERROR, UCA_PCOWIN_CAMERA_ERROR_UNSUPPORTED,
+                             "Camera has no compressed transfer mode");
+        return FALSE;
+    }
+
+    library_errors = get_transfer_parameters (priv, &params, &lut);
+    SET_ERROR_AND_RETURN_VAL_ON_SDK_ERROR (library_errors, FALSE);
+
+    if ((params.DataFormat & PCO_CL_DATAFORMAT_MASK) == modes[best].data_format && lut == modes[best].lut)
+        return TRUE;
+
+    library_errors = set_transfer_parameters (priv, modes[best].data_format, modes[best].lut, 0);
+    SET_ERROR_AND_RETURN_VAL_ON_SDK_ERROR (library_errors, FALSE);
+
+    return TRUE;
+}
+
+/*
+ * Sets up host decoding if a compressing LUT is active. The decoder is
+ * benchmarked on frames of the armed size so that a decoder slower than the
+ * sensor is reported before frames pile up in the transfer buffers.
+ */
+static gboolean
+prepare_decoder (UcaPcowinCameraPrivate *priv, GError **error)
+{
+    UcaPcowinTransferMode mode;
+    PCO_SC2_CL_TRANSFER_PARAM params;
+    guint16 lut;
+    gsize n_pixels;
+    gdouble sensor_fps;
+    int library_errors;
+
+    priv->decode_active = FALSE;
+
+    if (priv->transfer_decode != UCA_PCO_CAMERA_TRANSFER_DECODE_HOST)
+        return TRUE;
+
+    library_errors = get_transfer_parameters (priv, &params, &lut);
+    SET_ERROR_AND_RETURN_VAL_ON_SDK_ERROR (library_errors, FALSE);
+
+    if (lut == 0 || !uca_pcowin_transfer_describe (params.DataFormat, lut, priv->bit_per_pixel, &mode))
+        return TRUE;
+
+    if (priv->decoder != NULL && priv->decode_code_bits != mode.bits) {
+        uca_pcowin_decoder_free (priv->decoder);
+        priv->decoder = NULL;
+    }
+
+    if (priv->decoder == NULL) {
+        priv->decoder = uca_pcowin_decoder_new (mode.bits);
+        priv->decode_code_bits = mode.bits;
+
+        if (priv->decode_table_file != NULL && priv->decode_table_file[0] != '\0' &&
+            !uca_pcowin_decoder_load_table (priv->decoder, priv->decode_table_file, error)) {
+            uca_pcowin_decoder_free (priv->decoder);
+            priv->decoder = NULL;
+            return FALSE;
+        }
+    }
+
+    n_pixels = (gsize) priv->x_act * priv->y_act;
+    priv->decode_max_fps = uca_pcowin_decoder_benchmark (priv->decoder, n_pixels, DECODE_BENCHMARK_FRAMES) / n_pixels;
+    sensor_fps = get_sensor_fps (priv);
+
+    if (priv->decode_max_fps < sensor_fps)
+        g_warning ("Host decoding sustains %.1f fps but the camera delivers %.1f fps", priv->decode_max_fps, sensor_fps);
+
+    uca_pcowin_decoder_reset_stats (priv->decoder);
+    priv->decode_active = TRUE;
+
+    return TRUE;
+}
+
+/*
+ * Switches to the transfer mode with the highest achievable frame rate for
+ * the ROI and pixel rate the camera is armed with. Sets @changed if the
+ * camera must be armed again.
+ */
+static gboolean
+tune_transfer_parameters (UcaPcowinCameraPrivate *priv, gboolean *changed, GError **error)
+{
+    UcaPcowinTransferMode modes[UCA_PCOWIN_TRANSFER_MAX_MODES];
+    PCO_SC2_CL_TRANSFER_PARAM params;
+    guint16 lut;
+    guint n_modes;
+    gint best;
+    int library_errors;
+
+    *changed = FALSE;
+    n_modes = get_transfer_modes (priv, modes);
+
+    if (n_modes == 0) {
+        g_warning ("Transfer modes of this camera are unknown, keeping the current one");
+        return TRUE;
+    }
+
+    library_errors = get_transfer_parameters (priv, &params, &lut);
+    SET_ERROR_AND_RETURN_VAL_ON_SDK_ERROR (library_errors, FALSE);
+
+    best = uca_pcowin_transfer_select (modes, n_modes, params.ClockFrequency,
+                                       (guint64) priv->roi_width * priv->roi_height, get_sensor_fps (priv));
+
+    if ((params.DataFormat & PCO_CL_DATAFORMAT_MASK) == modes[best].data_format && lut == modes[best].lut)
+        return TRUE;
+
+    library_errors = set_transfer_parameters (priv, modes[best].data_format, modes[best].lut, 0);
+    SET_ERROR_AND_RETURN_VAL_ON_SDK_ERROR (library_errors, FALSE);
+    *changed = TRUE;
+
+    return TRUE;
+}
+
+gboolean
+uca_pcowin_camera_plan_frame_rate (UcaPcowinCamera *camera, gdouble fps, gdouble exposure, gboolean shrink_roi, UcaPcowinFrameRatePlan *plan, GError **error)
+{
+    UcaPcowinCameraPrivate *priv;
+    UcaPcowinFrameRatePlan plans[UCA_PCOWIN_PLANNER_MAX_PLANS];
+    UcaPcowinSensorLimits limits;
+    guint n_plans;
+    guint16 framerate_status;
+    guint32 framerate, framerate_exposure;
+    gdouble cycle_fps;
+    int library_errors;
+
+    g_return_val_if_fail (UCA_IS_PCOWIN_CAMERA (camera), FALSE);
+    g_return_val_if_fail (fps > 0.0 && plan != NULL, FALSE);
+
+    priv = UCA_PCOWIN_CAMERA_GET_PRIVATE (camera);
+
+    if (uca_camera_is_recording (UCA_CAMERA (camera))) {
+        g_set_error_literal (error, UCA_PCOWIN_CAMERA_ERROR, UCA_PCOWIN_CAMERA_ERROR_UNSUPPORTED,
+                             "Frame rate cannot be planned during acquisition");
+        return FALSE;
+    }
+
+    for (guint i = 0; i < G_N_ELEMENTS (limits.pixelrates); i++)
+        limits.pixelrates[i] = priv->strDescription.dwPixelRateDESC[i];
+
+    limits.max_adcs = priv->strDescription.wNumADCsDESC;
+    limits.roi_vertical_steps = priv->roi_vertical_steps;
+    limits.min_roi_height = priv->strDescription.wMinSizeVertDESC;
+
+    // The pco.edge reads a row pair from the sensor center outwards at once
+    limits.rows_in_parallel = check_camera_type (priv->strCamType.wCamType & 0xFF00, CAMERATYPE_PCO_EDGE) ? 2 : 1;
+
+    n_plans = uca_pcowin_planner_plan (&limits, priv->roi_width, priv->roi_y, priv->roi_height, fps, exposure, shrink_roi, plans);
+
+    if (n_plans == 0) {
+        g_set_error_literal (error, UCA_PCOWIN_CAMERA_ERROR, UCA_PCOWIN_CAMERA_ERROR_UNSUPPORTED,
+                             "Camera description lists no pixel rates");
+        return FALSE;
+    }
+
+    *plan = plans[0];
+
+    library_errors = CONTROL_CALL (PCO_SetPixelRate (priv->pcoHandle, plan->pixelrate));
+    SET_ERROR_AND_RETURN_VAL_ON_SDK_ERROR (library_errors, FALSE);
+
+    if (limits.max_adcs > 1) {
+        library_errors = CONTROL_CALL (PCO_SetADCOperation (priv->pcoHandle, plan->adcs));
+        SET_ERROR_AND_RETURN_VAL_ON_SDK_ERROR (library_errors, FALSE);
+    }
+
+    priv->roi_y = plan->roi_y;
+    priv->roi_height = plan->roi_height;
+
+    library_errors = CONTROL_CALL (PCO_SetBinning (priv->pcoHandle, priv->horizontal_binning, priv->vertical_binning));
+    SET_ERROR_AND_RETURN_VAL_ON_SDK_ERROR (library_errors, FALSE);
+
+    guint16 roi[4] = { priv->roi_x + 1, priv->roi_y + 1, priv->roi_x + priv->roi_width, priv->roi_y + priv->roi_height };
+    library_errors = CONTROL_CALL (PCO_SetROI (priv->pcoHandle, roi[0], roi[1], roi[2], roi[3]));
+    SET_ERROR_AND_RETURN_VAL_ON_SDK_ERROR (library_errors, FALSE);
+
+    framerate = (guint32) (fps * 1000);                 // mHz
+    framerate_exposure = (guint32) (exposure * 1e9);    // ns
+    library_errors = CONTROL_CALL (PCO_SetFrameRate (priv->pcoHandle, &framerate_status, FRAME_RATE_MODE_FRAME_RATE, &framerate, &framerate_exposure));
+    SET_ERROR_AND_RETURN_VAL_ON_SDK_ERROR (library_errors, FALSE);
+
+    library_errors = CONTROL_CALL (PCO_ArmCamera (priv->pcoHandle));
+    SET_ERROR_AND_RETURN_VAL_ON_SDK_ERROR (library_errors, FALSE);
+
+    // Arming may trim further, so the accepted values are read back
+    library_errors = QUERY_CALL (PCO_GetFrameRate (priv->pcoHandle, &framerate_status, &framerate, &framerate_exposure));
+    SET_ERROR_AND_RETURN_VAL_ON_SDK_ERROR (library_errors, FALSE);
+
+    cycle_fps = get_sensor_fps (priv);
+    plan->fps = framerate / 1000.;
+    plan->exposure = framerate_exposure / 1e9;
+
+    if (cycle_fps > 0.0)
+        plan->fps = MIN (plan->fps, cycle_fps);
+
+    plan->status = framerate_status;
+    plan->trimmed = framerate_status != 0 || plan->fps < fps * (1.0 - 1e-3);
+
+    return TRUE;
+}
+
+// Sensor settings follow the description copies embedded in PCO_Sensor
+#define SENSOR_SETTINGS_OFFSET  G_STRUCT_OFFSET (PCO_Sensor, wSensorformat)
+#define SENSOR_SETTINGS_SIZE    (sizeof (PCO_Sensor) - SENSOR_SETTINGS_OFFSET)
+
+enum {
+    SNAPSHOT_SECTION_SENSOR = 1,
+    SNAPSHOT_SECTION_TIMING,
+    SNAPSHOT_SECTION_STORAGE,
+    SNAPSHOT_SECTION_RECORDING,
+};
+
+/*
+ * Status fields are reported by the Get*Struct calls but are not settings.
+ * They are copied from @src, either the current camera state when restoring
+ * or zeros when saving, so that they never count as a difference.
+ */
+static void
+copy_timing_status (PCO_Timing *dst, const PCO_Timing *src)
+{
+    dst->wForceTrigger = src->wForceTrigger;
+    dst->wCameraBusyStatus = src->wCameraBusyStatus;
+    dst->dwCMOSLineTimeMin = src->dwCMOSLineTimeMin;
+    dst->dwCMOSLineTimeMax = src->dwCMOSLineTimeMax;
+}
+
+static void
+copy_storage_status (PCO_Storage *dst, const PCO_Storage *src)
+{
+    dst->dwRamSize = src->dwRamSize;
+    dst->wPageSize = src->wPageSize;
+}
+
+static void
+copy_recording_status (PCO_Recording *dst, const PCO_Recording *src)
+{
+    dst->wRecState = src->wRecState;
+    dst->wAcquEnableStatus = src->wAcquEnableStatus;
+    dst->ucDay = src->ucDay;
+    dst->ucMonth = src->ucMonth;
+    dst->wYear = src->wYear;
+    dst->wHour = src->wHour;
+    dst->ucMin = src->ucMin;
+    dst->ucSec = src->ucSec;
+    dst->wMetaDataSize = src->wMetaDataSize;
+    dst->wMetaDataVersion = src->wMetaDataVersion;
+}
+
+/*
+ * Reads the settings with one bulk call per structure. ROI and binning are
+ * only applied when recording starts, so the pending values replace the ones
+ * the camera reports.
+ */
+static gboolean
+read_configuration (UcaPcowinCameraPrivate *priv, PCO_Sensor *sensor, PCO_Timing *timing,
+                    PCO_Storage *storage, PCO_Recording *recording, GError **error)
+{
+    int library_errors;
+
+    memset (sensor, 0, sizeof (PCO_Sensor));
+    sensor->wSize = sizeof (PCO_Sensor);
+    sensor->strDescription.wSize = sizeof (sensor->strDescription);
+    sensor->strDescription2.wSize = sizeof (sensor->strDescription2);
+    library_errors = QUERY_CALL (PCO_GetSensorStruct (priv->pcoHandle, sensor));
+    SET_ERROR_AND_RETURN_VAL_ON_SDK_ERROR (library_errors, FALSE);
+
+    sensor->wRoiX0 = priv->roi_x + 1;
+    sensor->wRoiY0 = priv->roi_y + 1;
+    sensor->wRoiX1 = priv->roi_x + priv->roi_width;
+    sensor->wRoiY1 = priv->roi_y + priv->roi_height;
+    sensor->wBinHorz = priv->horizontal_binning;
+    sensor->wBinVert = priv->vertical_binning;
+
+    memset (timing, 0, sizeof (PCO_Timing));
+    timing->wSize = sizeof (PCO_Timing);
+    library_errors = QUERY_CALL (PCO_GetTimingStruct (priv->pcoHandle, timing));
+    SET_ERROR_AND_RETURN_VAL_ON_SDK_ERROR (library_errors, FALSE);
+
+    memset (storage, 0, sizeof (PCO_Storage));
+    storage->wSize = sizeof (PCO_Storage);
+    library_errors = QUERY_CALL (PCO_GetStorageStruct (priv->pcoHandle, storage));
+    SET_ERROR_AND_RETURN_VAL_ON_SDK_ERROR (library_errors, FALSE);
+
+    memset (recording, 0, sizeof (PCO_Recording));
+    recording->wSize = sizeof (PCO_Recording);
+    library_errors = QUERY_CALL (PCO_GetRecordingStruct (priv->pcoHandle, recording));
+    SET_ERROR_AND_RETURN_VAL_ON_SDK_ERROR (library_errors, FALSE);
+
+    return TRUE;
+}
+
+GBytes *
+uca_pcowin_camera_save_snapshot (UcaPcowinCamera *camera, GError **error)
+{
+    UcaPcowinCameraPrivate *priv;
+    PCO_Sensor sensor;
+    PCO_Timing timing, no_timing_status = { 0 };
+    PCO_Storage storage, no_storage_status = { 0 };
+    PCO_Recording recording, no_recording_status = { 0 };
+    GByteArray *snapshot;
+
+    g_return_val_if_fail (UCA_IS_PCOWIN_CAMERA (camera), NULL);
+
+    priv = UCA_PCOWIN_CAMERA_GET_PRIVATE (camera);
+
+    if (!priv->ready) {
+        g_set_error_literal (error, UCA_PCOWIN_CAMERA_ERROR, UCA_PCOWIN_CAMERA_ERROR_NOT_READY,
+                             "Camera is reconnecting after a reboot");
+        return NULL;
+    }
+
+    if (!read_configuration (priv, &sensor, &timing, &storage, &recording, error))
+        return NULL;
+
+    copy_timing_status (&timing, &no_timing_status);
+    copy_storage_status (&storage, &no_storage_status);
+    copy_recording_status (&recording, &no_recording_status);
+
+    snapshot = uca_pcowin_snapshot_new (priv->strCamType.wCamType, priv->strCamType.dwSerialNumber);
+    uca_pcowin_snapshot_append (snapshot, SNAPSHOT_SECTION_SENSOR, (guint8 *) &sensor + SENSOR_SETTINGS_OFFSET, SENSOR_SETTINGS_SIZE);
+    uca_pcowin_snapshot_append (snapshot, SNAPSHOT_SECTION_TIMING, &timing, sizeof (timing));
+    uca_pcowin_snapshot_append (snapshot, SNAPSHOT_SECTION_STORAGE, &storage, sizeof (storage));
+    uca_pcowin_snapshot_append (snapshot, SNAPSHOT_SECTION_RECORDING, &recording, sizeof (recording));
+
+    return g_byte_array_free_to_bytes (snapshot);
+}
+
+gboolean
+uca_pcowin_camera_restore_snapshot (UcaPcowinCamera *camera, GBytes *snapshot, guint *n_changed, GError **error)
+{
+    UcaPcowinCameraPrivate *priv;
+    PCO_Sensor sensor;
+    PCO_Timing timing, saved_timing;
+    PCO_Storage storage, saved_storage;
+    PCO_Recording recording, saved_recording;
+    guint8 saved_sensor[SENSOR_SETTINGS_SIZE];
+    guint changed = 0;
+    int library_errors;
+
+    g_return_val_if_fail (UCA_IS_PCOWIN_CAMERA (camera), FALSE);
+    g_return_val_if_fail (snapshot != NULL, FALSE);
+
+    priv = UCA_PCOWIN_CAMERA_GET_PRIVATE (camera);
+
+    if (uca_camera_is_recording (UCA_CAMERA (camera))) {
+        g_set_error_literal (error, UCA_PCOWIN_CAMERA_ERROR, UCA_PCOWIN_CAMERA_ERROR_UNSUPPORTED,
+                             "Snapshot cannot be restored during acquisition");
+        return FALSE;
+    }
+
+    if (!priv->ready) {
+        g_set_error_literal (error, UCA_PCOWIN_CAMERA_ERROR, UCA_PCOWIN_CAMERA_ERROR_NOT_READY,
+                             "Camera is reconnecting after a reboot");
+        return FALSE;
+    }
+
+    // Decode everything first so that a damaged snapshot leaves the camera untouched
+    if (!uca_pcowin_snapshot_check (snapshot, priv->strCamType.wCamType, priv->strCamType.dwSerialNumber, error) ||
+        !uca_pcowin_snapshot_lookup (snapshot, SNAPSHOT_SECTION_SENSOR, saved_sensor, sizeof (saved_sensor), error) ||
+        !uca_pcowin_snapshot_lookup (snapshot, SNAPSHOT_SECTION_TIMING, &saved_timing, sizeof (saved_timing), error) ||
+        !uca_pcowin_snapshot_lookup (snapshot, SNAPSHOT_SECTION_STORAGE, &saved_storage, sizeof (saved_storage), error) ||
+        !uca_pcowin_snapshot_lookup (snapshot, SNAPSHOT_SECTION_RECORDING, &saved_recording, sizeof (saved_recording), error))
+        return FALSE;
+
+    if (!read_configuration (priv, &sensor, &timing, &storage, &recording, error))
+        return FALSE;
+
+    // Structures are written back only where a setting differs
+    if (memcmp ((guint8 *) &sensor + SENSOR_SETTINGS_OFFSET, saved_sensor, SENSOR_SETTINGS_SIZE) != 0) {
+        memcpy ((guint8 *) &sensor + SENSOR_SETTINGS_OFFSET, saved_sensor, SENSOR_SETTINGS_SIZE);
+        library_errors = CONTROL_CALL (PCO_SetSensorStruct (priv->pcoHandle, &sensor));
+        SET_ERROR_AND_RETURN_VAL_ON_SDK_ERROR (library_errors, FALSE);
+
+        priv->roi_x = sensor.wRoiX0 - 1;
+        priv->roi_y = sensor.wRoiY0 - 1;
+        priv->roi_width = sensor.wRoiX1 - sensor.wRoiX0 + 1;
+        priv->roi_height = sensor.wRoiY1 - sensor.wRoiY0 + 1;
+        priv->horizontal_binning = sensor.wBinHorz;
+        priv->vertical_binning = sensor.wBinVert;
+        changed++;
+    }
+
+    copy_timing_status (&saved_timing, &timing);
+
+    if (memcmp (&timing, &saved_timing, sizeof (timing)) != 0) {
+        library_errors = CONTROL_CALL (PCO_SetTimingStruct (priv->pcoHandle, &saved_timing));
+        SET_ERROR_AND_RETURN_VAL_ON_SDK_ERROR (library_errors, FALSE);
+        changed++;
+    }
+
+    // New segment sizes clear camRAM, which is why equal storage is never rewritten
+    copy_storage_status (&saved_storage, &storage);
+
+    if (memcmp (&storage, &saved_storage, sizeof (storage)) != 0) {
+        library_errors = CONTROL_CALL (PCO_SetStorageStruct (priv->pcoHandle, &saved_storage));
+        SET_ERROR_AND_RETURN_VAL_ON_SDK_ERROR (library_errors, FALSE);
+        priv->active_ram_segment = saved_storage.wActSeg;
+        changed++;
+    }
+
+    copy_recording_status (&saved_recording, &recording);
+
+    if (memcmp (&recording, &saved_recording, sizeof (recording)) != 0) {
+        library_errors = CONTROL_CALL (PCO_SetRecordingStruct (priv->pcoHandle, &saved_recording));
+        SET_ERROR_AND_RETURN_VAL_ON_SDK_ERROR (library_errors, FALSE);
+        changed++;
+    }
+
+    if (changed > 0) {
+        library_errors = CONTROL_CALL (PCO_ArmCamera (priv->pcoHandle));
+        SET_ERROR_AND_RETURN_VAL_ON_SDK_ERROR (library_errors, FALSE);
+    }
+
+    if (n_changed != NULL)
+        *n_changed = changed;
+
+    return TRUE;
+}
+
+static void
+uca_pcowin_camera_start_recording(UcaCamera *camera, GError **error)
+{
+    UcaPcowinCameraPrivate *priv;
+
+    guint16 binned_width, binned_height;
+    gboolean use_extended_sensor_format;
+    gboolean transfer_async;
+    int library_errors;
+
+    g_return_if_fail (UCA_IS_PCOWIN_CAMERA (camera));
+
+    priv = UCA_PCOWIN_CAMERA_GET_PRIVATE (camera);
+
+    if (!priv->ready) {
+        g_set_error_literal (error, UCA_PCOWIN_CAMERA_ERROR, UCA_PCOWIN_CAMERA_ERROR_NOT_READY,
+                             "Camera is reconnecting after a reboot");
+        return;
+    }
+
+    g_object_get (camera,
+                  "trigger-source", &priv->trigger_source,
+                  "sensor-extended", &use_extended_sensor_format,
+                  "transfer-asynchronously", &transfer_async,
+                  NULL);
+
+    // All camera's except pco.edge support camram
+    if (!check_camera_type (priv->strCamType.wCamType & 0xFF00, CAMERATYPE_PCO_EDGE)) {
+        if (priv->rotate_segments && !switch_ram_segment (priv, error))
+            return;
+
+        CONTROL_CALL (PCO_ClearRamSegment(priv->pcoHandle));
+    }
+
+    if (use_extended_sensor_format) {
+        binned_width = priv->width_ex;
+        binned_height = priv->height_ex;
+    }
+    else {
+        binned_width = priv->width;
+        binned_height = priv->height;
+    }
+
+    // The following peice of code make sures that the ROI defined is not beyond the limits of available area binning
+    binned_width /= priv->horizontal_binning;
+    binned_height /= priv->vertical_binning;
+
+    if ((priv->roi_x + priv->roi_width > binned_width) || (priv->roi_y + priv->roi_height > binned_height)) {
+        g_set_error (error, UCA_PCOWIN_CAMERA_ERROR, UCA_PCOWIN_CAMERA_ERROR_UNSUPPORTED,
+                     "ROI of size %ix%i @ (%i, %i) is outside of (binned) sensor size %ix%i\n",
+                     priv->roi_width, priv->roi_height, priv->roi_x, priv->roi_y, binned_width, binned_height);
+        return;
+    }
+
+    library_errors = CONTROL_CALL (PCO_SetBinning (priv->pcoHandle, priv->horizontal_binning, priv->vertical_binning));
+    SET_ERROR_AND_RETURN_ON_SDK_ERROR (library_errors);
+
+    guint16 roi[4] = { priv->roi_x + 1, priv->roi_y + 1, priv->roi_x + priv->roi_width, priv->roi_y + priv->roi_height };
+    library_errors = CONTROL_CALL (PCO_SetROI (priv->pcoHandle, roi[0], roi[1], roi[2], roi[3]));
+    SET_ERROR_AND_RETURN_ON_SDK_ERROR (library_errors);
+
+    if (!apply_exposure_sequence (priv, error))
+        return;
+
+    if (!apply_record_stop_event (priv, error))
+        return;
+
+    // Decoding on the host needs the compressed transfer the SDK would otherwise choose on its own
+    if (priv->transfer_selection == UCA_PCO_CAMERA_TRANSFER_SELECTION_DEFAULT &&
+        priv->transfer_decode != UCA_PCO_CAMERA_TRANSFER_DECODE_SDK &&
+        !request_compressed_transfer (priv, error))
+        return;
+
+    library_errors = CONTROL_CALL (PCO_ArmCamera (priv->pcoHandle));
+    SET_ERROR_AND_RETURN_ON_SDK_ERROR (library_errors);
+
+    // The sensor frame rate the transfer mode is chosen for is known only after arming
+    if (priv->transfer_selection == UCA_PCO_CAMERA_TRANSFER_SELECTION_FASTEST) {
+        gboolean transfer_changed;
+
+        if (!tune_transfer_parameters (priv, &transfer_changed, error))
+            return;
+
+        if (transfer_changed) {
+            library_errors = CONTROL_CALL (PCO_ArmCamera (priv->pcoHandle));
+            SET_ERROR_AND_RETURN_ON_SDK_ERROR (library_errors);
+        }
+    }
+
+    // Diagnostics, signalled like the background monitor if anything changed
+    guint32 status, warnus, errnus;
+    library_errors = QUERY_CALL (PCO_GetCameraHealthStatus (priv->pcoHandle, &warnus, &errnus, &status));
+
+    if (library_errors == PCO_NOERROR)
+        uca_pcowin_health_submit_status (priv->health, warnus, errnus, status);
+
+    // Get actual armed (also locked and loaded, ready to fire the hell out) image sizes from camera. This data is used to allocate buffer
+    guint16 x_act, y_act, x_max, y_max;
+    library_errors = QUERY_CALL (PCO_GetSizes (priv->pcoHandle, &x_act, &y_act, &x_max, &y_max));
+    SET_ERROR_AND_RETURN_ON_SDK_ERROR (library_errors);
+    priv->x_act = x_act;
+    priv->y_act = y_act;
+
+    if (!prepare_decoder (priv, error))
+        return;
+
+    uca_pcowin_preview_reset (priv->preview);
+    update_frame_settings (priv);
+
+    if (!prepare_shared_memory (priv, error))
+        return;
+
+    // Arena memory is recycled, so the SDK has to release the previous buffers first
+    if (priv->arena_buffers) {
+        CONTROL_CALL (PCO_FreeBuffer (priv->pcoHandle, priv->buffer_number_0));
+        CONTROL_CALL (PCO_FreeBuffer (priv->pcoHandle, priv->buffer_number_1));
+        priv->arena_buffers = FALSE;
+    }
+
+    // Allocation of buffer. Driver allocates a number if buffer number is set to -1
+    priv->buffer_number_0 = -1;
+    priv->buffer_number_1 = -1;
+    priv->handle_event_0 = NULL;
+    priv->handle_event_1 = NULL;
+    priv->buffer_size = x_act * y_act * 2;
+
+    // The SDK uses the given memory instead of allocating if the pointer is set
+    prepare_arena (priv);
+
+    if (!get_buffer_memory (priv, &priv->buffer_pointer_0, error) ||
+        !get_buffer_memory (priv, &priv->buffer_pointer_1, error))
+        return;
+
+    priv->arena_buffers = priv->arena != NULL;
+
+    library_errors = CONTROL_CALL (PCO_AllocateBuffer (priv->pcoHandle, &priv->buffer_number_0, priv->buffer_size, &priv->buffer_pointer_0, &priv->handle_event_0));
+    SET_ERROR_AND_RETURN_ON_SDK_ERROR (library_errors);
+
+    library_errors = CONTROL_CALL (PCO_AllocateBuffer (priv->pcoHandle, &priv->buffer_number_1, priv->buffer_size, &priv->buffer_pointer_1, &priv->handle_event_1));
+    SET_ERROR_AND_RETURN_ON_SDK_ERROR (library_errors);
+
+    if (!allocate_stream_buffers (priv, error))
+        return;
+
+    lock_host_buffers (priv);
+
+    library_errors = CONTROL_CALL (PCO_CamLinkSetImageParameters (priv->pcoHandle, priv->x_act, priv->y_act));
+    SET_ERROR_AND_RETURN_ON_SDK_ERROR (library_errors);
+
+    if (priv->record_file != NULL && priv->record_file[0] != '\0') {
+        uca_pcowin_recorder_close (priv->recorder, NULL);
+        priv->recorder = uca_pcowin_recorder_new (priv->record_file, priv->buffer_size, priv->record_buffers, error);
+
+        if (priv->recorder == NULL)
+            return;
+    }
+
+    if (!prepare_compressor (priv, error))
+        return;
+
+    /*
+     * Synchronous grab is the only way to read images because pco.edge does not
+     * have internal memory.  Therefore, in order to get the first image that
+     * was recorded by pco.edge PCO_AddBufferEx should
+     * be called before PCO_SetRecordingState(1).
+     *
+     * However, this order of function calls causes an error when ROI is changed
+     * back to a larger region from previously set smaller region in pco.dimax
+     * camera. This error in SDK could be avoided by
+     * reordering these functions as seen in else block(Ref. commit b88dd75).
+     *
+     * This workaround was only tested for pco.edge and pco.dimax
+     */
+
+    if (check_camera_type (priv->strCamType.wCamType & 0xFF00, CAMERATYPE_PCO_EDGE)) {
+        /*
+         *  There are quite a few CL transfer settings available for PCO Edge, which can be found here:
+         *  https://www.pco.de/fileadmin/user_upload/db/download/MA_pco.edge_CameraLink_Interface_401_01.pdf : Page 23
+         *
+         *  PCO_SetTransferParametersAuto selects appropriate parameters for
+         *  transfer, compression and LUT automatically based on shutter mode
+         *  (rolling/global) unless they were chosen explicitly
+         */
+        if (priv->transfer_selection == UCA_PCO_CAMERA_TRANSFER_SELECTION_DEFAULT &&
+            priv->transfer_decode == UCA_PCO_CAMERA_TRANSFER_DECODE_SDK) {
+            library_errors = CONTROL_CALL (PCO_SetTransferParametersAuto (priv->pcoHandle, NULL, 0));
+            SET_ERROR_AND_RETURN_ON_SDK_ERROR (library_errors);
+
+            /*
+             * Camera is armed again because there is a chance that
+             * PCO_SetTransferParametersAuto modified some camera settings.  Not
+             * arming again results in an error when Global Shutter mode is used
+             */
+            library_errors = CONTROL_CALL (PCO_ArmCamera (priv->pcoHandle));
+            SET_ERROR_AND_RETURN_ON_SDK_ERROR (library_errors);
+        }
+
+        if (!queue_stream_buffers (priv, error))
+            return;
+
+        library_errors = CONTROL_CALL (PCO_SetRecordingState (priv->pcoHandle, 0x0001));
+        SET_ERROR_AND_RETURN_ON_SDK_ERROR (library_errors);
+    }
+    else {
+        library_errors = CONTROL_CALL (PCO_SetRecordingState (priv->pcoHandle, 0x0001));
+        SET_ERROR_AND_RETURN_ON_SDK_ERROR (library_errors);
+
+        if (!queue_stream_buffers (priv, error))
+            return;
+    }
+
+    uca_pcowin_health_set_recording (priv->health, TRUE);
+}
+
+/*
+ * Aborts the grab_async request in flight, waits until the grab thread has
+ * returned it and fails the requests still queued, so recording can be torn
+ * down without the grab thread touching the stream buffers.
+ */
+static void
+cancel_async_grabs (UcaPcowinCameraPrivate *priv)
+{
+    GTask *task;
+    GQueue pending = G_QUEUE_INIT;
+
+    if (priv->grab_thread == NULL)
+        return;
+
+    g_async_queue_lock (priv->grab_queue);
+
+    // The quit marker is only queued by finalize, everything queued here is a request
+    while ((task = g_async_queue_try_pop_unlocked (priv->grab_queue)) != NULL)
+        g_queue_push_tail (&pending, task);
+
+    g_mutex_lock (&priv->grab_lock);
+    SetEvent (priv->cancel_event);
+
+    while (priv->grab_busy)
+        g_cond_wait (&priv->grab_cond, &priv->grab_lock);
+
+    g_mutex_unlock (&priv->grab_lock);
+    g_async_queue_unlock (priv->grab_queue);
+
+    while ((task = g_queue_pop_head (&pending)) != NULL) {
+        g_task_return_new_error (task, G_IO_ERROR, G_IO_ERROR_CANCELLED, "Recording was stopped");
+        g_object_unref (task);
+    }
+}
+
+static void
+uca_pcowin_camera_stop_recording(UcaCamera *camera, GError **error)
+{
+    UcaPcowinCameraPrivate *priv;
+    int library_errors;
+
+    g_return_if_fail (UCA_IS_PCOWIN_CAMERA (camera));
+
+    priv = UCA_PCOWIN_CAMERA_GET_PRIVATE (camera);
+
+    // The stream buffers must not be torn down under a grab_async request
+    cancel_async_grabs (priv);
+
+    // Records stay available for uca_pcowin_camera_finish_trigger_sequence
+    if (priv->trigger_sequence != NULL)
+        uca_pcowin_trigger_sequence_finish (priv->trigger_sequence, TRUE, NULL);
+
+    uca_pcowin_health_set_recording (priv->health, FALSE);
+
+    library_errors = TRANSFER_CALL (PCO_CancelImages (priv->pcoHandle));
+    SET_ERROR_AND_RETURN_ON_SDK_ERROR (library_errors);
+
+    // Writes may still read from the stream buffers, so the recorder is closed before they are freed
+    if (priv->recorder != NULL) {
+        g_debug ("Recorded to `%s' at %.1f MB/s", priv->record_file, uca_pcowin_recorder_get_throughput (priv->recorder));
+        uca_pcowin_recorder_close (priv->recorder, error);
+        priv->recorder = NULL;
+    }
+
+    priv->n_recording_buffers = 0;
+
+    restore_acquisition_thread (priv);
+    unlock_host_buffers (priv);
+    free_stream_buffers (priv);
+
+    library_errors = CONTROL_CALL (PCO_SetRecordingState (priv->pcoHandle, 0x0000));
+    SET_ERROR_AND_RETURN_ON_SDK_ERROR (library_errors);
+
+    priv->readout_segment = priv->active_ram_segment;
+
+    restore_fixed_timing (priv, error);
+    priv->exposure_table = FALSE;
+}
+
+/*
+ * Reads the whole active segment into a self-describing dump file once. The
+ * dump is then mapped and grab/readout serve frames from it, so browsing the
+ * segment again (now or later via uca_pcowin_dump_open) costs no transfers.
+ */
+static gboolean
+dump_camram_segment (UcaCamera *camera, UcaPcowinCameraPrivate *priv, GError **error)
+{
+    UcaPcowinDumpHeader header;
+    UcaPcowinDumpWriter *writer;
+    gchar *version = NULL;
+    int library_errors;
+
+    memset (&header, 0, sizeof (header));
+
+    g_object_get (camera,
+                  "version", &version,
+                  "exposure-time", &header.exposure_time,
+                  "frames-per-second", &header.frames_per_second,
+                  "sensor-pixelrate", &header.pixelrate,
+                  NULL);
+
+    if (version != NULL)
+        g_strlcpy (header.camera_version, version, sizeof (header.camera_version));
+
+    g_free (version);
+
+    header.width = priv->x_act;
+    header.height = priv->y_act;
+    header.bit_per_pixel = priv->bit_per_pixel;
+    header.bytes_per_pixel = 2;
+    header.camera_type = priv->strCamType.wCamType;
+    header.ram_segment = priv->readout_segment;
+    header.roi_x = priv->roi_x;
+    header.roi_y = priv->roi_y;
+    header.roi_width = priv->roi_width;
+    header.roi_height = priv->roi_height;
+    header.horizontal_binning = priv->horizontal_binning;
+    header.vertical_binning = priv->vertical_binning;
+    header.timestamp_mode = priv->timestamp_mode;
+    header.created = g_get_real_time ();
+
+    writer = uca_pcowin_dump_writer_new (priv->dump_file, &header, error);
+
+    if (writer == NULL)
+        return FALSE;
+
+    for (guint32 index = priv->readout_first_image; index <= priv->numberof_recorded_images; index++) {
+        guint32 image_number = 0;
+        gint64 timestamp = 0;
+
+        library_errors = TRANSFER_CALL (PCO_GetImageEx (priv->pcoHandle, priv->readout_segment, index, index, priv->buffer_number_0, priv->x_act, priv->y_act, priv->bit_per_pixel));
+
+        if (library_errors != PCO_NOERROR)
+            uca_pcowin_dump_writer_finish (writer, NULL);
+
+        SET_ERROR_AND_RETURN_VAL_ON_SDK_ERROR (library_errors, FALSE);
+
+        if (priv->timestamp_mode == TIMESTAMP_MODE_BINARY || priv->timestamp_mode == TIMESTAMP_MODE_BINARYANDASCII)
+            decode_binary_timestamp (priv->buffer_pointer_0, priv->timestamp_shift, &image_number, &timestamp);
+
+        if (!uca_pcowin_dump_writer_append (writer, priv->buffer_pointer_0, index, image_number, timestamp, error)) {
+            uca_pcowin_dump_writer_finish (writer, NULL);
+            return FALSE;
+        }
+    }
+
+    if (!uca_pcowin_dump_writer_finish (writer, error))
+        return FALSE;
+
+    priv->dump = uca_pcowin_dump_open (priv->dump_file, error);
+
+    if (priv->dump == NULL)
+        return FALSE;
+
+    // Frames are copied with the size of the current buffers
+    if (uca_pcowin_dump_get_frame_size (priv->dump) != priv->buffer_size) {
+        g_set_error (error, UCA_PCOWIN_CAMERA_ERROR, UCA_PCOWIN_CAMERA_ERROR_GENERAL,
+                     "Frames in camRAM dump `%s' do not match the buffer size of %u bytes",
+                     priv->dump_file, priv->buffer_size);
+        g_clear_pointer (&priv->dump, uca_pcowin_dump_close);
+        return FALSE;
+    }
+
+    return TRUE;
+}
+
+static void
+uca_pcowin_camera_start_readout(UcaCamera *camera, GError **error)
+{
+    UcaPcowinCameraPrivate *priv;
+    g_return_if_fail (UCA_IS_PCOWIN_CAMERA (camera));
+    priv = UCA_PCOWIN_CAMERA_GET_PRIVATE (camera);
+
+    if (!priv->ready) {
+        g_set_error_literal (error, UCA_PCOWIN_CAMERA_ERROR, UCA_PCOWIN_CAMERA_ERROR_NOT_READY,
+                             "Camera is reconnecting after a reboot");
+        return;
+    }
+
+    QUERY_CALL (PCO_GetNumberOfImagesInSegment (priv->pcoHandle, priv->readout_segment, &priv->numberof_recorded_images, &priv->camram_max_images));
+    priv->current_image = 1;
+
+    // Only the pre/post-trigger window is transferred after an event
+    if (priv->has_event_window) {
+        priv->current_image = priv->event_first_image;
+        priv->numberof_recorded_images = MIN (priv->numberof_recorded_images, priv->event_last_image);
+    }
+
+    priv->readout_first_image = priv->current_image;
+
+    update_frame_settings (priv);
+
+    if (!prepare_shared_memory (priv, error))
+        return;
+
+    if (!prepare_compressor (priv, error))
+        return;
+
+    uca_pcowin_dump_close (priv->dump);
+    priv->dump = NULL;
+
+    if (priv->dump_file != NULL && priv->dump_file[0] != '\0')
+        dump_camram_segment (camera, priv, error);
+}
+
+static void
+uca_pcowin_camera_stop_readout(UcaCamera *camera, GError **error)
+{
+    UcaPcowinCameraPrivate *priv;
+    g_return_if_fail (UCA_IS_PCOWIN_CAMERA (camera));
+    priv = UCA_PCOWIN_CAMERA_GET_PRIVATE (camera);
+
+    uca_pcowin_dump_close (priv->dump);
+    priv->dump = NULL;
+    restore_acquisition_thread (priv);
+}
+
+gboolean
+uca_pcowin_camera_start_trigger_sequence (UcaPcowinCamera *camera, const gdouble *times, guint n_triggers,
+                                          gdouble interval, GError **error)
+{
+    UcaPcowinCameraPrivate *priv;
+    gboolean is_recording;
+    gint64 *times_us;
+
+    g_return_val_if_fail (UCA_IS_PCOWIN_CAMERA (camera), FALSE);
+    g_return_val_if_fail (n_triggers > 0, FALSE);
+
+    priv = UCA_PCOWIN_CAMERA_GET_PRIVATE (camera);
+    g_object_get (G_OBJECT (camera), "is-recording", &is_recording, NULL);
+
+    if (!is_recording || priv->trigger_source != UCA_CAMERA_TRIGGER_SOURCE_SOFTWARE) {
+        g_set_error (error, UCA_PCOWIN_CAMERA_ERROR, UCA_PCOWIN_CAMERA_ERROR_UNSUPPORTED,
+                     "Trigger sequences require recording with software trigger");
+        return FALSE;
+    }
+
+    if (priv->trigger_sequence != NULL) {
+        g_set_error (error, UCA_PCOWIN_CAMERA_ERROR, UCA_PCOWIN_CAMERA_ERROR_GENERAL,
+                     "A trigger sequence is still active");
+        return FALSE;
+    }
+
+    /*
+     * Without the camera's time table the exposure sequence is stepped by
+     * uca_camera_trigger, which the sequence thread bypasses. Stepping there
+     * would put a CONTROL_CALL between the time-critical triggers.
+     */
+    if (priv->n_exposures > 0 && !priv->exposure_table) {
+        g_set_error (error, UCA_PCOWIN_CAMERA_ERROR, UCA_PCOWIN_CAMERA_ERROR_UNSUPPORTED,
+                     "Trigger sequences require an exposure sequence in the camera's time table");
+        return FALSE;
+    }
+
+    times_us = g_new (gint64, n_triggers);
+
+    for (guint i = 0; i < n_triggers; i++) {
+        times_us[i] = (gint64) ((times != NULL ? times[i] : i * interval) * G_USEC_PER_SEC);
+
+        if (i > 0 && times_us[i] < times_us[i - 1]) {
+            g_set_error (error, UCA_PCOWIN_CAMERA_ERROR, UCA_PCOWIN_CAMERA_ERROR_GENERAL,
+                         "Trigger times must be ascending");
+            g_free (times_us);
+            return FALSE;
+        }
+    }
+
+    priv->trigger_sequence = uca_pcowin_trigger_sequence_start (priv->pcoHandle, priv->scheduler, times_us, n_triggers, error);
+    g_free (times_us);
+
+    return priv->trigger_sequence != NULL;
+}
+
+gboolean
+uca_pcowin_camera_finish_trigger_sequence (UcaPcowinCamera *camera, gboolean cancel,
+                                           UcaPcowinTriggerRecord **records, guint *n_records, GError **error)
+{
+    UcaPcowinCameraPrivate *priv;
+    const UcaPcowinTriggerRecord *sequence_records;
+    gboolean success;
+    guint n_issued;
+
+    g_return_val_if_fail (UCA_IS_PCOWIN_CAMERA (camera), FALSE);
+
+    priv = UCA_PCOWIN_CAMERA_GET_PRIVATE (camera);
+
+    if (priv->trigger_sequence == NULL) {
+        g_set_error (error, UCA_PCOWIN_CAMERA_ERROR, UCA_PCOWIN_CAMERA_ERROR_GENERAL,
+                     "No trigger sequence was started");
+        return FALSE;
+    }
+
+    success = uca_pcowin_trigger_sequence_finish (priv->trigger_sequence, cancel, error);
+    sequence_records = uca_pcowin_trigger_sequence_get_records (priv->trigger_sequence, &n_issued);
+
+    if (records != NULL) {
+        *records = g_new (UcaPcowinTriggerRecord, MAX (n_issued, 1));
+        memcpy (*records, sequence_records, n_issued * sizeof (UcaPcowinTriggerRecord));
+    }
+
+    if (n_records != NULL)
+        *n_records = n_issued;
+
+    g_clear_pointer (&priv->trigger_sequence, uca_pcowin_trigger_sequence_free);
+
+    return success;
+}
+
+static void
+uca_pcowin_camera_trigger (UcaCamera *camera, GError **error)
+{
+    int library_errors;
+    UcaPcowinCameraPrivate *priv;
+    guint16 trigger_state;
+    guint16 is_camera_busy;
+
+    g_return_if_fail (UCA_IS_PCOWIN_CAMERA (camera));
+
+    priv = UCA_PCOWIN_CAMERA_GET_PRIVATE (camera);
+
+    /*
+     * If a trigger fails it will not trigger future exposures. Therefore
+     * calling forcetrigger is prevented if camera is busy
+     */
+    library_errors = TRANSFER_CALL (PCO_GetCameraBusyStatus (priv->pcoHandle, &is_camera_busy));
+    SET_ERROR_AND_RETURN_ON_SDK_ERROR (library_errors);
+
+    if (is_camera_busy) {
+        g_set_error (error, UCA_PCOWIN_CAMERA_ERROR, UCA_PCOWIN_CAMERA_ERROR_GENERAL,
+                     "Software trigger was prevented because camera is busy");
+    }
+    else {
+        library_errors = TRANSFER_CALL (PCO_ForceTrigger(priv->pcoHandle, &trigger_state));
+        SET_ERROR_AND_RETURN_ON_SDK_ERROR (library_errors);
+
+        // Prepare the exposure of the next frame while the camera is exposing this one
+        if (trigger_state && priv->n_exposures > 0 && !priv->exposure_table)
+            set_exposure_step (priv, (priv->exposure_step + 1) % priv->n_exposures, error);
+    }
+}
+
+/*
+ * Delivers the next frame into @data. While streaming, the wait for the frame
+ * is aborted when @cancel_event is signalled.
+ */
+static gboolean
+grab_frame (UcaCamera *camera, gpointer data, HANDLE cancel_event, GError **error)
+{
+    int library_errors;
+    UcaPcowinCameraPrivate *priv;
+    gboolean is_readout;
+    guint32 image_index_to_transfer = 0;
+    int result_event;
+
+    g_return_val_if_fail (UCA_IS_PCOWIN_CAMERA (camera), FALSE);
+
+    priv = UCA_PCOWIN_CAMERA_GET_PRIVATE (camera);
+
+    if (priv->tuned_thread_id != GetCurrentThreadId ())
+        tune_acquisition_thread (priv);
+
+    /*
+     * This function acts similar to AddBufferEx. i.e to view images while
+     * recording is enabled.  Except event handeling is not required.
+     *
+     * Fn returns only when the image is transferred to memory (5 sec timeout)
+     *
+     * 0,0 transfers most recent image. 1,1 could be used to transfer the first
+     * captured image ?  firstImage and LastImage of the segment can be used to
+     * bulk read images from camRAM. - This is not possible for dimax. Though
+     * mentioned in the SDK, it doesn't work as advertised Note. Make sure
+     * buffersize of appropriate buffernumber is sufficient enough when
+     * transferring multiple images.
+     */
+
+    // "is_readout" is set in uca_camera_start_readout and unset in uca_camera_stop_readout.
+    g_object_get (G_OBJECT (camera), "is-readout", &is_readout, NULL);
+
+    if (is_readout) {
+        /*
+         * Error set to convey that the readout index has reached last available
+         * frame on camRAM
+         */
+        if (priv->current_image > priv->numberof_recorded_images) {
+            // Should this is be used ?
+            g_set_error (error, UCA_CAMERA_ERROR, UCA_CAMERA_ERROR_END_OF_STREAM,
+                         "End of camRAM readout");
+            return FALSE;
+        }
+
+        image_index_to_transfer = priv->current_image;
+        priv->current_image++;
+
+        if (priv->dump != NULL) {
+            gconstpointer frame = uca_pcowin_dump_get_frame (priv->dump, image_index_to_transfer - priv->readout_first_image, NULL);
+
+            if (frame == NULL) {
+                g_set_error (error, UCA_CAMERA_ERROR, UCA_CAMERA_ERROR_END_OF_STREAM,
+                             "Image %u is not part of the camRAM dump", image_index_to_transfer);
+                return FALSE;
+            }
+
+            memcpy ((gchar *) data, frame, priv->buffer_size);
+        }
+        else {
+            library_errors = transfer_camram_image (priv, image_index_to_transfer, FALSE, data);
+            SET_ERROR_AND_RETURN_VAL_ON_SDK_ERROR (library_errors, FALSE);
+        }
+
+        if (!publish_frame (priv, data, NULL, error))
+            return FALSE;
+    }
+    else {
+        /*
+         * Headsup, this is Windows API.  Implementing grab using
+         * WaitForSingleObject and AddBuffer is much much faster than GetImageEx
+         * Waits for the event of the next queued buffer for at most
+         * grab-timeout msec. The driver fills buffers in the order they were
+         * queued.
+         */
+        guint slot = priv->next_stream_buffer;
+        gboolean record_in_place;
+
+        if (!requeue_recorded_buffers (priv, error))
+            return FALSE;
+
+        if (cancel_event != NULL) {
+            HANDLE events[2] = { priv->stream_events[slot], cancel_event };
+            result_event = WaitForMultipleObjects (2, events, FALSE, priv->grab_timeout);
+        }
+        else
+            result_event = WaitForSingleObject (priv->stream_events[slot], priv->grab_timeout);
+
+        if (result_event == WAIT_OBJECT_0) {
+            // Decoding replaces the copy out of the transfer buffer rather than adding a pass
+            if (priv->decode_active)
+                uca_pcowin_decoder_expand (priv->decoder, priv->stream_pointers[slot], data, priv->buffer_size / sizeof (guint16));
+            else
+                memcpy ((gchar *) data, (gchar *) priv->stream_pointers[slot], priv->buffer_size);
+
+            /*
+             * With several FIFO buffers the raw frame is written to disk straight
+             * from the driver buffer, which is re-queued once the write finished.
+             * A single buffer could not be re-queued before the disk caught up,
+             * and unbuffered writes need page aligned memory, so the recorder
+             * copies the frame otherwise.
+             */
+            record_in_place = priv->recorder != NULL && !priv->decode_active && priv->n_stream_buffers > 1 &&
+                ((gsize) priv->stream_pointers[slot] & 4095) == 0;
+
+            if (record_in_place)
+                priv->n_recording_buffers++;
+            else {
+                library_errors = TRANSFER_CALL (PCO_AddBufferEx (priv->pcoHandle, 0, 0, priv->stream_numbers[slot], priv->x_act, priv->y_act, priv->bit_per_pixel));
+                SET_ERROR_AND_RETURN_VAL_ON_SDK_ERROR (library_errors, FALSE);
+            }
+
+            priv->next_stream_buffer = (slot + 1) % priv->n_stream_buffers;
+
+            if (priv->fifo_mode)
+                check_fifo_fill_level (priv);
+
+            if (!publish_frame (priv, data, record_in_place ? priv->stream_pointers[slot] : NULL, error))
+                return FALSE;
+        }
+        else if (result_event == WAIT_OBJECT_0 + 1) {
+            g_set_error_literal (error, G_IO_ERROR, G_IO_ERROR_CANCELLED, "Grab was cancelled");
+            return FALSE;
+        }
+        else if (result_event == WAIT_TIMEOUT) {
+            g_set_error (error, UCA_PCOWIN_CAMERA_ERROR, UCA_PCOWIN_CAMERA_ERROR_TIMEOUT,
+                         "No frame within %u ms", priv->grab_timeout);
+            return FALSE;
+        }
+        else {
+            g_set_error (error, UCA_PCOWIN_CAMERA_ERROR, UCA_PCOWIN_CAMERA_ERROR_GENERAL,
+                         "Waiting for a frame failed. Return value = %X, error = %lu",
+                         result_event, (gulong) GetLastError ());
+            return FALSE;
+        }
+    }
+
+    return TRUE;
+}
+
+static gboolean
+uca_pcowin_camera_grab (UcaCamera *camera, gpointer data, GError **error)
+{
+    return grab_frame (camera, data, NULL, error);
+}
+
+// Pushed to the grab queue to stop the grab thread
+static gint grab_thread_quit;
+
+static void
+cancel_grab (GCancellable *cancellable, HANDLE cancel_event)
+{
+    SetEvent (cancel_event);
+}
+
+/*
+ * Serves the grab_async requests of one camera in order. Completions are
+ * returned through GTask and thus dispatched in the main context of the
+ * caller, so one event loop can wait for any number of cameras.
+ */
+static gpointer
+grab_thread_func (GAsyncQueue *queue)
+{
+    gpointer item;
+
+    for (;;) {
+        GTask *task;
+        UcaCamera *camera;
+        UcaPcowinCameraPrivate *priv;
+        GCancellable *cancellable;
+        GError *error = NULL;
+        gulong handler = 0;
+        gboolean success;
+
+        /*
+         * The request is marked busy before the queue is unlocked, so
+         * cancel_async_grabs either finds it still queued or waits for it.
+         */
+        g_async_queue_lock (queue);
+        item = g_async_queue_pop_unlocked (queue);
+
+        if (item == &grab_thread_quit) {
+            g_async_queue_unlock (queue);
+            break;
+        }
+
+        task = item;
+        camera = g_task_get_source_object (task);
+        priv = UCA_PCOWIN_CAMERA_GET_PRIVATE (camera);
+        cancellable = g_task_get_cancellable (task);
+
+        g_mutex_lock (&priv->grab_lock);
+        priv->grab_busy = TRUE;
+
+        // Connecting an already cancelled cancellable signals the event right away
+        ResetEvent (priv->cancel_event);
+        g_mutex_unlock (&priv->grab_lock);
+        g_async_queue_unlock (queue);
+
+        if (!g_task_return_error_if_cancelled (task)) {
+            if (cancellable != NULL)
+                handler = g_cancellable_connect (cancellable, G_CALLBACK (cancel_grab), priv->cancel_event, NULL);
+
+            success = grab_frame (camera, g_task_get_task_data (task), priv->cancel_event, &error);
+
+            if (cancellable != NULL)
+                g_cancellable_disconnect (cancellable, handler);
+
+            if (success)
+                g_task_return_boolean (task, TRUE);
+            else
+                g_task_return_error (task, error);
+        }
+
+        g_mutex_lock (&priv->grab_lock);
+        priv->grab_busy = FALSE;
+        g_cond_broadcast (&priv->grab_cond);
+        g_mutex_unlock (&priv->grab_lock);
+
+        // May drop the last reference on the camera, priv must not be used afterwards
+        g_object_unref (task);
+    }
+
+    g_async_queue_unref (queue);
+    return NULL;
+}
+
+void
+uca_pcowin_camera_grab_async (UcaPcowinCamera *camera, gpointer data, GCancellable *cancellable,
+                              GAsyncReadyCallback callback, gpointer user_data)
+{
+    UcaPcowinCameraPrivate *priv;
+    GTask *task;
+
+    g_return_if_fail (UCA_IS_PCOWIN_CAMERA (camera));
+
+    priv = UCA_PCOWIN_CAMERA_GET_PRIVATE (camera);
+    task = g_task_new (camera, cancellable, callback, user_data);
+    g_task_set_task_data (task, data, NULL);
+
+    if (priv->grab_thread == NULL) {
+        GError *error = NULL;
+
+        priv->grab_thread = g_thread_try_new ("pco-grab", (GThreadFunc) grab_thread_func,
+                                              g_async_queue_ref (priv->grab_queue), &error);
+
+        if (priv->grab_thread == NULL) {
+            g_async_queue_unref (priv->grab_queue);
+            g_task_return_error (task, error);
+            g_object_unref (task);
+            return;
+        }
+    }
+
+    g_async_queue_push (priv->grab_queue, task);
+}
+
+guint
+uca_pcowin_camera_get_frames_available (UcaPcowinCamera *camera)
+{
+    UcaPcowinCameraPrivate *priv;
+    gboolean is_readout;
+    guint n_frames;
+
+    g_return_val_if_fail (UCA_IS_PCOWIN_CAMERA (camera), 0);
+
+    priv = UCA_PCOWIN_CAMERA_GET_PRIVATE (camera);
+    g_object_get (G_OBJECT (camera), "is-readout", &is_readout, NULL);
+
+    if (is_readout)
+        return priv->current_image <= priv->numberof_recorded_images ? priv->numberof_recorded_images - priv->current_image + 1 : 0;
+
+    // Buffer events stay signalled until PCO_AddBufferEx re-queues the buffer
+    for (n_frames = 0; n_frames < priv->n_stream_buffers - priv->n_recording_buffers; n_frames++) {
+        HANDLE event = priv->stream_events[(priv->next_stream_buffer + n_frames) % priv->n_stream_buffers];
+
+        if (event == NULL || WaitForSingleObject (event, 0) != WAIT_OBJECT_0)
+            break;
+    }
+
+    return n_frames;
+}
+
+gboolean
+uca_pcowin_camera_grab_finish (UcaPcowinCamera *camera, GAsyncResult *result, GError **error)
+{
+    g_return_val_if_fail (g_task_is_valid (result, camera), FALSE);
+
+    return g_task_propagate_boolean (G_TASK (result), error);
+}
+
+static gboolean
+uca_pcowin_camera_readout (UcaCamera *camera, gpointer data, guint index, GError **error)
+{
+    UcaPcowinCameraPrivate *priv;
+    gboolean is_recording;
+    int library_errors;
+
+    g_return_val_if_fail (UCA_IS_PCOWIN_CAMERA (camera), FALSE);
+
+    priv = UCA_PCOWIN_CAMERA_GET_PRIVATE (camera);
+
+    if (priv->dump != NULL) {
+        gconstpointer frame = index >= priv->readout_first_image ? uca_pcowin_dump_get_frame (priv->dump, index - priv->readout_first_image, NULL) : NULL;
+
+        if (frame == NULL) {
+            g_set_error (error, UCA_CAMERA_ERROR, UCA_CAMERA_ERROR_END_OF_STREAM,
+                         "Image %u is not part of the camRAM dump", index);
+            return FALSE;
+        }
+
+        memcpy ((gchar *) data, frame, priv->buffer_size);
+        return publish_frame (priv, data, NULL, error);
+    }
+
+    // Reading the previous segment while the next one records is fine with rotating segments
+    g_object_get (G_OBJECT (camera), "is-recording", &is_recording, NULL);
+
+    library_errors = transfer_camram_image (priv, index, is_recording, data);
+    SET_ERROR_AND_RETURN_VAL_ON_SDK_ERROR (library_errors, FALSE);
+
+    return publish_frame (priv, data, NULL, error);
+}
+
+gboolean
+uca_pcowin_camera_grab_preview (UcaPcowinCamera *camera, gpointer data, gsize size,
+                                guint *width, guint *height, guint *bytes_per_pixel,
+                                guint64 *frame_number, GError **error)
+{
+    UcaPcowinCameraPrivate *priv;
+    guint preview_width, preview_height, preview_bytes;
+
+    g_return_val_if_fail (UCA_IS_PCOWIN_CAMERA (camera), FALSE);
+
+    priv = UCA_PCOWIN_CAMERA_GET_PRIVATE (camera);
+
+    if (uca_pcowin_preview_fetch (priv->preview, data, size, &preview_width, &preview_height, &preview_bytes, frame_number)) {
+        if (width)
+            *width = preview_width;
+
+        if (height)
+            *height = preview_height;
+
+        if (bytes_per_pixel)
+            *bytes_per_pixel = preview_bytes;
+
+        return TRUE;
+    }
+
+    if ((gsize) preview_width * preview_height * preview_bytes > size) {
+        g_set_error (error, UCA_PCOWIN_CAMERA_ERROR, UCA_PCOWIN_CAMERA_ERROR_GENERAL,
+                     "Preview buffer of %" G_GSIZE_FORMAT " bytes is too small for %ux%u preview frame",
+                     size, preview_width, preview_height);
+    }
+
+    return FALSE;
+}
+
+static void start_reconnect (UcaPcowinCamera *camera);
+
+/*
+ * While the camera reboots there is no handle to talk to and the reconnect
+ * thread rewrites the description. Only properties about the camera
+ * selection and the reconnection itself stay usable until it is ready again.
+ */
+typedef struct {
+    GParamSpec *pspec;
+    GValue value;
+} DeferredProperty;
+
+static void
+deferred_property_free (DeferredProperty *deferred)
+{
+    g_value_unset (&deferred->value);
+    g_free (deferred);
+}
+
+static void
+defer_property (UcaPcowinCameraPrivate *priv, GParamSpec *pspec, const GValue *value)
+{
+    DeferredProperty *deferred;
+
+    if (priv->deferred_properties == NULL)
+        priv->deferred_properties = g_ptr_array_new_with_free_func ((GDestroyNotify) deferred_property_free);
+
+    deferred = g_new0 (DeferredProperty, 1);
+    deferred->pspec = pspec;
+    g_value_init (&deferred->value, G_VALUE_TYPE (value));
+    g_value_copy (value, &deferred->value);
+    g_ptr_array_add (priv->deferred_properties, deferred);
+}
+
+static void
+apply_deferred_properties (UcaPcowinCamera *camera)
+{
+    UcaPcowinCameraPrivate *priv;
+    GPtrArray *deferred_properties;
+
+    priv = UCA_PCOWIN_CAMERA_GET_PRIVATE (camera);
+    deferred_properties = priv->deferred_properties;
+    priv->deferred_properties = NULL;
+
+    if (deferred_properties == NULL)
+        return;
+
+    // In the order they were given, as if the camera had been open already
+    for (guint i = 0; i < deferred_properties->len; i++) {
+        DeferredProperty *deferred = g_ptr_array_index (deferred_properties, i);
+        g_object_set_property (G_OBJECT (camera), deferred->pspec->name, &deferred->value);
+    }
+
+    g_ptr_array_unref (deferred_properties);
+}
+
+static gboolean
+is_property_available (UcaPcowinCameraPrivate *priv, guint property_id)
+{
+    gboolean ready;
+
+    g_mutex_lock (&priv->reconnect_lock);
+    ready = priv->ready;
+    g_mutex_unlock (&priv->reconnect_lock);
+
+    if (ready)
+        return TRUE;
+
+    // Only the camera selection is usable before the camera is opened
+    if (!priv->init_done)
+        return property_id == PROP_CAMERA_INDEX || property_id == PROP_SERIAL_NUMBER ||
+            property_id == PROP_DESCRIPTION_CACHE;
+
+    return property_id == PROP_CAMERA_INDEX || property_id == PROP_SERIAL_NUMBER ||
+        property_id == PROP_CAMERA_READY || property_id == PROP_RECONNECT_TIMEOUT ||
+        property_id == PROP_RECONNECT_DOWNTIME || property_id == PROP_INIT_TIMINGS;
+}
+
+static void
+uca_pcowin_camera_set_property (GObject *object, guint property_id, const GValue *value, GParamSpec *pspec)
+{
+    UcaPcowinCameraPrivate *priv = UCA_PCOWIN_CAMERA_GET_PRIVATE (object);
+    int library_errors = 0;
+
+    if (!is_property_available (priv, property_id)) {
+        if (!priv->init_done)
+            defer_property (priv, pspec, value);
+        else
+            g_warning ("Property '%s' can not be changed while the camera is not ready", pspec->name);
+
+        return;
+    }
+
+    if (uca_camera_is_recording (UCA_CAMERA (object)) && !uca_camera_is_writable_during_acquisition (UCA_CAMERA (object), pspec->name)) {
+        g_warning ("Property '%s' can not be changed during acquisition", pspec->name);
+        return;
+    }
 
     switch(property_id) {
         case PROP_SENSOR_EXTENDED:
             {
                 guint16 format = g_value_get_boolean (value) ? SENSORFORMAT_EXTENDED : SENSORFORMAT_STANDARD;
-                library_errors = PCO_SetSensorFormat (priv->pcoHandle, format);
+                library_errors = CONTROL_CALL (PCO_SetSensorFormat (priv->pcoHandle, format));
             }
             break;
         case PROP_ROI_X:
@@ -513,9 +3048,9 @@ uca_pcowin_camera_set_property (GObject *object, guint property_id, const GValue
                 guint16 framerate_status;
                 guint16 mode_exposure_has_priority = 0x0002;
                 guint32 framerate, framerate_exposure; //Exposure time is in ns
-                library_errors = PCO_GetFrameRate (priv->pcoHandle, &framerate_status, &framerate, &framerate_exposure);
+                library_errors = QUERY_CALL (PCO_GetFrameRate (priv->pcoHandle, &framerate_status, &framerate, &framerate_exposure));
                 framerate_exposure = g_value_get_double (value) * 1000 * 1000 * 1000;
-                library_errors = PCO_SetFrameRate (priv->pcoHandle, &framerate_status, mode_exposure_has_priority, &framerate, &framerate_exposure);
+                library_errors = CONTROL_CALL (PCO_SetFrameRate (priv->pcoHandle, &framerate_status, mode_exposure_has_priority, &framerate, &framerate_exposure));
             }
             break;
         case PROP_FRAMES_PER_SECOND:
@@ -524,10 +3059,14 @@ uca_pcowin_camera_set_property (GObject *object, guint property_id, const GValue
                 guint16 framerate_status;
                 guint16 mode_framerate_has_priority = 0x0001;
                 guint32 framerate, framerate_exposure; //Exposure time is in ns
-                library_errors = PCO_GetFrameRate (priv->pcoHandle, &framerate_status, &framerate, &framerate_exposure);
+                library_errors = QUERY_CALL (PCO_GetFrameRate (priv->pcoHandle, &framerate_status, &framerate, &framerate_exposure));
                 framerate = g_value_get_double (value) * 1000;
-                library_errors = PCO_SetFrameRate (priv->pcoHandle, &framerate_status, mode_framerate_has_priority, &framerate, &framerate_exposure);
-                // @ToDo. framerate_status variables hold information if the desired framerate was trimmed because of other settings
+                library_errors = CONTROL_CALL (PCO_SetFrameRate (priv->pcoHandle, &framerate_status, mode_framerate_has_priority, &framerate, &framerate_exposure));
+
+                // framerate_status tells if the desired framerate was trimmed because of other settings
+                if (!library_errors && framerate_status != 0)
+                    g_warning ("Frame rate was trimmed to %.3f fps, use uca_pcowin_camera_plan_frame_rate() to find a configuration that reaches it",
+                               framerate / 1000.);
             }
             break;
         case PROP_SENSOR_PIXELRATE:
@@ -536,6 +3075,8 @@ uca_pcowin_camera_set_property (GObject *object, guint property_id, const GValue
                 guint32 pixelrate_to_set = 0;
                 pixelrate = g_value_get_uint (value);
 
+                g_mutex_lock (&priv->reconnect_lock);
+
                 for (int i=0; i< priv->possible_pixelrates->n_values; i++) {
                     if (g_value_get_uint (g_value_array_get_nth (priv->possible_pixelrates, i)) == pixelrate) {
                         pixelrate_to_set = pixelrate;
@@ -543,8 +3084,10 @@ uca_pcowin_camera_set_property (GObject *object, guint property_id, const GValue
                     }
                 }
 
+                g_mutex_unlock (&priv->reconnect_lock);
+
                 if (pixelrate_to_set)
-                    library_errors = PCO_SetPixelRate (priv->pcoHandle, pixelrate_to_set);
+                    library_errors = CONTROL_CALL (PCO_SetPixelRate (priv->pcoHandle, pixelrate_to_set));
                 else
                     g_warning ("Pixelrate is not set. %d Hz is not in the range of possible pixelrates. Check \'sensor-pixelrates\' property",pixelrate);
             }
@@ -553,7 +3096,7 @@ uca_pcowin_camera_set_property (GObject *object, guint property_id, const GValue
             {
                 // PCO_SetOffsetMode is available only for pco.1400, pco.pixelfly.usb, pco.1300.
                 if (CAMERATYPE_PCO1300 == priv->strCamType.wCamType || CAMERATYPE_PCO1400 == priv->strCamType.wCamType || CAMERATYPE_PCO_USBPIXELFLY == priv->strCamType.wCamType)
-                    library_errors = PCO_SetOffsetMode (priv->pcoHandle, g_value_get_boolean (value) ? 1 : 0);
+                    library_errors = CONTROL_CALL (PCO_SetOffsetMode (priv->pcoHandle, g_value_get_boolean (value) ? 1 : 0));
             }
             break;
         case PROP_COOLING_POINT:
@@ -565,7 +3108,7 @@ uca_pcowin_camera_set_property (GObject *object, guint property_id, const GValue
                     if (temperature < priv->strDescription.sMinCoolSetDESC || temperature > priv->strDescription.sMaxCoolSetDESC)
                         g_warning ("Temperature beyond available cooling range");
                     else
-                        library_errors = PCO_SetCoolingSetpointTemperature (priv->pcoHandle, temperature);
+                        library_errors = CONTROL_CALL (PCO_SetCoolingSetpointTemperature (priv->pcoHandle, temperature));
                 }
             }
             break;
@@ -575,10 +3118,10 @@ uca_pcowin_camera_set_property (GObject *object, guint property_id, const GValue
 
                 switch(subMode) {
                     case UCA_PCO_CAMERA_RECORD_MODE_SEQUENCE:
-                        library_errors = PCO_SetRecorderSubmode (priv->pcoHandle,RECORDER_SUBMODE_SEQUENCE);
+                        library_errors = CONTROL_CALL (PCO_SetRecorderSubmode (priv->pcoHandle,RECORDER_SUBMODE_SEQUENCE));
                         break;
                     case UCA_PCO_CAMERA_RECORD_MODE_RING_BUFFER:
-                        library_errors = PCO_SetRecorderSubmode (priv->pcoHandle, RECORDER_SUBMODE_RINGBUFFER);
+                        library_errors = CONTROL_CALL (PCO_SetRecorderSubmode (priv->pcoHandle, RECORDER_SUBMODE_RINGBUFFER));
                         break;
                 }
             }
@@ -589,10 +3132,10 @@ uca_pcowin_camera_set_property (GObject *object, guint property_id, const GValue
 
                 switch (storageMode) {
                     case UCA_PCO_CAMERA_STORAGE_MODE_RECORDER:
-                        library_errors = PCO_SetStorageMode (priv->pcoHandle, STORAGE_MODE_RECORDER);
+                        library_errors = CONTROL_CALL (PCO_SetStorageMode (priv->pcoHandle, STORAGE_MODE_RECORDER));
                         break;
                     case UCA_PCO_CAMERA_STORAGE_MODE_FIFO_BUFFER:
-                        library_errors = PCO_SetStorageMode (priv->pcoHandle, STORAGE_MODE_FIFO_BUFFER);
+                        library_errors = CONTROL_CALL (PCO_SetStorageMode (priv->pcoHandle, STORAGE_MODE_FIFO_BUFFER));
                         break;
                 }
             }
@@ -603,10 +3146,10 @@ uca_pcowin_camera_set_property (GObject *object, guint property_id, const GValue
 
                 switch (acqMode) {
                     case UCA_PCO_CAMERA_ACQUIRE_MODE_AUTO:
-                        library_errors = PCO_SetAcquireMode (priv->pcoHandle, ACQUIRE_MODE_AUTO);
+                        library_errors = CONTROL_CALL (PCO_SetAcquireMode (priv->pcoHandle, ACQUIRE_MODE_AUTO));
                         break;
                     case UCA_PCO_CAMERA_ACQUIRE_MODE_EXTERNAL:
-                        library_errors = PCO_SetAcquireMode (priv->pcoHandle, ACQUIRE_MODE_EXTERNAL);
+                        library_errors = CONTROL_CALL (PCO_SetAcquireMode (priv->pcoHandle, ACQUIRE_MODE_EXTERNAL));
                         break;
                 }
             }
@@ -617,13 +3160,13 @@ uca_pcowin_camera_set_property (GObject *object, guint property_id, const GValue
 
                 switch (triggerMode) {
                     case UCA_CAMERA_TRIGGER_SOURCE_AUTO:
-                        library_errors = PCO_SetTriggerMode (priv->pcoHandle, TRIGGER_MODE_AUTOTRIGGER);
+                        library_errors = CONTROL_CALL (PCO_SetTriggerMode (priv->pcoHandle, TRIGGER_MODE_AUTOTRIGGER));
                         break;
                     case UCA_CAMERA_TRIGGER_SOURCE_SOFTWARE:
-                        library_errors = PCO_SetTriggerMode (priv->pcoHandle, TRIGGER_MODE_SOFTWARETRIGGER);
+                        library_errors = CONTROL_CALL (PCO_SetTriggerMode (priv->pcoHandle, TRIGGER_MODE_SOFTWARETRIGGER));
                         break;
                     case UCA_CAMERA_TRIGGER_SOURCE_EXTERNAL:
-                        library_errors = PCO_SetTriggerMode (priv->pcoHandle, TRIGGER_MODE_EXTERNALTRIGGER);
+                        library_errors = CONTROL_CALL (PCO_SetTriggerMode (priv->pcoHandle, TRIGGER_MODE_EXTERNALTRIGGER));
                         break;
                     default:
                         g_warning("Trigger mode provided by camera cannot be handled");
@@ -636,16 +3179,16 @@ uca_pcowin_camera_set_property (GObject *object, guint property_id, const GValue
 
                 switch(timestamp_mode) {
                     case UCA_PCO_CAMERA_TIMESTAMP_NONE:
-                        PCO_SetTimestampMode (priv->pcoHandle, TIMESTAMP_MODE_OFF);
+                        CONTROL_CALL (PCO_SetTimestampMode (priv->pcoHandle, TIMESTAMP_MODE_OFF));
                         break;
                     case UCA_PCO_CAMERA_TIMESTAMP_BINARY:
-                        PCO_SetTimestampMode (priv->pcoHandle, TIMESTAMP_MODE_BINARY);
+                        CONTROL_CALL (PCO_SetTimestampMode (priv->pcoHandle, TIMESTAMP_MODE_BINARY));
                         break;
                     case UCA_PCO_CAMERA_TIMESTAMP_BINARYANDASCII:
-                        PCO_SetTimestampMode (priv->pcoHandle, TIMESTAMP_MODE_BINARYANDASCII);
+                        CONTROL_CALL (PCO_SetTimestampMode (priv->pcoHandle, TIMESTAMP_MODE_BINARYANDASCII));
                         break;
                     case UCA_PCO_CAMERA_TIMESTAMP_ASCII:
-                        PCO_SetTimestampMode (priv->pcoHandle, TIMESTAMP_MODE_ASCII);
+                        CONTROL_CALL (PCO_SetTimestampMode (priv->pcoHandle, TIMESTAMP_MODE_ASCII));
                         break;
                 }
             }
@@ -656,18 +3199,30 @@ uca_pcowin_camera_set_property (GObject *object, guint property_id, const GValue
                 guint32 setup[2];
                 int timeouts[3] = {2000,3000,250}; // command, image, and channel timeout
 
-                if (check_camera_type (priv->strCamType.wCamType & 0xFF00, CAMERATYPE_PCO_EDGE)) {
-                    PCO_GetCameraSetup (priv->pcoHandle, &setup_type, &setup[0], &valid_setups);
-                    setup[0] = g_value_get_boolean (value) ? PCO_EDGE_SETUP_GLOBAL_SHUTTER : PCO_EDGE_SETUP_ROLLING_SHUTTER;
+                if (check_camera_type (priv->strCamType.wCamType & 0xFF00, CAMERATYPE_PCO_EDGE) && priv->ready) {
+                    guint32 new_setup = g_value_get_boolean (value) ? PCO_EDGE_SETUP_GLOBAL_SHUTTER : PCO_EDGE_SETUP_ROLLING_SHUTTER;
+                    guint16 framerate_status;
+
+                    QUERY_CALL (PCO_GetCameraSetup (priv->pcoHandle, &setup_type, &setup[0], &valid_setups));
+
+                    // Only a change of the mode is worth the reboot
+                    if (setup[0] == new_setup)
+                        break;
+
+                    // The reboot resets the exposure, ROI and binning are kept in priv anyway
+                    QUERY_CALL (PCO_GetFrameRate (priv->pcoHandle, &framerate_status, &priv->saved_framerate, &priv->saved_exposure));
+                    setup[0] = new_setup;
+                    uca_pcowin_health_stop (priv->health);
+
                     // SDK manual recommends to use timeouts before changing the camera setup
-                    PCO_SetTimeouts (priv->pcoHandle, &timeouts[0], sizeof(timeouts));
+                    CONTROL_CALL (PCO_SetTimeouts (priv->pcoHandle, &timeouts[0], sizeof(timeouts)));
                     /*
                     SDK Manual recommends to reboot and close camera, wait for 10 seconds before reopening again
-                    When Global Shutter is toggled in the GUI, close the application and reopen it again
+                    The camera is reopened in the background as soon as it answers again
                     */
-                    PCO_SetCameraSetup (priv->pcoHandle, setup_type, &setup[0], valid_setups);
-                    PCO_RebootCamera (priv->pcoHandle);
-                    PCO_CloseCamera (priv->pcoHandle);
+                    CONTROL_CALL (PCO_SetCameraSetup (priv->pcoHandle, setup_type, &setup[0], valid_setups));
+                    CONTROL_CALL (PCO_RebootCamera (priv->pcoHandle));
+                    start_reconnect (UCA_PCOWIN_CAMERA (object));
                 }
             }
             break;
@@ -675,7 +3230,7 @@ uca_pcowin_camera_set_property (GObject *object, guint property_id, const GValue
             {
                 guint16 adc_operation = g_value_get_uint (value);
                 if (adc_operation <= priv->strDescription.wNumADCsDESC)
-                    library_errors = PCO_SetADCOperation (priv->pcoHandle, adc_operation);
+                    library_errors = CONTROL_CALL (PCO_SetADCOperation (priv->pcoHandle, adc_operation));
                 else
                     g_warning("Cannot set ADC. Check maximum available ADCs");
             }
@@ -686,7 +3241,7 @@ uca_pcowin_camera_set_property (GObject *object, guint property_id, const GValue
 
                 if (priv->strDescription.dwGeneralCapsDESC1 & 0x0001) {
                     noise_filter_mode = g_value_get_boolean (value);
-                    PCO_SetNoiseFilterMode (priv->pcoHandle, noise_filter_mode);
+                    CONTROL_CALL (PCO_SetNoiseFilterMode (priv->pcoHandle, noise_filter_mode));
                 }
                 else
                     g_warning("Noise filter mode not available in camera model");
@@ -696,39 +3251,239 @@ uca_pcowin_camera_set_property (GObject *object, guint property_id, const GValue
             {
                 guint16 double_image;
 
-                if (priv->strDescription.wDoubleImageDESC) {
-                    double_image = g_value_get_boolean (value);
-                    PCO_SetDoubleImageMode (priv->pcoHandle, double_image);
-                }
-                else {
-                    g_warning("Double image mode is not available in Camera");
-                }
-            }
+                if (priv->strDescription.wDoubleImageDESC) {
+                    double_image = g_value_get_boolean (value);
+                    CONTROL_CALL (PCO_SetDoubleImageMode (priv->pcoHandle, double_image));
+                }
+                else {
+                    g_warning("Double image mode is not available in Camera");
+                }
+            }
+            break;
+        case PROP_PREVIEW_DECIMATION:
+            priv->preview_decimation = g_value_get_uint (value);
+            configure_preview (priv);
+            break;
+        case PROP_PREVIEW_MAX_FPS:
+            priv->preview_max_fps = g_value_get_double (value);
+            configure_preview (priv);
+            break;
+        case PROP_PREVIEW_DOWNSAMPLING:
+            {
+                guint downsampling = g_value_get_uint (value);
+
+                if (downsampling == 1 || downsampling == 2 || downsampling == 4) {
+                    priv->preview_downsampling = downsampling;
+                    configure_preview (priv);
+                }
+                else
+                    g_warning ("Preview downsampling must be 1, 2 or 4");
+            }
+            break;
+        case PROP_PREVIEW_EIGHT_BIT:
+            priv->preview_eight_bit = g_value_get_boolean (value);
+            configure_preview (priv);
+            break;
+        case PROP_SHARED_MEMORY_NAME:
+            g_free (priv->shm_name);
+            priv->shm_name = g_value_dup_string (value);
+
+            if (priv->shm_name == NULL || priv->shm_name[0] == '\0')
+                g_clear_pointer (&priv->shm_ring, uca_pcowin_shm_ring_free);
+            break;
+        case PROP_SHARED_MEMORY_SLOTS:
+            priv->shm_slots = g_value_get_uint (value);
+            g_clear_pointer (&priv->shm_ring, uca_pcowin_shm_ring_free);
+            break;
+        case PROP_RECORD_FILE:
+            g_free (priv->record_file);
+            priv->record_file = g_value_dup_string (value);
+            break;
+        case PROP_RECORD_BUFFERS:
+            priv->record_buffers = g_value_get_uint (value);
+            break;
+        case PROP_READOUT_DUMP_FILE:
+            g_free (priv->dump_file);
+            priv->dump_file = g_value_dup_string (value);
+            break;
+        case PROP_COMPRESSION:
+            priv->compression = g_value_get_boolean (value);
+            break;
+        case PROP_COMPRESSION_THREADS:
+            priv->compression_threads = g_value_get_uint (value);
+            break;
+        case PROP_CAMERA_INDEX:
+            priv->camera_index = g_value_get_uint (value);
+            break;
+        case PROP_DESCRIPTION_CACHE:
+            priv->description_cache = g_value_get_boolean (value);
+            break;
+        case PROP_RECONNECT_TIMEOUT:
+            priv->reconnect_timeout = g_value_get_uint (value);
+            break;
+        case PROP_SERIAL_NUMBER:
+            priv->serial_number = g_value_get_uint (value);
+            break;
+        case PROP_GRAB_TIMEOUT:
+            priv->grab_timeout = g_value_get_uint (value);
+            break;
+        case PROP_CAMRAM_SEGMENT_SIZES:
+            {
+                GValueArray *array = g_value_get_boxed (value);
+                guint32 sizes[MAX_RAM_SEGMENTS] = { 0 };
+
+                if (array == NULL || array->n_values == 0 || array->n_values > MAX_RAM_SEGMENTS) {
+                    g_warning ("camRAM can be split into 1 to %d segments", MAX_RAM_SEGMENTS);
+                    break;
+                }
+
+                for (guint i = 0; i < array->n_values; i++)
+                    sizes[i] = g_value_get_uint (g_value_array_get_nth (array, i));
+
+                // Clears all segments and makes segment 1 active, the camera is armed in start_recording
+                library_errors = CONTROL_CALL (PCO_SetCameraRamSegmentSize (priv->pcoHandle, sizes));
+
+                if (!library_errors) {
+                    QUERY_CALL (PCO_GetActiveRamSegment (priv->pcoHandle, &priv->active_ram_segment));
+                    priv->readout_segment = priv->active_ram_segment;
+                }
+            }
+            break;
+        case PROP_CAMRAM_ROTATE_SEGMENTS:
+            priv->rotate_segments = g_value_get_boolean (value);
+            break;
+        case PROP_FIFO_BUFFERS:
+            priv->fifo_buffers = g_value_get_uint (value);
+            break;
+        case PROP_RECORD_STOP_EVENT:
+            priv->record_stop_event = g_value_get_enum (value);
+            break;
+        case PROP_TRANSFER_SELECTION:
+            priv->transfer_selection = g_value_get_enum (value);
+            break;
+        case PROP_TRANSFER_DECODE:
+            priv->transfer_decode = g_value_get_enum (value);
+            break;
+        case PROP_DECODE_TABLE_FILE:
+            g_free (priv->decode_table_file);
+            priv->decode_table_file = g_value_dup_string (value);
+
+            // Loaded again when recording starts
+            uca_pcowin_decoder_free (priv->decoder);
+            priv->decoder = NULL;
+            break;
+        case PROP_TRANSFER_FORMAT:
+        case PROP_TRANSFER_LUT:
+        case PROP_TRANSFER_CLOCK:
+            {
+                PCO_SC2_CL_TRANSFER_PARAM params;
+                guint32 data_format, clock_frequency = 0;
+                guint16 lut;
+
+                library_errors = get_transfer_parameters (priv, &params, &lut);
+
+                if (library_errors)
+                    break;
+
+                data_format = params.DataFormat & PCO_CL_DATAFORMAT_MASK;
+
+                if (property_id == PROP_TRANSFER_FORMAT)
+                    data_format = transfer_formats[g_value_get_enum (value)];
+                else if (property_id == PROP_TRANSFER_LUT)
+                    lut = g_value_get_uint (value);
+                else
+                    clock_frequency = g_value_get_uint (value);
+
+                // An explicit choice must not be overridden when recording starts
+                library_errors = set_transfer_parameters (priv, data_format, lut, clock_frequency);
+                priv->transfer_selection = UCA_PCO_CAMERA_TRANSFER_SELECTION_MANUAL;
+            }
+            break;
+        case PROP_EVENT_PRE_FRAMES:
+            priv->event_pre_frames = g_value_get_uint (value);
+            break;
+        case PROP_EVENT_POST_FRAMES:
+            priv->event_post_frames = g_value_get_uint (value);
+            break;
+        case PROP_HEALTH_MONITOR:
+            priv->health_monitor = g_value_get_boolean (value);
+
+            if (priv->health != NULL) {
+                if (priv->health_monitor) {
+                    GError *health_error = NULL;
+
+                    if (!uca_pcowin_health_start (priv->health, &health_error)) {
+                        g_warning ("Could not start health monitor: %s", health_error->message);
+                        g_error_free (health_error);
+                    }
+                }
+                else
+                    uca_pcowin_health_stop (priv->health);
+            }
+            break;
+        case PROP_ACQUISITION_CPU_MASK:
+            priv->acquisition_cpu_mask = g_value_get_uint64 (value);
+            break;
+        case PROP_ACQUISITION_PRIORITY:
+            priv->acquisition_priority = g_value_get_enum (value);
+            break;
+        case PROP_LOCK_BUFFERS:
+            priv->lock_buffers = g_value_get_boolean (value);
+            break;
+        case PROP_BUFFER_ALLOCATION:
+            priv->buffer_allocation = g_value_get_enum (value);
+            break;
+        case PROP_HEALTH_POLL_INTERVAL:
+            priv->health_poll_interval = g_value_get_uint (value);
+
+            if (priv->health != NULL)
+                uca_pcowin_health_set_intervals (priv->health, priv->health_poll_interval, priv->health_poll_interval_recording);
+            break;
+        case PROP_HEALTH_POLL_INTERVAL_RECORDING:
+            priv->health_poll_interval_recording = g_value_get_uint (value);
+
+            if (priv->health != NULL)
+                uca_pcowin_health_set_intervals (priv->health, priv->health_poll_interval, priv->health_poll_interval_recording);
+            break;
+        case PROP_READOUT_SEGMENT:
+            priv->readout_segment = g_value_get_uint (value);
             break;
         default:
             g_warning("Undefined Property");
     }
 
     if (library_errors) {
-        PCO_GetErrorText (library_errors, error_text, ERROR_TEXT_BUFFER_SIZE);
+        PCO_GetErrorText (library_errors, priv->error_text, ERROR_TEXT_BUFFER_SIZE);
         g_warning ("Failed to set property %s. Here's error code 0x%X for enquiring minds.\nSDK Error Text: %s",
-                   pco_properties[property_id]->name, library_errors, error_text);
+                   pco_properties[property_id]->name, library_errors, priv->error_text);
     }
+
+    // Control calls invalidate reads as well, this covers settings kept on the host
+    uca_pcowin_scheduler_invalidate_reads (priv->scheduler);
 }
 
 static void
 uca_pcowin_camera_get_property (GObject *object, guint property_id, GValue *value, GParamSpec *pspec)
 {
     UcaPcowinCameraPrivate *priv;
-    int library_errors;
+    UcaPcowinPendingRead *pending;
+    int library_errors = 0;
 
     priv = UCA_PCOWIN_CAMERA_GET_PRIVATE (object);
 
+    // The value keeps its default while the camera is not ready
+    if (!is_property_available (priv, property_id))
+        return;
+
+    // A concurrent read of the same property answers this one as well
+    if (uca_pcowin_scheduler_join_read (priv->scheduler, property_id, value, &pending))
+        return;
+
     switch (property_id) {
         case PROP_SENSOR_EXTENDED:
             {
                 guint16 format;
-                library_errors = PCO_GetSensorFormat (priv->pcoHandle,&format);
+                library_errors = QUERY_CALL (PCO_GetSensorFormat (priv->pcoHandle,&format));
                 g_value_set_boolean (value, format == SENSORFORMAT_EXTENDED);
             }
             break;
@@ -740,18 +3495,106 @@ uca_pcowin_camera_get_property (GObject *object, guint property_id, GValue *valu
             break;
         case PROP_SENSOR_TEMPERATURE:
             {
-                short ccdTemp, camTemp, powTemp;
-                library_errors = PCO_GetTemperature (priv->pcoHandle, &ccdTemp, &camTemp, &powTemp);
-                g_value_set_double (value, ccdTemp / 10);
+                UcaPcowinHealthSample sample;
+
+                if (get_health_sample (priv, &sample)) {
+                    g_value_set_double (value, sample.sensor_temperature);
+                }
+                else {
+                    short ccdTemp, camTemp, powTemp;
+                    library_errors = QUERY_CALL (PCO_GetTemperature (priv->pcoHandle, &ccdTemp, &camTemp, &powTemp));
+                    g_value_set_double (value, ccdTemp / 10.0);
+                }
+            }
+            break;
+        case PROP_CAMERA_TEMPERATURE:
+        case PROP_POWER_SUPPLY_TEMPERATURE:
+            {
+                UcaPcowinHealthSample sample;
+
+                if (!get_health_sample (priv, &sample)) {
+                    short ccdTemp, camTemp, powTemp;
+                    library_errors = QUERY_CALL (PCO_GetTemperature (priv->pcoHandle, &ccdTemp, &camTemp, &powTemp));
+                    sample.camera_temperature = camTemp;
+                    sample.power_temperature = powTemp;
+                }
+
+                g_value_set_double (value, property_id == PROP_CAMERA_TEMPERATURE ? sample.camera_temperature : sample.power_temperature);
+            }
+            break;
+        case PROP_HEALTH_WARNINGS:
+        case PROP_HEALTH_ERRORS:
+        case PROP_HEALTH_STATUS:
+            {
+                UcaPcowinHealthSample sample;
+
+                if (!get_health_sample (priv, &sample))
+                    library_errors = QUERY_CALL (PCO_GetCameraHealthStatus (priv->pcoHandle, &sample.warnings, &sample.errors, &sample.status));
+
+                if (property_id == PROP_HEALTH_WARNINGS)
+                    g_value_set_uint (value, sample.warnings);
+                else if (property_id == PROP_HEALTH_ERRORS)
+                    g_value_set_uint (value, sample.errors);
+                else
+                    g_value_set_uint (value, sample.status);
+            }
+            break;
+        case PROP_HEALTH_MONITOR:
+            g_value_set_boolean (value, priv->health_monitor);
+            break;
+        case PROP_ACQUISITION_CPU_MASK:
+            g_value_set_uint64 (value, priv->acquisition_cpu_mask);
+            break;
+        case PROP_ACQUISITION_PRIORITY:
+            g_value_set_enum (value, priv->acquisition_priority);
+            break;
+        case PROP_LOCK_BUFFERS:
+            g_value_set_boolean (value, priv->lock_buffers);
+            break;
+        case PROP_ACQUISITION_CPU_MASK_APPLIED:
+            g_value_set_uint64 (value, priv->applied_cpu_mask);
+            break;
+        case PROP_BUFFER_ALLOCATION:
+            g_value_set_enum (value, priv->buffer_allocation);
+            break;
+        case PROP_BUFFER_PAGE_SIZE:
+        case PROP_BUFFER_PAGES:
+        case PROP_BUFFER_NUMA_NODE:
+            {
+                UcaPcowinArenaStats stats = { 0, 0, 0, 0, UCA_PCOWIN_ARENA_ANY_NODE, 0 };
+
+                if (priv->arena != NULL)
+                    uca_pcowin_arena_get_stats (priv->arena, &stats);
+
+                if (property_id == PROP_BUFFER_PAGE_SIZE)
+                    g_value_set_uint64 (value, stats.page_size);
+                else if (property_id == PROP_BUFFER_PAGES)
+                    g_value_set_uint64 (value, stats.n_pages);
+                else
+                    g_value_set_int (value, stats.numa_node);
             }
             break;
+        case PROP_ACQUISITION_PRIORITY_APPLIED:
+            g_value_set_enum (value, priv->applied_priority);
+            break;
+        case PROP_LOCKED_BUFFER_SIZE:
+            g_value_set_uint64 (value, priv->locked_buffer_size);
+            break;
+        case PROP_HEALTH_POLL_INTERVAL:
+            g_value_set_uint (value, priv->health_poll_interval);
+            break;
+        case PROP_HEALTH_POLL_INTERVAL_RECORDING:
+            g_value_set_uint (value, priv->health_poll_interval_recording);
+            break;
         case PROP_SENSOR_PIXELRATES:
+            g_mutex_lock (&priv->reconnect_lock);
             g_value_set_boxed (value, priv->possible_pixelrates);
+            g_mutex_unlock (&priv->reconnect_lock);
             break;
         case PROP_SENSOR_PIXELRATE:
             {
                 guint32 pixelrate; // pixelrate in Hz
-                library_errors = PCO_GetPixelRate (priv->pcoHandle, &pixelrate);
+                library_errors = QUERY_CALL (PCO_GetPixelRate (priv->pcoHandle, &pixelrate));
                 g_value_set_uint (value, pixelrate);
             }
             break;
@@ -759,7 +3602,7 @@ uca_pcowin_camera_get_property (GObject *object, guint property_id, GValue *valu
             {
                 guint16 offsetRegulation = FALSE;
                 if (CAMERATYPE_PCO1300 == priv->strCamType.wCamType || CAMERATYPE_PCO1400 == priv->strCamType.wCamType || CAMERATYPE_PCO_USBPIXELFLY == priv->strCamType.wCamType)
-                    library_errors = PCO_GetOffsetMode (priv->pcoHandle, &offsetRegulation);
+                    library_errors = QUERY_CALL (PCO_GetOffsetMode (priv->pcoHandle, &offsetRegulation));
                 g_value_set_boolean(value, offsetRegulation ? TRUE: FALSE);
             }
             break;
@@ -767,7 +3610,7 @@ uca_pcowin_camera_get_property (GObject *object, guint property_id, GValue *valu
             {
                 // Only available if the storage mode is set to recorder
                 guint16 recorderSubmode;
-                library_errors = PCO_GetRecorderSubmode (priv->pcoHandle, &recorderSubmode);
+                library_errors = QUERY_CALL (PCO_GetRecorderSubmode (priv->pcoHandle, &recorderSubmode));
 
                 switch(recorderSubmode) {
                     case RECORDER_SUBMODE_SEQUENCE:
@@ -782,7 +3625,7 @@ uca_pcowin_camera_get_property (GObject *object, guint property_id, GValue *valu
         case PROP_STORAGE_MODE:
             {
                 guint16 storageMode;
-                library_errors = PCO_GetStorageMode (priv->pcoHandle, &storageMode);
+                library_errors = QUERY_CALL (PCO_GetStorageMode (priv->pcoHandle, &storageMode));
 
                 switch (storageMode) {
                     case STORAGE_MODE_RECORDER:
@@ -797,7 +3640,7 @@ uca_pcowin_camera_get_property (GObject *object, guint property_id, GValue *valu
         case PROP_ACQUIRE_MODE:
             {
                 guint16 acqMode;
-                library_errors = PCO_GetAcquireMode (priv->pcoHandle, &acqMode);
+                library_errors = QUERY_CALL (PCO_GetAcquireMode (priv->pcoHandle, &acqMode));
 
                 switch (acqMode) {
                     case ACQUIRE_MODE_AUTO:
@@ -813,7 +3656,7 @@ uca_pcowin_camera_get_property (GObject *object, guint property_id, GValue *valu
             {
                 gint16 coolingSetPoint = 0;
                 if (CAMERATYPE_PCO1300 == priv->strCamType.wCamType || CAMERATYPE_PCO1600 == priv->strCamType.wCamType || CAMERATYPE_PCO2000 == priv->strCamType.wCamType || CAMERATYPE_PCO4000 == priv->strCamType.wCamType)
-                    library_errors = PCO_GetCoolingSetpointTemperature (priv->pcoHandle, &coolingSetPoint);
+                    library_errors = QUERY_CALL (PCO_GetCoolingSetpointTemperature (priv->pcoHandle, &coolingSetPoint));
 
                 g_value_set_int(value, coolingSetPoint);
             }
@@ -832,7 +3675,7 @@ uca_pcowin_camera_get_property (GObject *object, guint property_id, GValue *valu
                 /*Note: Not all cameras have TIMESTAMP_ASCII available.
                 Bit 3 of dwGeneralCapsDESC1 var in PCO_Description struct indicates availability of TIMESTAMP_ASCII*/
                 guint16 timestamp_mode;
-                library_errors = PCO_GetTimestampMode (priv->pcoHandle, &timestamp_mode);
+                library_errors = QUERY_CALL (PCO_GetTimestampMode (priv->pcoHandle, &timestamp_mode));
                 switch(timestamp_mode) {
                     case TIMESTAMP_MODE_OFF:
                         g_value_set_enum (value, UCA_PCO_CAMERA_TIMESTAMP_NONE);
@@ -854,7 +3697,7 @@ uca_pcowin_camera_get_property (GObject *object, guint property_id, GValue *valu
                 guint16 setup_type, valid_setups = 2;
                 guint32 setup[2];
                 if (check_camera_type (priv->strCamType.wCamType & 0xFF00, CAMERATYPE_PCO_EDGE)) {
-                    PCO_GetCameraSetup (priv->pcoHandle, &setup_type, &setup[0], &valid_setups);
+                    QUERY_CALL (PCO_GetCameraSetup (priv->pcoHandle, &setup_type, &setup[0], &valid_setups));
                     g_value_set_boolean (value, setup[0] == PCO_EDGE_SETUP_GLOBAL_SHUTTER);
                 }
             }
@@ -862,7 +3705,7 @@ uca_pcowin_camera_get_property (GObject *object, guint property_id, GValue *valu
         case PROP_SENSOR_ADCS:
             {
                 guint16 adc_operation;
-                PCO_GetADCOperation (priv->pcoHandle, &adc_operation);
+                QUERY_CALL (PCO_GetADCOperation (priv->pcoHandle, &adc_operation));
                 g_value_set_uint (value, adc_operation);
             }
             break;
@@ -877,7 +3720,7 @@ uca_pcowin_camera_get_property (GObject *object, guint property_id, GValue *valu
                 guint16 noise_filter_mode;
                 if (priv->strDescription.dwGeneralCapsDESC1 & 0x0001) {
                     // Noise filter available
-                    PCO_GetNoiseFilterMode (priv->pcoHandle, &noise_filter_mode);
+                    QUERY_CALL (PCO_GetNoiseFilterMode (priv->pcoHandle, &noise_filter_mode));
                     g_value_set_boolean (value, (boolean) noise_filter_mode);
                 }
                 else
@@ -891,7 +3734,7 @@ uca_pcowin_camera_get_property (GObject *object, guint property_id, GValue *valu
             {
                 guint16 double_image;
                 if (priv->strDescription.wDoubleImageDESC) {
-                    PCO_GetDoubleImageMode (priv->pcoHandle, &double_image);
+                    QUERY_CALL (PCO_GetDoubleImageMode (priv->pcoHandle, &double_image));
                     g_value_set_boolean (value, double_image == 1);
                 }
             }
@@ -962,7 +3805,7 @@ uca_pcowin_camera_get_property (GObject *object, guint property_id, GValue *valu
                 // Works for dimax and edge only
                 guint16 framerate_status;
                 guint32 framerate, framerate_exposure;
-                library_errors = PCO_GetFrameRate (priv->pcoHandle, &framerate_status, &framerate, &framerate_exposure);
+                library_errors = QUERY_CALL (PCO_GetFrameRate (priv->pcoHandle, &framerate_status, &framerate, &framerate_exposure));
                 g_value_set_double (value, framerate_exposure / 1000. / 1000. / 1000.);
             }
             break;
@@ -971,7 +3814,7 @@ uca_pcowin_camera_get_property (GObject *object, guint property_id, GValue *valu
                 // Works for dimax and edge only
                 guint16 framerate_status;
                 guint32 framerate, framerate_exposure;
-                library_errors = PCO_GetFrameRate (priv->pcoHandle, &framerate_status, &framerate, &framerate_exposure);
+                library_errors = QUERY_CALL (PCO_GetFrameRate (priv->pcoHandle, &framerate_status, &framerate, &framerate_exposure));
                 g_value_set_double (value, framerate / 1000.); //mHz to Hz
             }
             break;
@@ -985,7 +3828,7 @@ uca_pcowin_camera_get_property (GObject *object, guint property_id, GValue *valu
                 guint16 page_size;
                 /* There seems to be no straightforward way to check availability of camRAM using SDK calls.
                    Any storage control API would return an error if camRAM is not available. */
-                g_value_set_boolean (value, PCO_GetCameraRamSize (priv->pcoHandle, &ram_size, &page_size) ? FALSE: TRUE);
+                g_value_set_boolean (value, QUERY_CALL (PCO_GetCameraRamSize (priv->pcoHandle, &ram_size, &page_size)) ? FALSE: TRUE);
             }
             break;
 
@@ -994,7 +3837,11 @@ uca_pcowin_camera_get_property (GObject *object, guint property_id, GValue *valu
                 if (!check_camera_type(priv->strCamType.wCamType & 0xFF00, CAMERATYPE_PCO_EDGE)) {
                     // This number is dynamic if the camera is running in recorder mode or in FIFO buffer mode. Result is accurate when recording is stopped
                     guint32 valid_images, max_images;
-                    library_errors = PCO_GetNumberOfImagesInSegment (priv->pcoHandle, priv->active_ram_segment, &valid_images, &max_images);
+                    gboolean is_recording;
+
+                    // Once recording stopped, what can be read out is of interest
+                    g_object_get (object, "is-recording", &is_recording, NULL);
+                    library_errors = QUERY_CALL (PCO_GetNumberOfImagesInSegment (priv->pcoHandle, is_recording ? priv->active_ram_segment : priv->readout_segment, &valid_images, &max_images));
                     g_value_set_uint (value, valid_images);
                 }
             }
@@ -1002,7 +3849,7 @@ uca_pcowin_camera_get_property (GObject *object, guint property_id, GValue *valu
         case PROP_TRIGGER_SOURCE:
             {
                 guint16 trigger_mode;
-                library_errors = PCO_GetTriggerMode (priv->pcoHandle, &trigger_mode);
+                library_errors = QUERY_CALL (PCO_GetTriggerMode (priv->pcoHandle, &trigger_mode));
 
                 switch (trigger_mode) {
                     case TRIGGER_MODE_AUTOTRIGGER:
@@ -1053,31 +3900,250 @@ uca_pcowin_camera_get_property (GObject *object, guint property_id, GValue *valu
         case PROP_IS_RECORDING:
             {
                 guint16 recording_state;
-                library_errors = PCO_GetRecordingState (priv->pcoHandle, &recording_state);
+                library_errors = QUERY_CALL (PCO_GetRecordingState (priv->pcoHandle, &recording_state));
                 g_value_set_boolean (value, recording_state ? TRUE: FALSE);
             }
             break;
+        case PROP_PREVIEW_DECIMATION:
+            g_value_set_uint (value, priv->preview_decimation);
+            break;
+        case PROP_PREVIEW_MAX_FPS:
+            g_value_set_double (value, priv->preview_max_fps);
+            break;
+        case PROP_PREVIEW_DOWNSAMPLING:
+            g_value_set_uint (value, priv->preview_downsampling);
+            break;
+        case PROP_PREVIEW_EIGHT_BIT:
+            g_value_set_boolean (value, priv->preview_eight_bit);
+            break;
+        case PROP_SHARED_MEMORY_NAME:
+            g_value_set_string (value, priv->shm_name);
+            break;
+        case PROP_SHARED_MEMORY_SLOTS:
+            g_value_set_uint (value, priv->shm_slots);
+            break;
+        case PROP_RECORD_FILE:
+            g_value_set_string (value, priv->record_file);
+            break;
+        case PROP_RECORD_BUFFERS:
+            g_value_set_uint (value, priv->record_buffers);
+            break;
+        case PROP_RECORD_THROUGHPUT:
+            g_value_set_double (value, priv->recorder ? uca_pcowin_recorder_get_throughput (priv->recorder) : 0.0);
+            break;
+        case PROP_RECORD_QUEUE_DEPTH:
+            g_value_set_uint (value, priv->recorder ? uca_pcowin_recorder_get_queue_depth (priv->recorder) : 0);
+            break;
+        case PROP_READOUT_DUMP_FILE:
+            g_value_set_string (value, priv->dump_file);
+            break;
+        case PROP_COMPRESSION:
+            g_value_set_boolean (value, priv->compression);
+            break;
+        case PROP_COMPRESSION_THREADS:
+            g_value_set_uint (value, priv->compression_threads);
+            break;
+        case PROP_COMPRESSION_RATIO:
+            g_value_set_double (value, priv->compressor ? uca_pcowin_compressor_get_ratio (priv->compressor) : 0.0);
+            break;
+        case PROP_COMPRESSION_THROUGHPUT:
+            g_value_set_double (value, priv->compressor ? uca_pcowin_compressor_get_throughput (priv->compressor) : 0.0);
+            break;
+        case PROP_COMPRESSION_DROPPED:
+            g_value_set_uint64 (value, priv->compressor ? uca_pcowin_compressor_get_dropped (priv->compressor) : 0);
+            break;
+        case PROP_CAMERA_INDEX:
+            g_value_set_uint (value, priv->camera_index);
+            break;
+        case PROP_DESCRIPTION_CACHE:
+            g_value_set_boolean (value, priv->description_cache);
+            break;
+        case PROP_DESCRIPTION_CACHE_HIT:
+            g_value_set_boolean (value, priv->description_cache_hit);
+            break;
+        case PROP_INIT_TIMINGS:
+            g_value_set_string (value, priv->init_timings->str);
+            break;
+        case PROP_CAMERA_READY:
+            g_mutex_lock (&priv->reconnect_lock);
+            g_value_set_boolean (value, priv->ready);
+            g_mutex_unlock (&priv->reconnect_lock);
+            break;
+        case PROP_RECONNECT_TIMEOUT:
+            g_value_set_uint (value, priv->reconnect_timeout);
+            break;
+        case PROP_RECONNECT_DOWNTIME:
+            g_mutex_lock (&priv->reconnect_lock);
+            g_value_set_double (value, priv->reconnect_downtime);
+            g_mutex_unlock (&priv->reconnect_lock);
+            break;
+        case PROP_SERIAL_NUMBER:
+            g_value_set_uint (value, priv->serial_number);
+            break;
+        case PROP_GRAB_TIMEOUT:
+            g_value_set_uint (value, priv->grab_timeout);
+            break;
+        case PROP_CAMRAM_SEGMENT_SIZES:
+            {
+                guint32 sizes[MAX_RAM_SEGMENTS];
+                GValueArray *array = g_value_array_new (MAX_RAM_SEGMENTS);
+                GValue size = {0};
+
+                library_errors = QUERY_CALL (PCO_GetCameraRamSegmentSize (priv->pcoHandle, sizes));
+                g_value_init (&size, G_TYPE_UINT);
+
+                for (guint i = 0; !library_errors && i < MAX_RAM_SEGMENTS; i++) {
+                    g_value_set_uint (&size, sizes[i]);
+                    g_value_array_append (array, &size);
+                }
+
+                g_value_take_boxed (value, array);
+            }
+            break;
+        case PROP_CAMRAM_ROTATE_SEGMENTS:
+            g_value_set_boolean (value, priv->rotate_segments);
+            break;
+        case PROP_FIFO_BUFFERS:
+            g_value_set_uint (value, priv->fifo_buffers);
+            break;
+        case PROP_FIFO_FILL_LEVEL:
+            g_value_set_double (value, priv->fifo_fill_level);
+            break;
+        case PROP_RECORD_STOP_EVENT:
+            g_value_set_enum (value, priv->record_stop_event);
+            break;
+        case PROP_TRANSFER_SELECTION:
+            g_value_set_enum (value, priv->transfer_selection);
+            break;
+        case PROP_TRANSFER_FORMAT:
+        case PROP_TRANSFER_LUT:
+        case PROP_TRANSFER_CLOCK:
+            {
+                PCO_SC2_CL_TRANSFER_PARAM params;
+                guint16 lut;
+
+                library_errors = get_transfer_parameters (priv, &params, &lut);
+
+                if (library_errors)
+                    break;
+
+                if (property_id == PROP_TRANSFER_LUT)
+                    g_value_set_uint (value, lut);
+                else if (property_id == PROP_TRANSFER_CLOCK)
+                    g_value_set_uint (value, params.ClockFrequency);
+                else {
+                    for (guint i = 0; i < G_N_ELEMENTS (transfer_formats); i++) {
+                        if (transfer_formats[i] == (params.DataFormat & PCO_CL_DATAFORMAT_MASK))
+                            g_value_set_enum (value, i);
+                    }
+                }
+            }
+            break;
+        case PROP_TRANSFER_REPORT:
+            g_value_take_string (value, get_transfer_report (priv));
+            break;
+        case PROP_TRANSFER_DECODE:
+            g_value_set_enum (value, priv->transfer_decode);
+            break;
+        case PROP_DECODE_TABLE_FILE:
+            g_value_set_string (value, priv->decode_table_file);
+            break;
+        case PROP_DECODE_SIMD:
+            g_value_set_boolean (value, uca_pcowin_decoder_has_simd ());
+            break;
+        case PROP_DECODE_THROUGHPUT:
+            {
+                UcaPcowinDecoderStats stats = { 0 };
+
+                if (priv->decoder != NULL)
+                    uca_pcowin_decoder_get_stats (priv->decoder, &stats);
+
+                g_value_set_double (value, stats.throughput / 1e6);
+            }
+            break;
+        case PROP_DECODE_MAX_FPS:
+            g_value_set_double (value, priv->decode_max_fps);
+            break;
+        case PROP_EVENT_PRE_FRAMES:
+            g_value_set_uint (value, priv->event_pre_frames);
+            break;
+        case PROP_EVENT_POST_FRAMES:
+            g_value_set_uint (value, priv->event_post_frames);
+            break;
+        case PROP_READOUT_SEGMENT:
+            g_value_set_uint (value, priv->readout_segment);
+            break;
         default:
             g_warning("Undefined Property");
     }
 
     if (library_errors) {
-        PCO_GetErrorText (library_errors, error_text, ERROR_TEXT_BUFFER_SIZE);
+        PCO_GetErrorText (library_errors, priv->error_text, ERROR_TEXT_BUFFER_SIZE);
         g_warning ("Failed to get property %s. Here's error code 0x%X for enquiring minds.\nSDK Error Text: %s",
-                   pco_properties[property_id]->name, library_errors, error_text);
+                   pco_properties[property_id]->name, library_errors, priv->error_text);
     }
+
+    uca_pcowin_scheduler_finish_read (priv->scheduler, pending, value);
 }
 
+static void close_camera (UcaPcowinCameraPrivate *priv);
+
 static void
 uca_pcowin_camera_finalize(GObject *object)
 {
     UcaPcowinCameraPrivate *priv = UCA_PCOWIN_CAMERA_GET_PRIVATE (object);
 
+    // The reconnect thread holds a reference, so it has reported its outcome by now
+    if (priv->reconnect_thread != NULL) {
+        g_mutex_lock (&priv->reconnect_lock);
+        priv->reconnect_quit = TRUE;
+        g_cond_broadcast (&priv->reconnect_cond);
+        g_mutex_unlock (&priv->reconnect_lock);
+
+        if (g_thread_self () == priv->reconnect_thread)
+            g_thread_unref (priv->reconnect_thread);
+        else
+            g_thread_join (priv->reconnect_thread);
+    }
+
     // Clearing all allocated memories
     if (priv->possible_pixelrates)
         g_value_array_free (priv->possible_pixelrates);
 
-    g_clear_error (&priv->construct_error);
+    g_clear_error (&priv->init_error);
+
+    if (priv->deferred_properties != NULL)
+        g_ptr_array_unref (priv->deferred_properties);
+
+    uca_pcowin_preview_free (priv->preview);
+    uca_pcowin_shm_ring_free (priv->shm_ring);
+    g_free (priv->shm_name);
+    uca_pcowin_recorder_close (priv->recorder, NULL);
+    g_free (priv->record_file);
+    uca_pcowin_dump_close (priv->dump);
+    g_free (priv->dump_file);
+    uca_pcowin_decoder_free (priv->decoder);
+    g_free (priv->decode_table_file);
+    uca_pcowin_compressor_free (priv->compressor);
+    uca_pcowin_trigger_sequence_free (priv->trigger_sequence);
+    uca_pcowin_health_free (priv->health);
+    restore_acquisition_thread (priv);
+    unlock_host_buffers (priv);
+    g_free (priv->exposure_sequence);
+    g_free (priv->delay_sequence);
+
+    if (priv->grab_thread != NULL) {
+        g_async_queue_push (priv->grab_queue, &grab_thread_quit);
+
+        // The last reference may have been dropped by the grab thread itself
+        if (g_thread_self () == priv->grab_thread)
+            g_thread_unref (priv->grab_thread);
+        else
+            g_thread_join (priv->grab_thread);
+    }
+
+    g_async_queue_unref (priv->grab_queue);
+    CloseHandle (priv->cancel_event);
 
     /*
      *  Buffers are allocated during start_recording. So, should be freed at the
@@ -1085,13 +4151,22 @@ uca_pcowin_camera_finalize(GObject *object)
      *  multiple times) Then, only the last buffer is cleared. Though the SDK
      *  handles freeing of buffer. It logs this behaviour as an error.
      */
-    PCO_FreeBuffer (priv->pcoHandle, priv->buffer_number_0);
-    PCO_FreeBuffer (priv->pcoHandle, priv->buffer_number_1);
-    PCO_CloseCamera (priv->pcoHandle);
+    CONTROL_CALL (PCO_FreeBuffer (priv->pcoHandle, priv->buffer_number_0));
+    CONTROL_CALL (PCO_FreeBuffer (priv->pcoHandle, priv->buffer_number_1));
+    close_camera (priv);
+    uca_pcowin_scheduler_free (priv->scheduler);
+    uca_pcowin_arena_free (priv->arena);
+    g_string_free (priv->init_timings, TRUE);
+    g_mutex_clear (&priv->reconnect_lock);
+    g_cond_clear (&priv->reconnect_cond);
+    g_mutex_clear (&priv->grab_lock);
+    g_cond_clear (&priv->grab_cond);
 
     G_OBJECT_CLASS (uca_pcowin_camera_parent_class)->finalize(object);
 }
 
+static gboolean open_and_setup_camera (UcaPcowinCamera *self, GCancellable *cancellable, GError **error);
+
 static gboolean
 uca_pcowin_camera_initable_init (GInitable *initable, GCancellable *cancellable, GError **error)
 {
@@ -1099,17 +4174,23 @@ uca_pcowin_camera_initable_init (GInitable *initable, GCancellable *cancellable,
 
     g_return_val_if_fail (UCA_IS_PCOWIN_CAMERA (initable), FALSE);
 
-    if (cancellable != NULL) {
-        g_set_error_literal (error, G_IO_ERROR, G_IO_ERROR_NOT_SUPPORTED,
-                             "Cancellable initialization not supported");
-        return FALSE;
-    }
-
     priv = UCA_PCOWIN_CAMERA_GET_PRIVATE (UCA_PCOWIN_CAMERA (initable));
 
-    if (priv->construct_error != NULL) {
+    // Repeated calls report the outcome of the first one, a cancelled init may be retried
+    if (!priv->init_done) {
+        if (open_and_setup_camera (UCA_PCOWIN_CAMERA (initable), cancellable, &priv->init_error) ||
+            !g_error_matches (priv->init_error, G_IO_ERROR, G_IO_ERROR_CANCELLED))
+            priv->init_done = TRUE;
+        else {
+            g_propagate_error (error, priv->init_error);
+            priv->init_error = NULL;
+            return FALSE;
+        }
+    }
+
+    if (priv->init_error != NULL) {
         if (error)
-            *error = g_error_copy (priv->construct_error);
+            *error = g_error_copy (priv->init_error);
 
         return FALSE;
     }
@@ -1123,6 +4204,17 @@ uca_pcowin_initable_iface_init (GInitableIface *iface)
     iface->init = uca_pcowin_camera_initable_init;
 }
 
+/*
+ * The default GAsyncInitable implementation runs the GInitable init in a
+ * thread, which is all that is needed because the camera does not touch the
+ * main context while opening. Cameras opened with g_async_initable_new_async()
+ * thus open in parallel.
+ */
+static void
+uca_pcowin_async_initable_iface_init (GAsyncInitableIface *iface)
+{
+}
+
 static void
 uca_pcowin_camera_class_init(UcaPcowinCameraClass *klass)
 {
@@ -1255,81 +4347,728 @@ uca_pcowin_camera_class_init(UcaPcowinCameraClass *klass)
             "Use Global Shutter in pco.edge",
             FALSE, G_PARAM_READWRITE);
 
-    pco_properties[PROP_SENSOR_ADCS] =
-        g_param_spec_uint("sensor-adcs",
-            "Number of ADC to use",
-            "Number of ADC to use",
-            1, 2, 1,
+    pco_properties[PROP_SENSOR_ADCS] =
+        g_param_spec_uint("sensor-adcs",
+            "Number of ADC to use",
+            "Number of ADC to use",
+            1, 2, 1,
+            G_PARAM_READWRITE);
+
+    pco_properties[PROP_SENSOR_MAX_ADCS] =
+        g_param_spec_uint("sensor-max-adcs",
+            "Maximum number of ADC",
+            "Maximum number of ADC that can be set with \"sensor-adcs\"",
+            1, G_MAXUINT, 1,
+            G_PARAM_READABLE);
+
+    pco_properties[PROP_NOISE_FILTER] =
+        g_param_spec_boolean("noise-filter",
+            "Use Noise filter mode of camera",
+            "Use Noise filter mode of camera",
+            FALSE, G_PARAM_READWRITE);
+
+    pco_properties[PROP_HAS_DOUBLE_IMAGE_MODE] =
+        g_param_spec_boolean("has-double-image-mode",
+            "Is double image mode supported by this camera model",
+            "Is double image mode supported by this camera model",
+            FALSE, G_PARAM_READABLE);
+
+    pco_properties[PROP_DOUBLE_IMAGE_MODE] =
+        g_param_spec_boolean("double-image-mode",
+            "Use double image mode",
+            "Use double image mode",
+            FALSE, G_PARAM_READWRITE);
+
+    pco_properties[PROP_PREVIEW_DECIMATION] =
+        g_param_spec_uint("preview-decimation",
+            "Preview decimation",
+            "Pass every n-th grabbed frame to the preview channel, 0 disables the preview",
+            0, G_MAXUINT, 0,
+            G_PARAM_READWRITE);
+
+    pco_properties[PROP_PREVIEW_MAX_FPS] =
+        g_param_spec_double("preview-max-fps",
+            "Maximum preview frame rate",
+            "Maximum frame rate of the preview channel, 0 for no limit",
+            0.0, G_MAXDOUBLE, 0.0,
+            G_PARAM_READWRITE);
+
+    pco_properties[PROP_PREVIEW_DOWNSAMPLING] =
+        g_param_spec_uint("preview-downsampling",
+            "Preview downsampling",
+            "Downsampling factor (1, 2 or 4) of preview frames",
+            1, 4, 1,
+            G_PARAM_READWRITE);
+
+    pco_properties[PROP_PREVIEW_EIGHT_BIT] =
+        g_param_spec_boolean("preview-8bit",
+            "Convert preview frames to 8 bit",
+            "Convert preview frames to 8 bit",
+            FALSE, G_PARAM_READWRITE);
+
+    pco_properties[PROP_SHARED_MEMORY_NAME] =
+        g_param_spec_string("shared-memory-name",
+            "Name of the shared-memory frame ring",
+            "Name of the file mapping that grabbed frames are published to, NULL disables publishing",
+            NULL,
+            G_PARAM_READWRITE);
+
+    pco_properties[PROP_SHARED_MEMORY_SLOTS] =
+        g_param_spec_uint("shared-memory-slots",
+            "Number of frames in the shared-memory ring",
+            "Number of frames in the shared-memory ring",
+            1, G_MAXUINT16, 16,
+            G_PARAM_READWRITE);
+
+    pco_properties[PROP_RECORD_FILE] =
+        g_param_spec_string("record-file",
+            "Raw file that frames are streamed to",
+            "Raw file that frames are streamed to with unbuffered asynchronous writes, an index is written to `record-file'.idx. NULL disables recording",
+            NULL,
+            G_PARAM_READWRITE);
+
+    pco_properties[PROP_RECORD_BUFFERS] =
+        g_param_spec_uint("record-buffers",
+            "Number of staging buffers for disk writes",
+            "Number of staging buffers for disk writes",
+            2, 64, 2,
+            G_PARAM_READWRITE);
+
+    pco_properties[PROP_RECORD_THROUGHPUT] =
+        g_param_spec_double("record-throughput",
+            "Disk write throughput",
+            "Disk write throughput in MB/s",
+            0.0, G_MAXDOUBLE, 0.0,
+            G_PARAM_READABLE);
+
+    pco_properties[PROP_RECORD_QUEUE_DEPTH] =
+        g_param_spec_uint("record-queue-depth",
+            "Pending disk writes",
+            "Number of frames submitted to disk but not yet written",
+            0, G_MAXUINT, 0,
+            G_PARAM_READABLE);
+
+    pco_properties[PROP_READOUT_DUMP_FILE] =
+        g_param_spec_string("readout-dump-file",
+            "File the camRAM segment is dumped to",
+            "File that start_readout dumps the whole camRAM segment to before serving frames from it, NULL reads directly from the camera",
+            NULL,
+            G_PARAM_READWRITE);
+
+    pco_properties[PROP_COMPRESSION] =
+        g_param_spec_boolean("compression",
+            "Compress delivered frames",
+            "Bit-shuffle and LZ4 compress every delivered frame on a thread pool, collect them with uca_pcowin_camera_pop_compressed_frame",
+            FALSE,
+            G_PARAM_READWRITE);
+
+    pco_properties[PROP_COMPRESSION_THREADS] =
+        g_param_spec_uint("compression-threads",
+            "Number of compression threads",
+            "Number of compression threads, 0 uses one per processor",
+            0, 256, 0,
+            G_PARAM_READWRITE);
+
+    pco_properties[PROP_COMPRESSION_RATIO] =
+        g_param_spec_double("compression-ratio",
+            "Achieved compression ratio",
+            "Raw size divided by compressed size of all frames compressed so far",
+            0.0, G_MAXDOUBLE, 0.0,
+            G_PARAM_READABLE);
+
+    pco_properties[PROP_COMPRESSION_THROUGHPUT] =
+        g_param_spec_double("compression-throughput",
+            "Compression throughput",
+            "Compression throughput in MB/s of raw data",
+            0.0, G_MAXDOUBLE, 0.0,
+            G_PARAM_READABLE);
+
+    pco_properties[PROP_COMPRESSION_DROPPED] =
+        g_param_spec_uint64("compression-dropped",
+            "Frames dropped by the compression stage",
+            "Frames that were not compressed because too many compressed frames were not collected",
+            0, G_MAXUINT64, 0,
+            G_PARAM_READABLE);
+
+    pco_properties[PROP_DESCRIPTION_CACHE] =
+        g_param_spec_boolean("description-cache",
+            "Cache the camera description on disk",
+            "Load the static camera description from a cache keyed by serial number, firmware and shutter mode instead of querying it",
+            TRUE, G_PARAM_READWRITE | G_PARAM_CONSTRUCT_ONLY);
+
+    pco_properties[PROP_DESCRIPTION_CACHE_HIT] =
+        g_param_spec_boolean("description-cache-hit",
+            "Description was loaded from cache",
+            "Description was loaded from cache",
+            FALSE, G_PARAM_READABLE);
+
+    pco_properties[PROP_INIT_TIMINGS] =
+        g_param_spec_string("init-timings",
+            "Duration of the initialization steps",
+            "Duration of the initialization steps as space separated step=time pairs",
+            "", G_PARAM_READABLE);
+
+    pco_properties[PROP_CAMERA_READY] =
+        g_param_spec_boolean("camera-ready",
+            "Camera is open and usable",
+            "Camera is open and usable, FALSE while it reboots after changing global-shutter",
+            FALSE, G_PARAM_READABLE);
+
+    pco_properties[PROP_RECONNECT_TIMEOUT] =
+        g_param_spec_uint("reconnect-timeout",
+            "Time to wait for the camera after a reboot",
+            "Time in milliseconds to wait for the camera after a reboot before giving up",
+            1000, G_MAXUINT, 60000,
+            G_PARAM_READWRITE);
+
+    pco_properties[PROP_RECONNECT_DOWNTIME] =
+        g_param_spec_double("reconnect-downtime",
+            "Duration of the last reboot",
+            "Time in seconds from the last reboot until the camera was usable again",
+            0.0, G_MAXDOUBLE, 0.0,
+            G_PARAM_READABLE);
+
+    pco_properties[PROP_CAMERA_INDEX] =
+        g_param_spec_uint("camera-index",
+            "Index of the camera to open",
+            "Index of the camera to open among all cameras found on all interfaces, ignored if serial-number is set",
+            0, MAX_CAMERAS - 1, 0,
+            G_PARAM_READWRITE | G_PARAM_CONSTRUCT_ONLY);
+
+    pco_properties[PROP_SERIAL_NUMBER] =
+        g_param_spec_uint("serial-number",
+            "Serial number of the camera to open",
+            "Serial number of the camera to open, 0 opens the camera at camera-index",
+            0, G_MAXUINT32, 0,
+            G_PARAM_READWRITE | G_PARAM_CONSTRUCT_ONLY);
+
+    pco_properties[PROP_GRAB_TIMEOUT] =
+        g_param_spec_uint("grab-timeout",
+            "Time to wait for a frame in ms",
+            "Time to wait for a frame in ms, 0 only takes a frame that is already there, G_MAXUINT waits forever",
+            0, G_MAXUINT, 1000,
+            G_PARAM_READWRITE);
+
+    pco_properties[PROP_CAMRAM_SEGMENT_SIZES] =
+        g_param_spec_value_array("camram-segment-sizes",
+            "Sizes of the camRAM segments in pages",
+            "Sizes of up to four camRAM segments in pages, setting them clears the whole camRAM",
+            g_param_spec_uint("camram-segment-size",
+                "Size of a camRAM segment in pages",
+                "Size of a camRAM segment in pages",
+                0, G_MAXUINT32, 0,
+                G_PARAM_READWRITE),
+            G_PARAM_READWRITE);
+
+    pco_properties[PROP_CAMRAM_ROTATE_SEGMENTS] =
+        g_param_spec_boolean("camram-rotate-segments",
+            "Record every burst into the next segment",
+            "Record every burst into the next non-empty camRAM segment so that the previous one can be read out meanwhile",
+            FALSE,
+            G_PARAM_READWRITE);
+
+    pco_properties[PROP_READOUT_SEGMENT] =
+        g_param_spec_uint("readout-segment",
+            "camRAM segment that is read out",
+            "camRAM segment that readout and start_readout use, set to the recorded segment when recording stops",
+            1, MAX_RAM_SEGMENTS, 1,
+            G_PARAM_READWRITE);
+
+    pco_properties[PROP_FIFO_BUFFERS] =
+        g_param_spec_uint("fifo-buffers",
+            "Number of buffers queued in FIFO storage mode",
+            "Number of driver buffers queued at once while streaming in FIFO storage mode",
+            1, MAX_STREAM_BUFFERS, 4,
+            G_PARAM_READWRITE);
+
+    pco_properties[PROP_FIFO_FILL_LEVEL] =
+        g_param_spec_double("fifo-fill-level",
+            "Fill level of the camRAM FIFO",
+            "Fraction of the camRAM FIFO that was occupied at the last check while streaming",
+            0.0, 1.0, 0.0,
+            G_PARAM_READABLE);
+
+    pco_properties[PROP_ACQUISITION_CPU_MASK] =
+        g_param_spec_uint64("acquisition-cpu-mask",
+            "CPUs the grabbing thread is pinned to",
+            "Affinity mask of the thread that grabs frames, 0 leaves it unchanged",
+            0, G_MAXUINT64, 0,
+            G_PARAM_READWRITE);
+
+    pco_properties[PROP_ACQUISITION_PRIORITY] =
+        g_param_spec_enum("acquisition-priority",
+            "Scheduling priority of the grabbing thread",
+            "Scheduling priority of the thread that grabs frames",
+            UCA_TYPE_PCO_CAMERA_THREAD_PRIORITY, UCA_PCO_CAMERA_THREAD_PRIORITY_UNCHANGED,
+            G_PARAM_READWRITE);
+
+    pco_properties[PROP_LOCK_BUFFERS] =
+        g_param_spec_boolean("lock-buffers",
+            "Pre-fault and lock frame buffers",
+            "Pre-fault the host frame buffers and lock them into memory while recording",
+            FALSE, G_PARAM_READWRITE);
+
+    pco_properties[PROP_ACQUISITION_CPU_MASK_APPLIED] =
+        g_param_spec_uint64("acquisition-cpu-mask-applied",
+            "CPU mask applied to the grabbing thread",
+            "CPU mask applied to the grabbing thread, 0 if unchanged",
+            0, G_MAXUINT64, 0,
+            G_PARAM_READABLE);
+
+    pco_properties[PROP_ACQUISITION_PRIORITY_APPLIED] =
+        g_param_spec_enum("acquisition-priority-applied",
+            "Priority granted to the grabbing thread",
+            "Priority granted to the grabbing thread",
+            UCA_TYPE_PCO_CAMERA_THREAD_PRIORITY, UCA_PCO_CAMERA_THREAD_PRIORITY_UNCHANGED,
+            G_PARAM_READABLE);
+
+    pco_properties[PROP_LOCKED_BUFFER_SIZE] =
+        g_param_spec_uint64("locked-buffer-size",
+            "Bytes of frame buffers locked in memory",
+            "Bytes of frame buffers locked in memory",
+            0, G_MAXUINT64, 0,
+            G_PARAM_READABLE);
+
+    pco_properties[PROP_BUFFER_ALLOCATION] =
+        g_param_spec_enum("buffer-allocation",
+            "Allocation of the host image buffers",
+            "Whether the SDK allocates the host image buffers or they come from a NUMA local arena, optionally on large pages",
+            UCA_TYPE_PCO_CAMERA_BUFFER_ALLOCATION, UCA_PCO_CAMERA_BUFFER_ALLOCATION_SDK,
+            G_PARAM_READWRITE);
+
+    pco_properties[PROP_BUFFER_PAGE_SIZE] =
+        g_param_spec_uint64("buffer-page-size",
+            "Page size of the image buffer arena",
+            "Page size of the image buffer arena in bytes, 0 if the SDK allocates",
+            0, G_MAXUINT64, 0,
+            G_PARAM_READABLE);
+
+    pco_properties[PROP_BUFFER_PAGES] =
+        g_param_spec_uint64("buffer-pages",
+            "Pages held by the image buffer arena",
+            "Pages held by the image buffer arena",
+            0, G_MAXUINT64, 0,
+            G_PARAM_READABLE);
+
+    pco_properties[PROP_BUFFER_NUMA_NODE] =
+        g_param_spec_int("buffer-numa-node",
+            "NUMA node of the image buffer arena",
+            "NUMA node of the image buffer arena, -1 if not bound",
+            -1, G_MAXINT, -1,
+            G_PARAM_READABLE);
+
+    pco_properties[PROP_HEALTH_MONITOR] =
+        g_param_spec_boolean("health-monitor",
+            "Poll temperatures and health status in the background",
+            "Poll temperatures and health status in the background and serve them from cache",
+            TRUE, G_PARAM_READWRITE);
+
+    pco_properties[PROP_HEALTH_POLL_INTERVAL] =
+        g_param_spec_uint("health-poll-interval",
+            "Health poll interval in ms",
+            "Health poll interval in ms while not recording",
+            1, G_MAXUINT, 2000,
+            G_PARAM_READWRITE);
+
+    pco_properties[PROP_HEALTH_POLL_INTERVAL_RECORDING] =
+        g_param_spec_uint("health-poll-interval-recording",
+            "Health poll interval in ms while recording",
+            "Health poll interval in ms while recording, 0 suspends polling",
+            0, G_MAXUINT, 30000,
+            G_PARAM_READWRITE);
+
+    pco_properties[PROP_CAMERA_TEMPERATURE] =
+        g_param_spec_double("camera-temperature",
+            "Temperature of the camera electronics",
+            "Temperature of the camera electronics in degree Celsius",
+            -G_MAXDOUBLE, G_MAXDOUBLE, 0.0,
+            G_PARAM_READABLE);
+
+    pco_properties[PROP_POWER_SUPPLY_TEMPERATURE] =
+        g_param_spec_double("power-supply-temperature",
+            "Temperature of the power supply",
+            "Temperature of the power supply in degree Celsius",
+            -G_MAXDOUBLE, G_MAXDOUBLE, 0.0,
+            G_PARAM_READABLE);
+
+    pco_properties[PROP_HEALTH_WARNINGS] =
+        g_param_spec_uint("health-warnings",
+            "Camera health warning bits",
+            "Camera health warning bits",
+            0, G_MAXUINT32, 0,
+            G_PARAM_READABLE);
+
+    pco_properties[PROP_HEALTH_ERRORS] =
+        g_param_spec_uint("health-errors",
+            "Camera health error bits",
+            "Camera health error bits",
+            0, G_MAXUINT32, 0,
+            G_PARAM_READABLE);
+
+    pco_properties[PROP_HEALTH_STATUS] =
+        g_param_spec_uint("health-status",
+            "Camera status bits",
+            "Camera status bits",
+            0, G_MAXUINT32, 0,
+            G_PARAM_READABLE);
+
+    pco_properties[PROP_TRANSFER_SELECTION] =
+        g_param_spec_enum("transfer-selection",
+            "How CameraLink transfer parameters are chosen",
+            "How CameraLink transfer parameters are chosen when recording starts, fastest picks the mode with the highest achievable frame rate for the ROI and pixel rate",
+            UCA_TYPE_PCO_CAMERA_TRANSFER_SELECTION, UCA_PCO_CAMERA_TRANSFER_SELECTION_DEFAULT,
+            G_PARAM_READWRITE);
+
+    pco_properties[PROP_TRANSFER_FORMAT] =
+        g_param_spec_enum("transfer-format",
+            "CameraLink data format",
+            "CameraLink data format, setting it selects manual transfer parameters",
+            UCA_TYPE_PCO_CAMERA_TRANSFER_FORMAT, UCA_PCO_CAMERA_TRANSFER_FORMAT_5X16,
+            G_PARAM_READWRITE);
+
+    pco_properties[PROP_TRANSFER_LUT] =
+        g_param_spec_uint("transfer-lut",
+            "Identifier of the active lookup table",
+            "Identifier of the lookup table applied before transfer, 0 sends pixels unchanged. Setting it selects manual transfer parameters",
+            0, G_MAXUINT16, 0,
+            G_PARAM_READWRITE);
+
+    pco_properties[PROP_TRANSFER_CLOCK] =
+        g_param_spec_uint("transfer-clock",
+            "CameraLink clock frequency",
+            "CameraLink clock frequency in Hz, setting it selects manual transfer parameters",
+            0, G_MAXUINT, 0,
             G_PARAM_READWRITE);
 
-    pco_properties[PROP_SENSOR_MAX_ADCS] =
-        g_param_spec_uint("sensor-max-adcs",
-            "Maximum number of ADC",
-            "Maximum number of ADC that can be set with \"sensor-adcs\"",
-            1, G_MAXUINT, 1,
-            G_PARAM_READABLE);
+    pco_properties[PROP_TRANSFER_REPORT] =
+        g_param_spec_string("transfer-report",
+            "Frame rate of each transfer mode",
+            "One line per supported transfer mode with the frame rate of the link and the frame rate achievable with the armed sensor settings",
+            "", G_PARAM_READABLE);
+
+    pco_properties[PROP_TRANSFER_DECODE] =
+        g_param_spec_enum("transfer-decode",
+            "Where LUT compressed transfers are expanded",
+            "Where LUT compressed transfers are expanded: by the SDK, on the host while frames are delivered, or not at all so that frames carry the LUT codes",
+            UCA_TYPE_PCO_CAMERA_TRANSFER_DECODE, UCA_PCO_CAMERA_TRANSFER_DECODE_SDK,
+            G_PARAM_READWRITE);
 
-    pco_properties[PROP_NOISE_FILTER] =
-        g_param_spec_boolean("noise-filter",
-            "Use Noise filter mode of camera",
-            "Use Noise filter mode of camera",
-            FALSE, G_PARAM_READWRITE);
+    pco_properties[PROP_DECODE_TABLE_FILE] =
+        g_param_spec_string("decode-table-file",
+            "Expansion table for host decoding",
+            "File with one little endian 16 bit value per LUT code, the inverse square root law is used if not set",
+            NULL, G_PARAM_READWRITE);
 
-    pco_properties[PROP_HAS_DOUBLE_IMAGE_MODE] =
-        g_param_spec_boolean("has-double-image-mode",
-            "Is double image mode supported by this camera model",
-            "Is double image mode supported by this camera model",
+    pco_properties[PROP_DECODE_SIMD] =
+        g_param_spec_boolean("decode-simd",
+            "Host decoding uses AVX2",
+            "Host decoding uses AVX2",
             FALSE, G_PARAM_READABLE);
 
-    pco_properties[PROP_DOUBLE_IMAGE_MODE] =
-        g_param_spec_boolean("double-image-mode",
-            "Use double image mode",
-            "Use double image mode",
-            FALSE, G_PARAM_READWRITE);
+    pco_properties[PROP_DECODE_THROUGHPUT] =
+        g_param_spec_double("decode-throughput",
+            "Host decoding throughput",
+            "Host decoding throughput in megapixels per second of decoding time during the current recording",
+            0.0, G_MAXDOUBLE, 0.0,
+            G_PARAM_READABLE);
+
+    pco_properties[PROP_DECODE_MAX_FPS] =
+        g_param_spec_double("decode-max-fps",
+            "Frame rate host decoding sustains",
+            "Frame rate host decoding sustained in the benchmark when recording started",
+            0.0, G_MAXDOUBLE, 0.0,
+            G_PARAM_READABLE);
+
+    pco_properties[PROP_RECORD_STOP_EVENT] =
+        g_param_spec_enum("record-stop-event",
+            "Event that stops a ring buffer recording",
+            "Event after which the camera records event-post-frames more frames and stops",
+            UCA_TYPE_PCO_CAMERA_RECORD_STOP_EVENT, UCA_PCO_CAMERA_RECORD_STOP_EVENT_NONE,
+            G_PARAM_READWRITE);
+
+    pco_properties[PROP_EVENT_PRE_FRAMES] =
+        g_param_spec_uint("event-pre-frames",
+            "Frames read out before the stop event",
+            "Frames read out before the stop event",
+            0, G_MAXUINT32, 0,
+            G_PARAM_READWRITE);
+
+    pco_properties[PROP_EVENT_POST_FRAMES] =
+        g_param_spec_uint("event-post-frames",
+            "Frames recorded after the stop event",
+            "Frames recorded after the stop event",
+            0, G_MAXUINT32, 0,
+            G_PARAM_READWRITE);
 
     for (guint id = N_BASE_PROPERTIES; id < N_PROPERTIES; id++)
         g_object_class_install_property (gobject_class, id, pco_properties[id]);
 
+    /**
+     * UcaPcowinCamera::health-changed:
+     * @camera: The camera
+     * @warnings: Health warning bits
+     * @errors: Health error bits
+     * @status: Camera status bits
+     *
+     * Emitted when the health warning or error bits change. The signal is
+     * usually emitted from the monitor thread.
+     */
+    pco_signals[HEALTH_CHANGED] =
+        g_signal_new ("health-changed",
+                      G_OBJECT_CLASS_TYPE (gobject_class),
+                      G_SIGNAL_RUN_LAST,
+                      0, NULL, NULL,
+                      g_cclosure_marshal_generic,
+                      G_TYPE_NONE, 3, G_TYPE_UINT, G_TYPE_UINT, G_TYPE_UINT);
+
+    /**
+     * UcaPcowinCamera::reconnected:
+     * @camera: The camera
+     * @success: %TRUE if the camera is usable again
+     * @downtime: Seconds since the reboot
+     *
+     * Emitted from a background thread when the camera was reopened after
+     * changing "global-shutter" rebooted it, or when it did not come back
+     * within "reconnect-timeout".
+     */
+    pco_signals[RECONNECTED] =
+        g_signal_new ("reconnected",
+                      G_OBJECT_CLASS_TYPE (gobject_class),
+                      G_SIGNAL_RUN_LAST,
+                      0, NULL, NULL,
+                      g_cclosure_marshal_generic,
+                      G_TYPE_NONE, 2, G_TYPE_BOOLEAN, G_TYPE_DOUBLE);
+
     g_type_class_add_private (klass, sizeof (UcaPcowinCameraPrivate));
 }
 
-static void
-property_override_default_guint_value (GObjectClass *oclass, const gchar *property_name, guint new_default)
+static GValueArray *
+new_pixelrate_array (const PCO_Description *description)
 {
-    GParamSpecUInt *pspec = G_PARAM_SPEC_UINT (g_object_class_find_property (oclass, property_name));
+    GValueArray *pixelrates;
+    GValue temporary = {0};
 
-    if (pspec != NULL)
-        pspec->default_value = new_default;
-    else
-        g_warning ("pspec for %s not found\n", property_name);
+    g_value_init (&temporary, G_TYPE_UINT);
+    pixelrates = g_value_array_new (4);
+
+    for (int i = 0; i < 4; i++) {
+        g_value_set_uint (&temporary, (guint) description->dwPixelRateDESC[i]);
+        g_value_array_append (pixelrates, &temporary);
+    }
+
+    return pixelrates;
 }
 
 static void
 set_default_properties(UcaPcowinCamera *camera)
 {
     UcaPcowinCameraPrivate *priv;
-    GObjectClass *oclass;
 
     priv = UCA_PCOWIN_CAMERA_GET_PRIVATE (camera);
-    oclass = G_OBJECT_CLASS (UCA_PCOWIN_CAMERA_GET_CLASS (camera));
 
     // Get possible pixel rates from PCO Description and set default pixelrate
-    GValue temporary = {0};
-    g_value_init (&temporary, G_TYPE_UINT);
-    priv->possible_pixelrates = g_value_array_new (4);
+    priv->possible_pixelrates = new_pixelrate_array (&priv->strDescription);
+    priv->default_pixelrate = priv->strDescription.dwPixelRateDESC[0];
+}
 
-    for (int i = 0; i < 4; i++) {
-        g_value_set_uint (&temporary, (guint) priv->strDescription.dwPixelRateDESC[i]);
-        g_value_array_append (priv->possible_pixelrates, &temporary);
+static void
+record_init_step (UcaPcowinCameraPrivate *priv, const gchar *step)
+{
+    gint64 now = g_get_monotonic_time ();
+
+    g_string_append_printf (priv->init_timings, "%s%s=%.1fms",
+                            priv->init_timings->len > 0 ? " " : "", step, (now - priv->init_step_start) / 1000.0);
+    priv->init_step_start = now;
+}
+
+/*
+ * Indices held by cameras of this process. Instances initialized in parallel
+ * skip each other's cameras while scanning for a serial number instead of
+ * opening them a second time.
+ */
+G_LOCK_DEFINE_STATIC (open_cameras);
+static guint32 open_camera_mask = 0;
+
+static gint
+open_camera_at_index (UcaPcowinCameraPrivate *priv, guint index)
+{
+    PCO_OpenStruct open_params;
+
+    memset (&open_params, 0, sizeof (open_params));
+    open_params.wSize = sizeof (open_params);
+    open_params.wInterfaceType = 0xFFFF;    // Scan all interfaces
+    open_params.wCameraNumber = index;
+    priv->pcoHandle = NULL;
+
+    return CONTROL_CALL (PCO_OpenCameraEx (&priv->pcoHandle, &open_params));
+}
+
+static void
+close_camera (UcaPcowinCameraPrivate *priv)
+{
+    if (priv->pcoHandle == NULL)
+        return;
+
+    CONTROL_CALL (PCO_CloseCamera (priv->pcoHandle));
+    priv->pcoHandle = NULL;
+
+    G_LOCK (open_cameras);
+    open_camera_mask &= ~(1u << priv->camera_index);
+    G_UNLOCK (open_cameras);
+}
+
+/*
+ * Whether @error means that there is no camera at an index, as opposed to a
+ * camera that failed to open. The device that reported it is ignored.
+ */
+static gboolean
+is_no_camera_error (gint error)
+{
+    const guint32 mask = PCO_ERROR_LAYER_MASK | PCO_ERROR_CODE_MASK;
+    guint32 code = (guint32) error & mask;
+
+    return code == (PCO_ERROR_DRIVER_NOTINIT & mask) || code == (PCO_ERROR_DRIVER_NODRIVER & mask);
+}
+
+/*
+ * Opens the camera selected by "serial-number" or, if that is not set, by
+ * "camera-index" and fills in the camera type.
+ */
+static gint
+open_camera (UcaPcowinCameraPrivate *priv, GCancellable *cancellable)
+{
+    gint error;
+
+    if (priv->serial_number == 0) {
+        G_LOCK (open_cameras);
+
+        if (open_camera_mask & (1u << priv->camera_index)) {
+            G_UNLOCK (open_cameras);
+            g_warning ("Camera %u is already open in this process", priv->camera_index);
+            return PCO_ERROR_DRIVER_NODRIVER;
+        }
+
+        error = open_camera_at_index (priv, priv->camera_index);
+
+        if (error == PCO_NOERROR)
+            open_camera_mask |= 1u << priv->camera_index;
+
+        G_UNLOCK (open_cameras);
+
+        if (error != PCO_NOERROR)
+            return error;
+
+        error = QUERY_CALL (PCO_GetCameraType (priv->pcoHandle, &priv->strCamType));
+        priv->serial_number = priv->strCamType.dwSerialNumber;
+        return error;
+    }
+
+    for (guint index = 0; index < MAX_CAMERAS; index++) {
+        gboolean match;
+
+        if (g_cancellable_is_cancelled (cancellable))
+            return PCO_NOERROR;
+
+        // The lock is held per index only, so that parallel scans interleave
+        G_LOCK (open_cameras);
+
+        if (open_camera_mask & (1u << index)) {
+            G_UNLOCK (open_cameras);
+            continue;
+        }
+
+        error = open_camera_at_index (priv, index);
+
+        /*
+         * Cameras are numbered consecutively, so the first index without a
+         * camera ends the scan. A camera that fails to open, e.g. because
+         * another process holds it, is skipped.
+         */
+        if (error != PCO_NOERROR) {
+            G_UNLOCK (open_cameras);
+
+            if (is_no_camera_error (error))
+                break;
+
+            continue;
+        }
+
+        error = QUERY_CALL (PCO_GetCameraType (priv->pcoHandle, &priv->strCamType));
+        match = error == PCO_NOERROR && priv->strCamType.dwSerialNumber == priv->serial_number;
+
+        if (match)
+            open_camera_mask |= 1u << index;
+        else {
+            CONTROL_CALL (PCO_CloseCamera (priv->pcoHandle));
+            priv->pcoHandle = NULL;
+        }
+
+        G_UNLOCK (open_cameras);
+
+        if (match) {
+            priv->camera_index = index;
+            return PCO_NOERROR;
+        }
+    }
+
+    // No camera with that serial number
+    return PCO_ERROR_DRIVER_NODRIVER;
+}
+
+/*
+ * Fills in @description, from the cache if there is one for the serial
+ * number, firmware and, on the pco.edge, the shutter mode. The reconnect
+ * thread passes its own copy, which it swaps in under the reconnect lock.
+ */
+static gint
+read_camera_description (UcaPcowinCameraPrivate *priv, PCO_Description *description)
+{
+    int library_errors;
+
+    priv->camera_setup = 0;
+
+    if (check_camera_type (priv->strCamType.wCamType & 0xFF00, CAMERATYPE_PCO_EDGE)) {
+        guint16 setup_type, valid_setups = 2;
+        guint32 setup[2];
+
+        if (QUERY_CALL (PCO_GetCameraSetup (priv->pcoHandle, &setup_type, &setup[0], &valid_setups)) == PCO_NOERROR)
+            priv->camera_setup = setup[0];
+    }
+
+    priv->description_cache_hit = priv->description_cache &&
+        uca_pcowin_description_cache_load (&priv->strCamType, priv->camera_setup, description, &priv->strSensor, &priv->strStorage);
+
+    if (priv->description_cache_hit) {
+        priv->strGeneral.strCamType = priv->strCamType;
+        return PCO_NOERROR;
+    }
+
+    library_errors = QUERY_CALL (PCO_GetGeneral (priv->pcoHandle, &priv->strGeneral));
+    CHECK_FOR_PCO_SDK_ERROR_DURING_SETUP (library_errors);
+
+    library_errors = QUERY_CALL (PCO_GetSensorStruct (priv->pcoHandle, &priv->strSensor));
+    CHECK_FOR_PCO_SDK_ERROR_DURING_SETUP (library_errors);
+
+    library_errors = QUERY_CALL (PCO_GetCameraDescription (priv->pcoHandle, description));
+    CHECK_FOR_PCO_SDK_ERROR_DURING_SETUP (library_errors);
+
+    library_errors = QUERY_CALL (PCO_GetStorageStruct (priv->pcoHandle, &priv->strStorage));
+    CHECK_FOR_PCO_SDK_ERROR_DURING_SETUP (library_errors);
+
+    if (priv->description_cache) {
+        GError *cache_error = NULL;
+
+        if (!uca_pcowin_description_cache_save (&priv->strCamType, priv->camera_setup, description, &priv->strSensor, &priv->strStorage, &cache_error)) {
+            g_warning ("Could not write description cache: %s", cache_error->message);
+            g_error_free (cache_error);
+        }
     }
 
-    property_override_default_guint_value (oclass, "sensor-pixelrate", priv->strDescription.dwPixelRateDESC[0]);
-    property_override_default_guint_value (oclass, "roi-width", priv->width);
-    property_override_default_guint_value (oclass, "roi-height", priv->height);
+    return PCO_NOERROR;
 }
 
 static gint
-setupsdk_and_opencamera (UcaPcowinCameraPrivate *priv, UcaPcowinCamera *camera)
+setupsdk_and_opencamera (UcaPcowinCameraPrivate *priv, UcaPcowinCamera *camera, GCancellable *cancellable)
 {
     gint error;
     guint16 roi[4];
@@ -1344,29 +5083,25 @@ setupsdk_and_opencamera (UcaPcowinCameraPrivate *priv, UcaPcowinCamera *camera)
     priv->strDescription.wSize = sizeof (priv->strDescription);
     priv->strStorage.wSize = sizeof (priv->strStorage);
 
+    priv->init_step_start = g_get_monotonic_time ();
+    g_string_truncate (priv->init_timings, 0);
+
     // 0 - Success, ~0 - Error or warning
-    error = PCO_OpenCamera (&priv->pcoHandle, 0);
+    error = open_camera (priv, cancellable);
+    record_init_step (priv, "open");
 
-    if (error != PCO_NOERROR)
+    if (error != PCO_NOERROR || g_cancellable_is_cancelled (cancellable))
         return error;
 
-    library_errors = PCO_GetGeneral (priv->pcoHandle, &priv->strGeneral);
-    CHECK_FOR_PCO_SDK_ERROR_DURING_SETUP (library_errors);
-
-    library_errors = PCO_GetCameraType (priv->pcoHandle, &priv->strCamType);
-    CHECK_FOR_PCO_SDK_ERROR_DURING_SETUP (library_errors);
-
-    library_errors = PCO_GetSensorStruct (priv->pcoHandle, &priv->strSensor);
-    CHECK_FOR_PCO_SDK_ERROR_DURING_SETUP (library_errors);
-
-    library_errors = PCO_GetCameraDescription (priv->pcoHandle, &priv->strDescription);
+    library_errors = read_camera_description (priv, &priv->strDescription);
+    record_init_step (priv, priv->description_cache_hit ? "description-cache" : "description");
     CHECK_FOR_PCO_SDK_ERROR_DURING_SETUP (library_errors);
 
-    library_errors = PCO_GetStorageStruct (priv->pcoHandle, &priv->strStorage);
-    CHECK_FOR_PCO_SDK_ERROR_DURING_SETUP (library_errors);
+    if (g_cancellable_is_cancelled (cancellable))
+        return PCO_NOERROR;
 
     // UcaCamera variables are filled with initial values from camera description or sensor
-    library_errors = PCO_GetROI (priv->pcoHandle, &roi[0], &roi[1], &roi[2], &roi[3]);
+    library_errors = QUERY_CALL (PCO_GetROI (priv->pcoHandle, &roi[0], &roi[1], &roi[2], &roi[3]));
     CHECK_FOR_PCO_SDK_ERROR_DURING_SETUP (library_errors);
     priv->roi_x = roi[0] - 1;
     priv->roi_y = roi[1] - 1;
@@ -1381,14 +5116,180 @@ setupsdk_and_opencamera (UcaPcowinCameraPrivate *priv, UcaPcowinCamera *camera)
     priv->height_ex = priv->strDescription.wMaxVertResExtDESC;
     priv->bit_per_pixel = priv->strDescription.wDynResDESC;
 
-    library_errors = PCO_GetBinning (priv->pcoHandle, &priv->horizontal_binning, &priv->vertical_binning);
+    library_errors = QUERY_CALL (PCO_GetBinning (priv->pcoHandle, &priv->horizontal_binning, &priv->vertical_binning));
     CHECK_FOR_PCO_SDK_ERROR_DURING_SETUP (library_errors);
 
-    PCO_GetActiveRamSegment (priv->pcoHandle, &priv->active_ram_segment);
+    QUERY_CALL (PCO_GetActiveRamSegment (priv->pcoHandle, &priv->active_ram_segment));
+    priv->readout_segment = priv->active_ram_segment;
+    record_init_step (priv, "settings");
 
     return library_errors;
 }
 
+static void
+set_ready (UcaPcowinCamera *camera, gboolean ready, gboolean reconnecting)
+{
+    UcaPcowinCameraPrivate *priv;
+
+    priv = UCA_PCOWIN_CAMERA_GET_PRIVATE (camera);
+
+    g_mutex_lock (&priv->reconnect_lock);
+    priv->ready = ready;
+    priv->reconnecting = reconnecting;
+    g_cond_broadcast (&priv->reconnect_cond);
+    g_mutex_unlock (&priv->reconnect_lock);
+
+    g_object_notify_by_pspec (G_OBJECT (camera), pco_properties[PROP_CAMERA_READY]);
+}
+
+/*
+ * Rereads the description, which differs between the shutter modes, and
+ * restores what the reboot reset. Failing to restore a setting is only
+ * warned about, the camera is usable nonetheless.
+ */
+static gint
+restore_camera (UcaPcowinCameraPrivate *priv)
+{
+    GError *error = NULL;
+    PCO_Description description;
+    GValueArray *pixelrates, *old_pixelrates;
+    guint16 framerate_status = 0;
+    guint16 mode_exposure_has_priority = 0x0002;
+    int library_errors;
+
+    memset (&description, 0, sizeof (description));
+    description.wSize = sizeof (description);
+    library_errors = read_camera_description (priv, &description);
+
+    if (library_errors != PCO_NOERROR)
+        return library_errors;
+
+    // Getters may still copy the old pixel rates, so they are only swapped under the lock
+    pixelrates = new_pixelrate_array (&description);
+
+    g_mutex_lock (&priv->reconnect_lock);
+    priv->strDescription = description;
+    priv->width = description.wMaxHorzResStdDESC;
+    priv->height = description.wMaxVertResStdDESC;
+    priv->width_ex = description.wMaxHorzResExtDESC;
+    priv->height_ex = description.wMaxVertResExtDESC;
+    priv->default_pixelrate = description.dwPixelRateDESC[0];
+    old_pixelrates = priv->possible_pixelrates;
+    priv->possible_pixelrates = pixelrates;
+    g_mutex_unlock (&priv->reconnect_lock);
+
+    g_value_array_free (old_pixelrates);
+
+    guint16 roi[4] = { priv->roi_x + 1, priv->roi_y + 1, priv->roi_x + priv->roi_width, priv->roi_y + priv->roi_height };
+
+    if (CONTROL_CALL (PCO_SetBinning (priv->pcoHandle, priv->horizontal_binning, priv->vertical_binning)) != PCO_NOERROR ||
+        CONTROL_CALL (PCO_SetROI (priv->pcoHandle, roi[0], roi[1], roi[2], roi[3])) != PCO_NOERROR)
+        g_warning ("Could not restore ROI and binning after reboot");
+
+    if (CONTROL_CALL (PCO_SetFrameRate (priv->pcoHandle, &framerate_status, mode_exposure_has_priority, &priv->saved_framerate, &priv->saved_exposure)) != PCO_NOERROR)
+        g_warning ("Could not restore exposure time after reboot");
+
+    uca_pcowin_health_set_handle (priv->health, priv->pcoHandle);
+
+    if (priv->health_monitor && !uca_pcowin_health_start (priv->health, &error)) {
+        g_warning ("Could not restart health monitor: %s", error->message);
+        g_error_free (error);
+    }
+
+    return PCO_NOERROR;
+}
+
+/*
+ * Polls for the rebooted camera with exponential backoff. The camera keeps
+ * its serial number but may come back at another index, so it is looked up
+ * by serial number.
+ */
+static gpointer
+reconnect_camera (UcaPcowinCamera *camera)
+{
+    UcaPcowinCameraPrivate *priv;
+    gint64 deadline;
+    guint delay = RECONNECT_FIRST_DELAY_MS;
+    gboolean quit;
+    gint error;
+
+    priv = UCA_PCOWIN_CAMERA_GET_PRIVATE (camera);
+    deadline = priv->reconnect_started + (gint64) priv->reconnect_timeout * G_TIME_SPAN_MILLISECOND;
+
+    for (;;) {
+        gint64 wake_time = MIN (g_get_monotonic_time () + (gint64) delay * G_TIME_SPAN_MILLISECOND, deadline);
+
+        g_mutex_lock (&priv->reconnect_lock);
+
+        while (!priv->reconnect_quit && g_cond_wait_until (&priv->reconnect_cond, &priv->reconnect_lock, wake_time))
+            ;
+
+        quit = priv->reconnect_quit;
+        g_mutex_unlock (&priv->reconnect_lock);
+
+        if (quit) {
+            g_object_unref (camera);
+            return NULL;
+        }
+
+        error = open_camera (priv, NULL);
+
+        if (error == PCO_NOERROR || g_get_monotonic_time () >= deadline)
+            break;
+
+        delay = MIN (delay * 2, RECONNECT_MAX_DELAY_MS);
+    }
+
+    if (error == PCO_NOERROR)
+        error = restore_camera (priv);
+
+    g_mutex_lock (&priv->reconnect_lock);
+    priv->reconnect_downtime = (g_get_monotonic_time () - priv->reconnect_started) / (gdouble) G_TIME_SPAN_SECOND;
+    g_mutex_unlock (&priv->reconnect_lock);
+
+    if (error != PCO_NOERROR) {
+        PCO_GetErrorText (error, priv->error_text, ERROR_TEXT_BUFFER_SIZE);
+        g_warning ("Camera %u did not come back after reboot: %s", priv->serial_number, priv->error_text);
+        close_camera (priv);
+    }
+
+    set_ready (camera, error == PCO_NOERROR, FALSE);
+    g_signal_emit (camera, pco_signals[RECONNECTED], 0, error == PCO_NOERROR, priv->reconnect_downtime);
+
+    // The last reference may be dropped here, finalize then runs on this thread
+    g_object_unref (camera);
+
+    return NULL;
+}
+
+static void
+start_reconnect (UcaPcowinCamera *camera)
+{
+    UcaPcowinCameraPrivate *priv;
+    GError *error = NULL;
+
+    priv = UCA_PCOWIN_CAMERA_GET_PRIVATE (camera);
+
+    // A previous thread has already finished, the camera would not be ready otherwise
+    if (priv->reconnect_thread != NULL)
+        g_thread_join (priv->reconnect_thread);
+
+    close_camera (priv);
+    priv->reconnect_started = g_get_monotonic_time ();
+    priv->reconnect_quit = FALSE;
+    set_ready (camera, FALSE, TRUE);
+
+    // The thread keeps the camera alive until it has reported the outcome
+    priv->reconnect_thread = g_thread_try_new ("pco-reconnect", (GThreadFunc) reconnect_camera, g_object_ref (camera), &error);
+
+    if (priv->reconnect_thread == NULL) {
+        g_warning ("Could not start reconnecting: %s", error->message);
+        g_error_free (error);
+        g_object_unref (camera);
+        set_ready (camera, FALSE, FALSE);
+    }
+}
+
 static gint
 change_cl_transfer_parameters(UcaPcowinCameraPrivate *priv)
 {
@@ -1397,7 +5298,7 @@ change_cl_transfer_parameters(UcaPcowinCameraPrivate *priv)
     if (priv->strCamType.wCamType == CAMERATYPE_PCO_DIMAX_STD) {
         PCO_SC2_CL_TRANSFER_PARAM new_transfer_params, default_transfer_params;
 
-        error = PCO_GetTransferParameter (priv->pcoHandle, &default_transfer_params, sizeof(default_transfer_params));
+        error = QUERY_CALL (PCO_GetTransferParameter (priv->pcoHandle, &default_transfer_params, sizeof(default_transfer_params)));
 
         new_transfer_params.ClockFrequency = default_transfer_params.ClockFrequency;
         new_transfer_params.CCline = default_transfer_params.CCline;
@@ -1406,11 +5307,17 @@ change_cl_transfer_parameters(UcaPcowinCameraPrivate *priv)
         new_transfer_params.baudrate = 115200;
         new_transfer_params.DataFormat = PCO_CL_DATAFORMAT_2x12;
 
-        error = PCO_SetTransferParameter (priv->pcoHandle, &new_transfer_params, sizeof(new_transfer_params));
+        // Left over from a previous instance, setting it again costs a slow round trip
+        if (error == PCO_NOERROR &&
+            default_transfer_params.baudrate == new_transfer_params.baudrate &&
+            default_transfer_params.DataFormat == new_transfer_params.DataFormat)
+            return PCO_NOERROR;
+
+        error = CONTROL_CALL (PCO_SetTransferParameter (priv->pcoHandle, &new_transfer_params, sizeof(new_transfer_params)));
 
         if (PCO_NOERROR != error) {
             g_warning("Failed to set new transfer parameters");
-            error = PCO_SetTransferParameter (priv->pcoHandle, &default_transfer_params, sizeof(default_transfer_params));
+            error = CONTROL_CALL (PCO_SetTransferParameter (priv->pcoHandle, &default_transfer_params, sizeof(default_transfer_params)));
 
             if(PCO_NOERROR != error) {
                 g_warning ("Failed to revert back to default transfer parameters");
@@ -1426,46 +5333,126 @@ uca_pcowin_camera_init (UcaPcowinCamera *self)
 {
     UcaPcowinCameraPrivate *priv;
     UcaCamera *camera;
-    gint error;
 
     priv = UCA_PCOWIN_CAMERA_GET_PRIVATE(self);
-    priv->construct_error = NULL;
+    priv->init_error = NULL;
+    priv->pcoHandle = NULL;
+    priv->scheduler = uca_pcowin_scheduler_new ();
+    priv->preview = uca_pcowin_preview_new ();
+    priv->preview_downsampling = 1;
+    priv->shm_slots = 16;
+    priv->record_buffers = 2;
+    priv->grab_timeout = 1000;
+    priv->fifo_buffers = 4;
+    priv->readout_first_image = 1;
+    priv->description_cache = TRUE;
+    priv->init_timings = g_string_new (NULL);
+    priv->reconnect_timeout = 60000;
+    g_mutex_init (&priv->reconnect_lock);
+    g_cond_init (&priv->reconnect_cond);
+    priv->health_monitor = TRUE;
+    priv->health_poll_interval = 2000;
+    priv->health_poll_interval_recording = 30000;
+    priv->grab_queue = g_async_queue_new ();
+    priv->cancel_event = CreateEvent (NULL, TRUE, FALSE, NULL);
+    g_mutex_init (&priv->grab_lock);
+    g_cond_init (&priv->grab_cond);
+
+    camera = UCA_CAMERA (self);
+    uca_camera_register_unit (camera, "sensor-width-extended", UCA_UNIT_PIXEL);
+    uca_camera_register_unit (camera, "sensor-height-extended", UCA_UNIT_PIXEL);
+    uca_camera_register_unit (camera, "sensor-temperature", UCA_UNIT_DEGREE_CELSIUS);
+    uca_camera_register_unit (camera, "camera-temperature", UCA_UNIT_DEGREE_CELSIUS);
+    uca_camera_register_unit (camera, "power-supply-temperature", UCA_UNIT_DEGREE_CELSIUS);
+    uca_camera_register_unit (camera, "cooling-point", UCA_UNIT_DEGREE_CELSIUS);
+    uca_camera_register_unit (camera, "cooling-point-min", UCA_UNIT_DEGREE_CELSIUS);
+    uca_camera_register_unit (camera, "cooling-point-max", UCA_UNIT_DEGREE_CELSIUS);
+    uca_camera_register_unit (camera, "cooling-point-default", UCA_UNIT_DEGREE_CELSIUS);
+
+    uca_camera_set_writable (camera, "exposure-time", TRUE);
+    uca_camera_set_writable (camera, "frames-per-second", TRUE);
+    uca_camera_set_writable (camera, "preview-decimation", TRUE);
+    uca_camera_set_writable (camera, "preview-max-fps", TRUE);
+    uca_camera_set_writable (camera, "preview-downsampling", TRUE);
+    uca_camera_set_writable (camera, "preview-8bit", TRUE);
+    uca_camera_set_writable (camera, "grab-timeout", TRUE);
+}
+
+/*
+ * Opens the camera and reads its description. This runs in GInitable init
+ * rather than in uca_pcowin_camera_init because the construct-only
+ * "camera-index" and "serial-number" are not set before, and because it may
+ * take seconds that an asynchronous init spends on a worker thread.
+ * Cancellation is honoured between the steps, each SDK call itself blocks.
+ */
+static gboolean
+open_and_setup_camera (UcaPcowinCamera *self, GCancellable *cancellable, GError **error)
+{
+    UcaPcowinCameraPrivate *priv;
+    gint library_errors;
+
+    priv = UCA_PCOWIN_CAMERA_GET_PRIVATE (self);
 
-    error = setupsdk_and_opencamera (priv,self);
+    library_errors = setupsdk_and_opencamera (priv, self, cancellable);
 
-    if (error) {
-        PCO_GetErrorText (error, error_text, ERROR_TEXT_BUFFER_SIZE);
-        g_set_error (&priv->construct_error,
+    if (g_cancellable_set_error_if_cancelled (cancellable, error)) {
+        close_camera (priv);
+        return FALSE;
+    }
+
+    if (library_errors) {
+        PCO_GetErrorText (library_errors, priv->error_text, ERROR_TEXT_BUFFER_SIZE);
+        g_set_error (error,
                      UCA_PCOWIN_CAMERA_ERROR, UCA_PCOWIN_CAMERA_ERROR_SDK_INIT,
-                     "Initialization of SDK Failed. Here's error code 0x%X for enquiring minds.\nSDK Error Text: %s", error, error_text);
+                     "Initialization of SDK Failed. Here's error code 0x%X for enquiring minds.\nSDK Error Text: %s", library_errors, priv->error_text);
+        return FALSE;
     }
 
     set_default_properties (self);
 
+    // Defaults differ between models, so they are applied to this instance and not to the class
+    priv->roi_x = 0;
+    priv->roi_y = 0;
+    priv->roi_width = priv->width / priv->horizontal_binning;
+    priv->roi_height = priv->height / priv->vertical_binning;
+
+    library_errors = CONTROL_CALL (PCO_SetPixelRate (priv->pcoHandle, priv->default_pixelrate));
+
+    if (library_errors) {
+        PCO_GetErrorText (library_errors, priv->error_text, ERROR_TEXT_BUFFER_SIZE);
+        g_set_error (error,
+                     UCA_PCOWIN_CAMERA_ERROR, UCA_PCOWIN_CAMERA_ERROR_SDK_INIT,
+                     "Failed to set default pixel rate. Here's error code 0x%X for enquiring minds.\nSDK Error Text: %s", library_errors, priv->error_text);
+        return FALSE;
+    }
+
     /*
      * Change DIMAX CameraLink Transfer mode to DualTap 12 bit which utilizes
      * full throughput of CL Base Configuration
     */
     if (check_camera_type (priv->strCamType.wCamType, CAMERATYPE_PCO_DIMAX_STD)) {
-        error = change_cl_transfer_parameters (priv);
-        if (error) {
-            g_set_error (&priv->construct_error,
+        library_errors = change_cl_transfer_parameters (priv);
+        record_init_step (priv, "transfer-parameters");
+
+        if (library_errors) {
+            PCO_GetErrorText (library_errors, priv->error_text, ERROR_TEXT_BUFFER_SIZE);
+            g_set_error (error,
                          UCA_PCOWIN_CAMERA_ERROR, UCA_PCOWIN_CAMERA_ERROR_SDK_INIT,
-                         "Failed to set transfer parameters. Here's error code 0x%X for enquiring minds.\nSDK Error Text: %s", error, error_text);
+                         "Failed to set transfer parameters. Here's error code 0x%X for enquiring minds.\nSDK Error Text: %s", library_errors, priv->error_text);
+            return FALSE;
         }
     }
 
-    camera = UCA_CAMERA (self);
-    uca_camera_register_unit (camera, "sensor-width-extended", UCA_UNIT_PIXEL);
-    uca_camera_register_unit (camera, "sensor-height-extended", UCA_UNIT_PIXEL);
-    uca_camera_register_unit (camera, "sensor-temperature", UCA_UNIT_DEGREE_CELSIUS);
-    uca_camera_register_unit (camera, "cooling-point", UCA_UNIT_DEGREE_CELSIUS);
-    uca_camera_register_unit (camera, "cooling-point-min", UCA_UNIT_DEGREE_CELSIUS);
-    uca_camera_register_unit (camera, "cooling-point-max", UCA_UNIT_DEGREE_CELSIUS);
-    uca_camera_register_unit (camera, "cooling-point-default", UCA_UNIT_DEGREE_CELSIUS);
+    priv->health = uca_pcowin_health_new (priv->pcoHandle, priv->scheduler, HEALTH_HISTORY_LENGTH, emit_health_changed, self);
+    uca_pcowin_health_set_intervals (priv->health, priv->health_poll_interval, priv->health_poll_interval_recording);
 
-    uca_camera_set_writable (camera, "exposure-time", TRUE);
-    uca_camera_set_writable (camera, "frames-per-second", TRUE);
+    if (priv->health_monitor && !uca_pcowin_health_start (priv->health, error))
+        return FALSE;
+
+    priv->ready = TRUE;
+    apply_deferred_properties (self);
+
+    return TRUE;
 }
 
 G_MODULE_EXPORT GType
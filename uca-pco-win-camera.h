@@ -20,7 +20,12 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 #define __UCA_PCOWIN_CAMERA_H
 
 #include <glib-object.h>
+#include <gio/gio.h>
 #include <uca/uca-camera.h>
+#include "uca-pco-win-trigger.h"
+#include "uca-pco-win-health.h"
+#include "uca-pco-win-scheduler.h"
+#include "uca-pco-win-planner.h"
 
 G_BEGIN_DECLS
 
@@ -32,6 +37,8 @@ G_BEGIN_DECLS
 #define UCA_PCOWIN_CAMERA_GET_CLASS(obj)   (G_TYPE_INSTANCE_GET_CLASS((obj), UCA_TYPE_PCOWIN_CAMERA, UcaPcowinCameraClass))
 
 #define UCA_PCOWIN_CAMERA_ERROR uca_pcowin_camera_error_quark()
+GQuark uca_pcowin_camera_error_quark (void);
+
 typedef enum {
     UCA_PCOWIN_CAMERA_ERROR_SDK_INIT,
     UCA_PCOWIN_CAMERA_ERROR_GETTER,
@@ -39,6 +46,8 @@ typedef enum {
     UCA_PCOWIN_CAMERA_ERROR_UNSUPPORTED,
     UCA_PCOWIN_CAMERA_ERROR_SDKERROR,
     UCA_PCOWIN_CAMERA_ERROR_GENERAL,
+    UCA_PCOWIN_CAMERA_ERROR_TIMEOUT,
+    UCA_PCOWIN_CAMERA_ERROR_NOT_READY,
 } UcaPcoCameraError;
 
 typedef struct _UcaPcowinCamera           UcaPcowinCamera;
@@ -67,6 +76,50 @@ typedef enum {
     UCA_PCO_CAMERA_TIMESTAMP_ASCII
 } UcaPcoCameraTimestamp;
 
+typedef enum {
+    UCA_PCO_CAMERA_THREAD_PRIORITY_UNCHANGED,
+    UCA_PCO_CAMERA_THREAD_PRIORITY_ABOVE_NORMAL,
+    UCA_PCO_CAMERA_THREAD_PRIORITY_HIGHEST,
+    UCA_PCO_CAMERA_THREAD_PRIORITY_TIME_CRITICAL,
+    UCA_PCO_CAMERA_THREAD_PRIORITY_REALTIME
+} UcaPcoCameraThreadPriority;
+
+typedef enum {
+    UCA_PCO_CAMERA_BUFFER_ALLOCATION_SDK,
+    UCA_PCO_CAMERA_BUFFER_ALLOCATION_ARENA,
+    UCA_PCO_CAMERA_BUFFER_ALLOCATION_LARGE_PAGES
+} UcaPcoCameraBufferAllocation;
+
+typedef enum {
+    UCA_PCO_CAMERA_RECORD_STOP_EVENT_NONE,
+    UCA_PCO_CAMERA_RECORD_STOP_EVENT_SOFTWARE,
+    UCA_PCO_CAMERA_RECORD_STOP_EVENT_EXTERNAL
+} UcaPcoCameraRecordStopEvent;
+
+typedef enum {
+    UCA_PCO_CAMERA_TRANSFER_SELECTION_DEFAULT,
+    UCA_PCO_CAMERA_TRANSFER_SELECTION_MANUAL,
+    UCA_PCO_CAMERA_TRANSFER_SELECTION_FASTEST
+} UcaPcoCameraTransferSelection;
+
+typedef enum {
+    UCA_PCO_CAMERA_TRANSFER_FORMAT_1X16,
+    UCA_PCO_CAMERA_TRANSFER_FORMAT_2X12,
+    UCA_PCO_CAMERA_TRANSFER_FORMAT_3X8,
+    UCA_PCO_CAMERA_TRANSFER_FORMAT_4X16,
+    UCA_PCO_CAMERA_TRANSFER_FORMAT_5X16,
+    UCA_PCO_CAMERA_TRANSFER_FORMAT_5X12,
+    UCA_PCO_CAMERA_TRANSFER_FORMAT_10X8,
+    UCA_PCO_CAMERA_TRANSFER_FORMAT_5X12L,
+    UCA_PCO_CAMERA_TRANSFER_FORMAT_5X12R
+} UcaPcoCameraTransferFormat;
+
+typedef enum {
+    UCA_PCO_CAMERA_TRANSFER_DECODE_SDK,
+    UCA_PCO_CAMERA_TRANSFER_DECODE_HOST,
+    UCA_PCO_CAMERA_TRANSFER_DECODE_RAW
+} UcaPcoCameraTransferDecode;
+
 /**
  * UcaPcowinCamera:
  *
@@ -93,6 +146,340 @@ struct _UcaPcowinCameraClass {
 
 GType uca_pcowin_camera_get_type(void);
 
+/**
+ * uca_pcowin_camera_grab_preview:
+ * @camera: A #UcaPcowinCamera
+ * @data: Buffer receiving the preview frame
+ * @size: Size of @data in bytes
+ * @width: (out): Width of the preview frame
+ * @height: (out): Height of the preview frame
+ * @bytes_per_pixel: (out): 1 if "preview-8bit" is set, 2 otherwise
+ * @frame_number: (out): Number of the grabbed frame the preview was taken from
+ * @error: Location for a #GError or %NULL
+ *
+ * Copies the latest preview frame into @data without waiting for the camera.
+ * Preview frames are taken from the regular grab path according to the
+ * "preview-decimation", "preview-max-fps" and "preview-downsampling"
+ * properties and never steal frames from uca_camera_grab().
+ *
+ * Returns: %TRUE if a new preview frame was copied, %FALSE if there was none
+ * since the last call or if @error is set.
+ */
+gboolean uca_pcowin_camera_grab_preview (UcaPcowinCamera *camera,
+                                         gpointer data,
+                                         gsize size,
+                                         guint *width,
+                                         guint *height,
+                                         guint *bytes_per_pixel,
+                                         guint64 *frame_number,
+                                         GError **error);
+
+/**
+ * uca_pcowin_camera_decode_timestamp:
+ * @camera: A #UcaPcowinCamera
+ * @frame: Frame delivered by @camera
+ * @image_number: (out): Image counter of the camera
+ * @timestamp: (out): Camera time in microseconds since the epoch
+ *
+ * Decodes the binary timestamp that the camera stamps into the first pixels of
+ * @frame if "timestamp-mode" is binary or binary and ASCII.
+ *
+ * Returns: %TRUE if @frame carries a valid binary timestamp.
+ */
+gboolean uca_pcowin_camera_decode_timestamp (UcaPcowinCamera *camera,
+                                             gconstpointer frame,
+                                             guint32 *image_number,
+                                             gint64 *timestamp);
+
+/**
+ * uca_pcowin_camera_pop_compressed_frame:
+ * @camera: A #UcaPcowinCamera
+ * @wait: Wait for the oldest frame if it is still being compressed
+ * @size: (out): Size of the compressed frame in bytes
+ * @index: (out): Number of the delivered frame
+ *
+ * Takes the oldest compressed frame if "compression" was set when recording
+ * or readout started. Frames can still be collected after recording stopped.
+ * Use uca_pcowin_decompress_frame() from uca-pco-win-compress.h to restore
+ * the raw frame.
+ *
+ * Returns: (transfer full): Compressed frame to be freed with g_free() or
+ * %NULL if there is none.
+ */
+gpointer uca_pcowin_camera_pop_compressed_frame (UcaPcowinCamera *camera,
+                                                 gboolean wait,
+                                                 gsize *size,
+                                                 guint64 *index);
+
+/**
+ * uca_pcowin_camera_grab_async:
+ * @camera: A #UcaPcowinCamera
+ * @data: Buffer receiving the frame, must stay valid until @callback is called
+ * @cancellable: (allow-none): Optional #GCancellable
+ * @callback: Called in the thread-default main context of the caller once the
+ *  frame was delivered
+ * @user_data: Data passed to @callback
+ *
+ * Queues a grab on the acquisition thread of @camera and returns immediately.
+ * Grabs are served in the order they were queued and wait at most
+ * "grab-timeout" ms each. Do not mix with uca_camera_grab() on the same
+ * camera.
+ */
+void uca_pcowin_camera_grab_async (UcaPcowinCamera *camera,
+                                   gpointer data,
+                                   GCancellable *cancellable,
+                                   GAsyncReadyCallback callback,
+                                   gpointer user_data);
+
+/**
+ * uca_pcowin_camera_grab_finish:
+ * @camera: A #UcaPcowinCamera
+ * @result: #GAsyncResult passed to the callback
+ * @error: Location for a #GError or %NULL
+ *
+ * Returns: %TRUE if the frame was delivered, %FALSE with @error set to
+ * %G_IO_ERROR_CANCELLED if the grab was cancelled.
+ */
+gboolean uca_pcowin_camera_grab_finish (UcaPcowinCamera *camera,
+                                        GAsyncResult *result,
+                                        GError **error);
+
+/**
+ * uca_pcowin_camera_get_frames_available:
+ * @camera: A #UcaPcowinCamera
+ *
+ * Checks without blocking or talking to the camera how many frames the next
+ * grabs can deliver right away. Use it to poll in loops that interleave
+ * acquisition with other work, or set "grab-timeout" to 0 to try a grab.
+ *
+ * Returns: Number of frames that can be grabbed without waiting.
+ */
+guint uca_pcowin_camera_get_frames_available (UcaPcowinCamera *camera);
+
+/**
+ * uca_pcowin_camera_start_trigger_sequence:
+ * @camera: A #UcaPcowinCamera
+ * @times: (allow-none) (array length=n_triggers): Ascending trigger times in
+ *  seconds after the start, or %NULL to trigger every @interval seconds
+ * @n_triggers: Number of triggers
+ * @interval: Time between triggers in seconds if @times is %NULL
+ * @error: Location for a #GError or %NULL
+ *
+ * Issues software triggers from a dedicated time-critical thread that sleeps
+ * until shortly before each trigger and spins for the rest. The camera busy
+ * status is only polled when the previous trigger was less than a frame time
+ * ago. Triggers that find the camera busy are skipped, not delayed. @camera
+ * must be recording with "trigger-source" set to software. An exposure
+ * sequence is only supported on cameras that step through it on their own.
+ *
+ * Returns: %TRUE if the sequence was started.
+ */
+gboolean uca_pcowin_camera_start_trigger_sequence (UcaPcowinCamera *camera,
+                                                   const gdouble *times,
+                                                   guint n_triggers,
+                                                   gdouble interval,
+                                                   GError **error);
+
+/**
+ * uca_pcowin_camera_finish_trigger_sequence:
+ * @camera: A #UcaPcowinCamera
+ * @cancel: Cancel the triggers that were not issued yet instead of waiting
+ * @records: (out) (transfer full) (allow-none): Issue latency and outcome of
+ *  every trigger, to be freed with g_free()
+ * @n_records: (out) (allow-none): Number of entries in @records
+ * @error: Location for a #GError or %NULL
+ *
+ * Waits for the sequence started with
+ * uca_pcowin_camera_start_trigger_sequence() to end.
+ *
+ * Returns: %FALSE if an SDK call of the sequence failed.
+ */
+gboolean uca_pcowin_camera_finish_trigger_sequence (UcaPcowinCamera *camera,
+                                                    gboolean cancel,
+                                                    UcaPcowinTriggerRecord **records,
+                                                    guint *n_records,
+                                                    GError **error);
+
+/**
+ * uca_pcowin_camera_set_exposure_sequence:
+ * @camera: A #UcaPcowinCamera
+ * @exposures: (array length=n_exposures): Exposure times in seconds
+ * @delays: (allow-none) (array length=n_exposures): Delay times in seconds,
+ *  %NULL for no delay
+ * @n_exposures: Number of entries, 0 returns to the fixed "exposure-time"
+ * @error: Location for a #GError or %NULL
+ *
+ * Preloads delay/exposure pairs that consecutive frames cycle through once
+ * recording starts. Cameras with a delay/exposure time table step through it
+ * on their own. Other cameras require software trigger and are switched to
+ * the next pair right after each uca_camera_trigger(). The delay/exposure set
+ * before recording started is restored when it stops.
+ *
+ * Returns: %TRUE if the sequence was stored.
+ */
+gboolean uca_pcowin_camera_set_exposure_sequence (UcaPcowinCamera *camera,
+                                                  const gdouble *exposures,
+                                                  const gdouble *delays,
+                                                  guint n_exposures,
+                                                  GError **error);
+
+/**
+ * uca_pcowin_camera_get_frame_exposure:
+ * @camera: A #UcaPcowinCamera
+ * @frame: (allow-none): Frame delivered by @camera
+ * @exposure: (out) (allow-none): Exposure time of @frame in seconds
+ * @delay: (out) (allow-none): Delay time of @frame in seconds
+ *
+ * Looks up the exposure sequence entry @frame was taken with. The entry is
+ * derived from the image counter of the binary timestamp if there is one,
+ * otherwise from the number of the most recently delivered frame.
+ *
+ * Returns: %TRUE if an exposure sequence is active.
+ */
+gboolean uca_pcowin_camera_get_frame_exposure (UcaPcowinCamera *camera,
+                                               gconstpointer frame,
+                                               gdouble *exposure,
+                                               gdouble *delay);
+
+/**
+ * uca_pcowin_camera_trigger_event:
+ * @camera: A #UcaPcowinCamera
+ * @error: Location for a #GError or %NULL
+ *
+ * Signals the stop event if "record-stop-event" is software. The camera keeps
+ * recording "event-post-frames" frames and then stops on its own.
+ *
+ * Returns: %TRUE if the event was signalled.
+ */
+gboolean uca_pcowin_camera_trigger_event (UcaPcowinCamera *camera,
+                                          GError **error);
+
+/**
+ * uca_pcowin_camera_wait_event:
+ * @camera: A #UcaPcowinCamera
+ * @timeout_ms: Longest time to wait for the camera to stop
+ * @first_image: (out) (allow-none): First camRAM image of the event window
+ * @last_image: (out) (allow-none): Last camRAM image of the event window
+ * @error: Location for a #GError or %NULL
+ *
+ * Waits until the camera stopped recording after the stop event and
+ * restricts the next readout to the "event-pre-frames" frames before and the
+ * "event-post-frames" frames after the event. Call uca_camera_stop_recording()
+ * and uca_camera_start_readout() afterwards to transfer only that window.
+ *
+ * Returns: %TRUE if the camera stopped, %FALSE with
+ * %UCA_PCOWIN_CAMERA_ERROR_TIMEOUT if it is still recording.
+ */
+gboolean uca_pcowin_camera_wait_event (UcaPcowinCamera *camera,
+                                       guint timeout_ms,
+                                       guint32 *first_image,
+                                       guint32 *last_image,
+                                       GError **error);
+
+/**
+ * uca_pcowin_camera_wait_ready:
+ * @camera: A #UcaPcowinCamera
+ * @timeout_ms: Longest time to wait for the camera
+ * @error: Location for a #GError or %NULL
+ *
+ * Waits until the camera is usable again after changing "global-shutter"
+ * rebooted it. Returns immediately if no reconnection is in progress. The
+ * "camera-ready" property and the #UcaPcowinCamera::reconnected signal report
+ * the same without blocking.
+ *
+ * Returns: %TRUE if the camera is ready, %FALSE with
+ * %UCA_PCOWIN_CAMERA_ERROR_TIMEOUT if it is still rebooting or
+ * %UCA_PCOWIN_CAMERA_ERROR_NOT_READY if it did not come back.
+ */
+gboolean uca_pcowin_camera_wait_ready (UcaPcowinCamera *camera,
+                                       guint timeout_ms,
+                                       GError **error);
+
+/**
+ * uca_pcowin_camera_plan_frame_rate:
+ * @camera: A #UcaPcowinCamera
+ * @fps: Requested frame rate
+ * @exposure: Requested exposure time in seconds
+ * @shrink_roi: Whether the ROI height may be reduced to reach @fps
+ * @plan: (out): Location for the applied configuration
+ * @error: Location for a #GError or %NULL
+ *
+ * Chooses pixel rate, number of ADCs and, with @shrink_roi, the ROI height
+ * from the camera description so that @fps is reached with @exposure,
+ * preferring the largest ROI and the slowest, least noisy readout. The
+ * configuration is applied and the camera armed once. @plan reports the
+ * frame rate and exposure the camera accepted and whether it trimmed them.
+ *
+ * Returns: %TRUE if the configuration was applied, even if trimmed.
+ */
+gboolean uca_pcowin_camera_plan_frame_rate (UcaPcowinCamera *camera,
+                                            gdouble fps,
+                                            gdouble exposure,
+                                            gboolean shrink_roi,
+                                            UcaPcowinFrameRatePlan *plan,
+                                            GError **error);
+
+/**
+ * uca_pcowin_camera_save_snapshot:
+ * @camera: A #UcaPcowinCamera
+ * @error: Location for a #GError or %NULL
+ *
+ * Captures the sensor, timing, storage and recording configuration with one
+ * bulk SDK call each. Pending ROI and binning are included. The snapshot is
+ * a compact blob that can be written to disk and restored later on this or
+ * another camera of the same type.
+ *
+ * Returns: (transfer full): The snapshot or %NULL on error.
+ */
+GBytes *uca_pcowin_camera_save_snapshot (UcaPcowinCamera *camera,
+                                         GError **error);
+
+/**
+ * uca_pcowin_camera_restore_snapshot:
+ * @camera: A #UcaPcowinCamera
+ * @snapshot: A snapshot from uca_pcowin_camera_save_snapshot()
+ * @n_changed: (out) (optional): Location for the number of structures written
+ * @error: Location for a #GError or %NULL
+ *
+ * Restores the configuration in @snapshot. The current configuration is read
+ * and only structures that differ are written, followed by a single arm. An
+ * unchanged storage configuration keeps the images in camRAM.
+ *
+ * Returns: %TRUE on success, %FALSE if recording, if @snapshot is damaged or
+ * belongs to another camera type, or on an SDK error.
+ */
+gboolean uca_pcowin_camera_restore_snapshot (UcaPcowinCamera *camera,
+                                             GBytes *snapshot,
+                                             guint *n_changed,
+                                             GError **error);
+
+/**
+ * uca_pcowin_camera_get_health_history:
+ * @camera: A #UcaPcowinCamera
+ * @n_samples: (out): Number of returned samples
+ *
+ * Returns the most recent temperature and health status samples of the
+ * background monitor, oldest first.
+ *
+ * Returns: (transfer full): Array of @n_samples samples, free with g_free().
+ */
+UcaPcowinHealthSample *uca_pcowin_camera_get_health_history (UcaPcowinCamera *camera,
+                                                             guint *n_samples);
+
+/**
+ * uca_pcowin_camera_get_command_stats:
+ * @camera: A #UcaPcowinCamera
+ * @priority: Priority class of the SDK calls
+ * @stats: (out): Location for the statistics
+ *
+ * Reports how many SDK calls of @priority were issued, how long they waited
+ * for the camera and, for queries, how many property reads were answered by
+ * a concurrent identical read instead.
+ */
+void uca_pcowin_camera_get_command_stats (UcaPcowinCamera *camera,
+                                          UcaPcowinPriority priority,
+                                          UcaPcowinSchedulerStats *stats);
+
 G_END_DECLS
 
 #endif
@@ -0,0 +1,599 @@
+/**
+Copyright (C) 2016  Sai Sasidhar Maddali <sai.sasidhar92@gmail.com>
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+**/
+
+#include <string.h>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+#include "uca-pco-win-camera.h"
+#include "uca-pco-win-compress.h"
+
+#define LZ_HASH_LOG         12
+#define LZ_MIN_MATCH        4
+#define LZ_LAST_LITERALS    5
+#define LZ_MATCH_LIMIT      12
+#define LZ_MAX_OFFSET       65535
+
+typedef struct {
+    guint64 index;
+    guint8 *input;
+    guint8 *output;
+    gsize size;
+    gboolean done;
+} CompressJob;
+
+struct _UcaPcowinCompressor {
+    GThreadPool *pool;
+    GMutex lock;
+    GCond done;
+    GQueue jobs;
+
+    gsize frame_size;
+    guint max_pending;
+
+    guint64 dropped;
+    guint64 raw_bytes;
+    guint64 compressed_bytes;
+    gint64 first_push;
+    gint64 last_completion;
+};
+
+/*
+ * Splits the 16 bit elements into a low and a high byte stream and transposes
+ * the bits of every group of 16 bytes, so that each of the 16 bit planes ends
+ * up contiguous. The unused high bits of 12 bit data become long runs of zeros.
+ * Elements beyond the last multiple of 16 are copied verbatim.
+ */
+static void
+bitshuffle (const guint16 *src, gsize n, guint8 *bytes, guint8 *dst)
+{
+    gsize m = n & ~((gsize) 15);
+    gsize plane_size = m / 8;
+
+    for (gsize i = 0; i < m; i++) {
+        bytes[i] = src[i] & 0xFF;
+        bytes[m + i] = src[i] >> 8;
+    }
+
+    for (guint stream = 0; stream < 2; stream++) {
+        const guint8 *in = bytes + stream * m;
+        guint8 *planes = dst + stream * 8 * plane_size;
+
+        for (gsize k = 0; k < m / 16; k++) {
+#ifdef __SSE2__
+            __m128i v = _mm_loadu_si128 ((const __m128i *) (in + 16 * k));
+
+            for (gint bit = 7; bit >= 0; bit--) {
+                guint mask = (guint) _mm_movemask_epi8 (v);
+                guint8 *out = planes + (7 - bit) * plane_size + 2 * k;
+
+                out[0] = mask & 0xFF;
+                out[1] = mask >> 8;
+                v = _mm_add_epi8 (v, v);
+            }
+#else
+            for (gint bit = 7; bit >= 0; bit--) {
+                guint mask = 0;
+                guint8 *out = planes + (7 - bit) * plane_size + 2 * k;
+
+                for (guint t = 0; t < 16; t++)
+                    mask |= ((in[16 * k + t] >> bit) & 1) << t;
+
+                out[0] = mask & 0xFF;
+                out[1] = mask >> 8;
+            }
+#endif
+        }
+    }
+
+    memcpy (dst + 2 * m, src + m, (n - m) * 2);
+}
+
+static void
+bitunshuffle (const guint8 *src, gsize n, guint8 *bytes, guint8 *dst)
+{
+    gsize m = n & ~((gsize) 15);
+    gsize plane_size = m / 8;
+
+    memset (bytes, 0, 2 * m);
+
+    for (guint stream = 0; stream < 2; stream++) {
+        const guint8 *planes = src + stream * 8 * plane_size;
+        guint8 *out = bytes + stream * m;
+
+        for (gsize k = 0; k < m / 16; k++) {
+            for (gint bit = 7; bit >= 0; bit--) {
+                const guint8 *in = planes + (7 - bit) * plane_size + 2 * k;
+                guint mask = in[0] | (in[1] << 8);
+
+                for (guint t = 0; t < 16; t++)
+                    out[16 * k + t] |= ((mask >> t) & 1) << bit;
+            }
+        }
+    }
+
+    // Byte-wise so that the destination does not need to be 16 bit aligned
+    for (gsize i = 0; i < m; i++) {
+        dst[2 * i] = bytes[i];
+        dst[2 * i + 1] = bytes[m + i];
+    }
+
+    memcpy (dst + 2 * m, src + 2 * m, (n - m) * 2);
+}
+
+static inline guint32
+read32 (const guint8 *p)
+{
+    guint32 value;
+    memcpy (&value, p, sizeof (value));
+    return value;
+}
+
+static inline guint
+lz_hash (guint32 sequence)
+{
+    return (sequence * 2654435761U) >> (32 - LZ_HASH_LOG);
+}
+
+static guint8 *
+lz_write_length (guint8 *op, gsize length)
+{
+    while (length >= 255) {
+        *op++ = 255;
+        length -= 255;
+    }
+
+    *op++ = (guint8) length;
+    return op;
+}
+
+/*
+ * Writes one sequence in LZ4 block format: token, literals and, unless this is
+ * the final literal-only sequence, a 16 bit offset and the match length.
+ */
+static guint8 *
+lz_write_sequence (guint8 *op, const guint8 *literals, gsize n_literals, guint offset, gsize match_length, gboolean has_match)
+{
+    guint8 *token = op++;
+
+    *token = (guint8) ((n_literals >= 15 ? 15 : n_literals) << 4);
+
+    if (n_literals >= 15)
+        op = lz_write_length (op, n_literals - 15);
+
+    memcpy (op, literals, n_literals);
+    op += n_literals;
+
+    if (!has_match)
+        return op;
+
+    *op++ = offset & 0xFF;
+    *op++ = offset >> 8;
+
+    match_length -= LZ_MIN_MATCH;
+    *token |= (guint8) (match_length >= 15 ? 15 : match_length);
+
+    if (match_length >= 15)
+        op = lz_write_length (op, match_length - 15);
+
+    return op;
+}
+
+static gsize
+lz_compress (const guint8 *src, gsize n, guint8 *dst)
+{
+    guint32 table[1 << LZ_HASH_LOG];
+    const guint8 *ip = src;
+    const guint8 *anchor = src;
+    const guint8 *end = src + n;
+    guint8 *op = dst;
+
+    memset (table, 0, sizeof (table));
+
+    if (n > LZ_MATCH_LIMIT) {
+        const guint8 *match_limit = end - LZ_MATCH_LIMIT;
+        const guint8 *extend_limit = end - LZ_LAST_LITERALS;
+
+        while (ip < match_limit) {
+            guint32 sequence = read32 (ip);
+            guint hash = lz_hash (sequence);
+            gboolean has_ref = table[hash] != 0;
+            const guint8 *ref = src + table[hash] - 1;
+
+            // Positions are stored off by one so that zero means empty
+            table[hash] = (guint32) (ip - src) + 1;
+
+            if (has_ref && ref < ip && ip - ref <= LZ_MAX_OFFSET && read32 (ref) == sequence) {
+                const guint8 *mp = ip + LZ_MIN_MATCH;
+                const guint8 *rp = ref + LZ_MIN_MATCH;
+
+                while (mp < extend_limit && *mp == *rp) {
+                    mp++;
+                    rp++;
+                }
+
+                op = lz_write_sequence (op, anchor, ip - anchor, (guint) (ip - ref), mp - ip, TRUE);
+                ip = mp;
+                anchor = ip;
+            }
+            else
+                ip++;
+        }
+    }
+
+    op = lz_write_sequence (op, anchor, end - anchor, 0, 0, FALSE);
+
+    return op - dst;
+}
+
+static gboolean
+lz_read_length (const guint8 **ip, const guint8 *end, gsize *length)
+{
+    guint8 byte;
+
+    do {
+        if (*ip >= end)
+            return FALSE;
+
+        byte = *(*ip)++;
+        *length += byte;
+    } while (byte == 255);
+
+    return TRUE;
+}
+
+static gssize
+lz_decompress (const guint8 *src, gsize n, guint8 *dst, gsize capacity)
+{
+    const guint8 *ip = src;
+    const guint8 *end = src + n;
+    guint8 *op = dst;
+    guint8 *op_end = dst + capacity;
+
+    while (ip < end) {
+        guint8 token = *ip++;
+        gsize n_literals = token >> 4;
+        gsize match_length = token & 0x0F;
+        guint offset;
+
+        if (n_literals == 15 && !lz_read_length (&ip, end, &n_literals))
+            return -1;
+
+        if ((gsize) (end - ip) < n_literals || (gsize) (op_end - op) < n_literals)
+            return -1;
+
+        memcpy (op, ip, n_literals);
+        ip += n_literals;
+        op += n_literals;
+
+        if (ip == end)
+            break;
+
+        if (end - ip < 2)
+            return -1;
+
+        offset = ip[0] | (ip[1] << 8);
+        ip += 2;
+
+        if (offset == 0 || offset > (gsize) (op - dst))
+            return -1;
+
+        if (match_length == 15 && !lz_read_length (&ip, end, &match_length))
+            return -1;
+
+        match_length += LZ_MIN_MATCH;
+
+        if ((gsize) (op_end - op) < match_length)
+            return -1;
+
+        // Matches may overlap their own output
+        for (gsize i = 0; i < match_length; i++, op++)
+            *op = *(op - offset);
+    }
+
+    return op - dst;
+}
+
+gsize
+uca_pcowin_compress_bound (gsize frame_size)
+{
+    gsize n_chunks = (frame_size + UCA_PCOWIN_COMPRESS_CHUNK_SIZE - 1) / UCA_PCOWIN_COMPRESS_CHUNK_SIZE;
+
+    return sizeof (UcaPcowinCompressedHeader) + n_chunks * (sizeof (guint32) + 16) + frame_size + frame_size / 255;
+}
+
+/*
+ * Compresses @frame into @output, which must hold uca_pcowin_compress_bound()
+ * bytes. @scratch must hold 2 * UCA_PCOWIN_COMPRESS_CHUNK_SIZE bytes.
+ */
+gsize
+uca_pcowin_compress_frame (gconstpointer frame, gsize frame_size, guint8 *scratch, guint8 *output)
+{
+    UcaPcowinCompressedHeader *header = (UcaPcowinCompressedHeader *) output;
+    guint32 *sizes;
+    guint8 *op;
+    guint n_chunks;
+
+    n_chunks = (guint) ((frame_size + UCA_PCOWIN_COMPRESS_CHUNK_SIZE - 1) / UCA_PCOWIN_COMPRESS_CHUNK_SIZE);
+    header->magic = UCA_PCOWIN_COMPRESS_MAGIC;
+    header->n_chunks = n_chunks;
+    header->raw_size = frame_size;
+    sizes = (guint32 *) (output + sizeof (UcaPcowinCompressedHeader));
+    op = (guint8 *) (sizes + n_chunks);
+
+    for (guint c = 0; c < n_chunks; c++) {
+        const guint8 *raw = (const guint8 *) frame + (gsize) c * UCA_PCOWIN_COMPRESS_CHUNK_SIZE;
+        gsize length = MIN (UCA_PCOWIN_COMPRESS_CHUNK_SIZE, frame_size - (gsize) c * UCA_PCOWIN_COMPRESS_CHUNK_SIZE);
+        guint8 *shuffled = scratch + UCA_PCOWIN_COMPRESS_CHUNK_SIZE;
+        gsize size;
+
+        bitshuffle ((const guint16 *) raw, length / 2, scratch, shuffled);
+
+        if (length & 1)
+            shuffled[length - 1] = raw[length - 1];
+
+        size = lz_compress (shuffled, length, op);
+        sizes[c] = (guint32) size;
+        op += size;
+    }
+
+    return op - output;
+}
+
+gboolean
+uca_pcowin_decompress_frame (gconstpointer compressed, gsize size, gpointer frame, gsize frame_size)
+{
+    const UcaPcowinCompressedHeader *header = compressed;
+    const guint32 *sizes;
+    const guint8 *ip, *end;
+    guint8 *scratch;
+    gboolean success = TRUE;
+
+    // Fewer chunks than the frame needs would leave the tail of @frame unwritten
+    if (size < sizeof (UcaPcowinCompressedHeader) || header->magic != UCA_PCOWIN_COMPRESS_MAGIC ||
+        header->raw_size != frame_size ||
+        header->n_chunks != (frame_size + UCA_PCOWIN_COMPRESS_CHUNK_SIZE - 1) / UCA_PCOWIN_COMPRESS_CHUNK_SIZE ||
+        size < sizeof (UcaPcowinCompressedHeader) + (gsize) header->n_chunks * sizeof (guint32))
+        return FALSE;
+
+    sizes = (const guint32 *) ((const guint8 *) compressed + sizeof (UcaPcowinCompressedHeader));
+    ip = (const guint8 *) (sizes + header->n_chunks);
+    end = (const guint8 *) compressed + size;
+    scratch = g_malloc (2 * UCA_PCOWIN_COMPRESS_CHUNK_SIZE);
+
+    for (guint c = 0; c < header->n_chunks && success; c++) {
+        gsize offset = (gsize) c * UCA_PCOWIN_COMPRESS_CHUNK_SIZE;
+        gsize length;
+        guint8 *shuffled = scratch + UCA_PCOWIN_COMPRESS_CHUNK_SIZE;
+
+        if (offset >= frame_size || (gsize) (end - ip) < sizes[c]) {
+            success = FALSE;
+            break;
+        }
+
+        length = MIN (UCA_PCOWIN_COMPRESS_CHUNK_SIZE, frame_size - offset);
+
+        if (lz_decompress (ip, sizes[c], shuffled, length) != (gssize) length) {
+            success = FALSE;
+            break;
+        }
+
+        bitunshuffle (shuffled, length / 2, scratch, (guint8 *) frame + offset);
+
+        if (length & 1)
+            ((guint8 *) frame)[offset + length - 1] = shuffled[length - 1];
+
+        ip += sizes[c];
+    }
+
+    g_free (scratch);
+    return success;
+}
+
+static void
+compress_job (gpointer data, gpointer user_data)
+{
+    CompressJob *job = data;
+    UcaPcowinCompressor *compressor = user_data;
+    guint8 *scratch;
+    gsize size;
+
+    scratch = g_malloc (2 * UCA_PCOWIN_COMPRESS_CHUNK_SIZE);
+    job->output = g_malloc (uca_pcowin_compress_bound (compressor->frame_size));
+    size = uca_pcowin_compress_frame (job->input, compressor->frame_size, scratch, job->output);
+    job->output = g_realloc (job->output, size);
+    g_free (scratch);
+    g_free (job->input);
+    job->input = NULL;
+
+    g_mutex_lock (&compressor->lock);
+    job->size = size;
+    job->done = TRUE;
+    compressor->raw_bytes += compressor->frame_size;
+    compressor->compressed_bytes += size;
+    compressor->last_completion = g_get_monotonic_time ();
+    g_cond_broadcast (&compressor->done);
+    g_mutex_unlock (&compressor->lock);
+}
+
+static void
+compress_job_free (CompressJob *job)
+{
+    g_free (job->input);
+    g_free (job->output);
+    g_free (job);
+}
+
+UcaPcowinCompressor *
+uca_pcowin_compressor_new (gsize frame_size, guint n_threads, guint max_pending, GError **error)
+{
+    UcaPcowinCompressor *compressor;
+
+    compressor = g_new0 (UcaPcowinCompressor, 1);
+    compressor->frame_size = frame_size;
+    compressor->max_pending = MAX (max_pending, 1);
+    g_mutex_init (&compressor->lock);
+    g_cond_init (&compressor->done);
+    g_queue_init (&compressor->jobs);
+
+    compressor->pool = g_thread_pool_new (compress_job, compressor,
+                                          n_threads > 0 ? (gint) n_threads : (gint) g_get_num_processors (),
+                                          FALSE, error);
+
+    if (compressor->pool == NULL) {
+        uca_pcowin_compressor_free (compressor);
+        return NULL;
+    }
+
+    return compressor;
+}
+
+void
+uca_pcowin_compressor_free (UcaPcowinCompressor *compressor)
+{
+    CompressJob *job;
+
+    if (compressor == NULL)
+        return;
+
+    if (compressor->pool != NULL)
+        g_thread_pool_free (compressor->pool, FALSE, TRUE);
+
+    while ((job = g_queue_pop_head (&compressor->jobs)) != NULL)
+        compress_job_free (job);
+
+    g_mutex_clear (&compressor->lock);
+    g_cond_clear (&compressor->done);
+    g_free (compressor);
+}
+
+/*
+ * Queues a copy of @frame for compression. Frames are dropped (and counted)
+ * rather than blocking the caller once max_pending frames have not been
+ * collected with uca_pcowin_compressor_pop().
+ */
+gboolean
+uca_pcowin_compressor_push (UcaPcowinCompressor *compressor, gconstpointer frame, guint64 index)
+{
+    CompressJob *job;
+
+    g_mutex_lock (&compressor->lock);
+
+    if (g_queue_get_length (&compressor->jobs) >= compressor->max_pending) {
+        compressor->dropped++;
+        g_mutex_unlock (&compressor->lock);
+        return FALSE;
+    }
+
+    job = g_new0 (CompressJob, 1);
+    job->index = index;
+    job->input = g_malloc (compressor->frame_size);
+    memcpy (job->input, frame, compressor->frame_size);
+    g_queue_push_tail (&compressor->jobs, job);
+
+    if (compressor->first_push == 0)
+        compressor->first_push = g_get_monotonic_time ();
+
+    g_mutex_unlock (&compressor->lock);
+
+    g_thread_pool_push (compressor->pool, job, NULL);
+
+    return TRUE;
+}
+
+/*
+ * Returns the next compressed frame in delivery order or NULL if there is none
+ * (yet). The result must be freed with g_free().
+ */
+gpointer
+uca_pcowin_compressor_pop (UcaPcowinCompressor *compressor, gboolean wait, gsize *size, guint64 *index)
+{
+    CompressJob *job;
+    gpointer data = NULL;
+
+    g_mutex_lock (&compressor->lock);
+
+    while ((job = g_queue_peek_head (&compressor->jobs)) != NULL && !job->done) {
+        if (!wait)
+            break;
+
+        g_cond_wait (&compressor->done, &compressor->lock);
+    }
+
+    if (job != NULL && job->done) {
+        g_queue_pop_head (&compressor->jobs);
+        data = job->output;
+        job->output = NULL;
+
+        if (size)
+            *size = job->size;
+
+        if (index)
+            *index = job->index;
+
+        compress_job_free (job);
+    }
+
+    g_mutex_unlock (&compressor->lock);
+
+    return data;
+}
+
+gdouble
+uca_pcowin_compressor_get_ratio (UcaPcowinCompressor *compressor)
+{
+    gdouble ratio;
+
+    g_mutex_lock (&compressor->lock);
+    ratio = compressor->compressed_bytes > 0 ? (gdouble) compressor->raw_bytes / compressor->compressed_bytes : 0.0;
+    g_mutex_unlock (&compressor->lock);
+
+    return ratio;
+}
+
+gdouble
+uca_pcowin_compressor_get_throughput (UcaPcowinCompressor *compressor)
+{
+    gdouble throughput = 0.0;
+    gint64 elapsed;
+
+    g_mutex_lock (&compressor->lock);
+    elapsed = compressor->last_completion - compressor->first_push;
+
+    if (elapsed > 0)
+        throughput = compressor->raw_bytes / 1024.0 / 1024.0 / (elapsed / (gdouble) G_USEC_PER_SEC);
+
+    g_mutex_unlock (&compressor->lock);
+
+    return throughput;
+}
+
+guint64
+uca_pcowin_compressor_get_dropped (UcaPcowinCompressor *compressor)
+{
+    guint64 dropped;
+
+    g_mutex_lock (&compressor->lock);
+    dropped = compressor->dropped;
+    g_mutex_unlock (&compressor->lock);
+
+    return dropped;
+}
@@ -0,0 +1,74 @@
+/*
+Copyright (C) 2016  Sai Sasidhar Maddali <sai.sasidhar92@gmail.com>
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+
+#ifndef __UCA_PCOWIN_COMPRESS_H
+#define __UCA_PCOWIN_COMPRESS_H
+
+#include <glib.h>
+
+G_BEGIN_DECLS
+
+/*
+ * Compressed frames start with a UcaPcowinCompressedHeader followed by
+ * n_chunks 32 bit compressed chunk sizes and the chunk data. Every chunk of
+ * up to UCA_PCOWIN_COMPRESS_CHUNK_SIZE raw bytes is bit-shuffled and then
+ * LZ4 block compressed on its own.
+ */
+#define UCA_PCOWIN_COMPRESS_MAGIC       0x5a4c4350  /* "PCLZ" */
+#define UCA_PCOWIN_COMPRESS_CHUNK_SIZE  (128 * 1024)
+
+typedef struct {
+    guint32 magic;
+    guint32 n_chunks;
+    guint64 raw_size;
+} UcaPcowinCompressedHeader;
+
+typedef struct _UcaPcowinCompressor UcaPcowinCompressor;
+
+UcaPcowinCompressor *uca_pcowin_compressor_new      (gsize               frame_size,
+                                                     guint               n_threads,
+                                                     guint               max_pending,
+                                                     GError            **error);
+void                uca_pcowin_compressor_free      (UcaPcowinCompressor *compressor);
+gboolean            uca_pcowin_compressor_push      (UcaPcowinCompressor *compressor,
+                                                     gconstpointer       frame,
+                                                     guint64             index);
+gpointer            uca_pcowin_compressor_pop       (UcaPcowinCompressor *compressor,
+                                                     gboolean            wait,
+                                                     gsize              *size,
+                                                     guint64            *index);
+gdouble             uca_pcowin_compressor_get_ratio (UcaPcowinCompressor *compressor);
+gdouble             uca_pcowin_compressor_get_throughput
+                                                    (UcaPcowinCompressor *compressor);
+guint64             uca_pcowin_compressor_get_dropped
+                                                    (UcaPcowinCompressor *compressor);
+
+gsize               uca_pcowin_compress_frame       (gconstpointer       frame,
+                                                     gsize               frame_size,
+                                                     guint8             *scratch,
+                                                     guint8             *output);
+gsize               uca_pcowin_compress_bound       (gsize               frame_size);
+gboolean            uca_pcowin_decompress_frame     (gconstpointer       compressed,
+                                                     gsize               size,
+                                                     gpointer            frame,
+                                                     gsize               frame_size);
+
+G_END_DECLS
+
+#endif
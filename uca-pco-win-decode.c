@@ -0,0 +1,242 @@
+/**
+Copyright (C) 2016  Sai Sasidhar Maddali <sai.sasidhar92@gmail.com>
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+**/
+
+#include <string.h>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define HAVE_AVX2_KERNEL
+#endif
+
+#include "uca-pco-win-camera.h"
+#include "uca-pco-win-decode.h"
+
+/*
+ * Expands the codes of a compressing camera LUT back to 16 bit values. The
+ * table holds 32 bit entries so that the AVX2 kernel can gather from it
+ * directly. Codes are masked to the table size, stray upper bits in the
+ * transfer buffer can therefore not read beyond it.
+ */
+struct _UcaPcowinDecoder {
+    guint32 *table;
+    guint32 mask;
+
+    GMutex lock;
+    guint64 n_frames;
+    guint64 n_pixels;
+    gint64 time_spent;
+};
+
+/*
+ * Default table: the inverse of the square-root law the pco.edge 16 to 12 bit
+ * LUT approximates. The exact camera table can be loaded from a file.
+ */
+static void
+fill_default_table (UcaPcowinDecoder *decoder)
+{
+    gdouble max_code = decoder->mask;
+
+    for (guint32 code = 0; code <= decoder->mask; code++)
+        decoder->table[code] = (guint32) (code * code / (max_code * max_code) * G_MAXUINT16 + 0.5);
+}
+
+UcaPcowinDecoder *
+uca_pcowin_decoder_new (guint code_bits)
+{
+    UcaPcowinDecoder *decoder;
+
+    decoder = g_new0 (UcaPcowinDecoder, 1);
+    decoder->mask = (1u << code_bits) - 1;
+    decoder->table = g_new0 (guint32, decoder->mask + 1);
+    g_mutex_init (&decoder->lock);
+    fill_default_table (decoder);
+
+    return decoder;
+}
+
+void
+uca_pcowin_decoder_free (UcaPcowinDecoder *decoder)
+{
+    if (decoder == NULL)
+        return;
+
+    g_mutex_clear (&decoder->lock);
+    g_free (decoder->table);
+    g_free (decoder);
+}
+
+// The file holds one little endian 16 bit value per code
+gboolean
+uca_pcowin_decoder_load_table (UcaPcowinDecoder *decoder, const gchar *filename, GError **error)
+{
+    gchar *contents;
+    gsize length;
+
+    if (!g_file_get_contents (filename, &contents, &length, error))
+        return FALSE;
+
+    if (length != (decoder->mask + 1) * sizeof (guint16)) {
+        g_set_error (error, UCA_PCOWIN_CAMERA_ERROR, UCA_PCOWIN_CAMERA_ERROR_GENERAL,
+                     "LUT file `%s' has %" G_GSIZE_FORMAT " bytes instead of %u",
+                     filename, length, (guint) ((decoder->mask + 1) * sizeof (guint16)));
+        g_free (contents);
+        return FALSE;
+    }
+
+    for (guint32 code = 0; code <= decoder->mask; code++)
+        decoder->table[code] = (guint8) contents[2 * code] | ((guint8) contents[2 * code + 1] << 8);
+
+    g_free (contents);
+
+    return TRUE;
+}
+
+static void
+expand_scalar (const guint32 *table, guint32 mask, const guint16 *src, guint16 *dst, gsize n_pixels)
+{
+    for (gsize i = 0; i < n_pixels; i++)
+        dst[i] = (guint16) table[src[i] & mask];
+}
+
+#ifdef HAVE_AVX2_KERNEL
+__attribute__ ((target ("avx2")))
+static void
+expand_avx2 (const guint32 *table, guint32 mask, const guint16 *src, guint16 *dst, gsize n_pixels)
+{
+    __m256i code_mask = _mm256_set1_epi32 ((int) mask);
+    gsize i = 0;
+
+    for (; i + 16 <= n_pixels; i += 16) {
+        __m256i lo = _mm256_cvtepu16_epi32 (_mm_loadu_si128 ((const __m128i *) (src + i)));
+        __m256i hi = _mm256_cvtepu16_epi32 (_mm_loadu_si128 ((const __m128i *) (src + i + 8)));
+
+        lo = _mm256_i32gather_epi32 ((const int *) table, _mm256_and_si256 (lo, code_mask), 4);
+        hi = _mm256_i32gather_epi32 ((const int *) table, _mm256_and_si256 (hi, code_mask), 4);
+
+        // Packing works per 128 bit lane, the permutation restores pixel order
+        _mm256_storeu_si256 ((__m256i *) (dst + i),
+                             _mm256_permute4x64_epi64 (_mm256_packus_epi32 (lo, hi), 0xD8));
+    }
+
+    expand_scalar (table, mask, src + i, dst + i, n_pixels - i);
+}
+#endif
+
+gboolean
+uca_pcowin_decoder_has_simd (void)
+{
+#ifdef HAVE_AVX2_KERNEL
+    static gsize checked = 0;
+    static gboolean has_avx2 = FALSE;
+
+    if (g_once_init_enter (&checked)) {
+        __builtin_cpu_init ();
+        has_avx2 = __builtin_cpu_supports ("avx2");
+        g_once_init_leave (&checked, 1);
+    }
+
+    return has_avx2;
+#else
+    return FALSE;
+#endif
+}
+
+static void
+expand (UcaPcowinDecoder *decoder, const guint16 *src, guint16 *dst, gsize n_pixels)
+{
+#ifdef HAVE_AVX2_KERNEL
+    if (uca_pcowin_decoder_has_simd ()) {
+        expand_avx2 (decoder->table, decoder->mask, src, dst, n_pixels);
+        return;
+    }
+#endif
+
+    expand_scalar (decoder->table, decoder->mask, src, dst, n_pixels);
+}
+
+// Decodes one frame while copying it out of the transfer buffer
+void
+uca_pcowin_decoder_expand (UcaPcowinDecoder *decoder, const guint16 *src, guint16 *dst, gsize n_pixels)
+{
+    gint64 start = g_get_monotonic_time ();
+
+    expand (decoder, src, dst, n_pixels);
+
+    g_mutex_lock (&decoder->lock);
+    decoder->n_frames++;
+    decoder->n_pixels += n_pixels;
+    decoder->time_spent += g_get_monotonic_time () - start;
+    g_mutex_unlock (&decoder->lock);
+}
+
+/*
+ * Decodes @n_frames synthetic frames of @n_pixels outside the statistics and
+ * returns the throughput in pixels per second. The codes cover the whole
+ * table so that gathers do not all hit the same cache line.
+ */
+gdouble
+uca_pcowin_decoder_benchmark (UcaPcowinDecoder *decoder, gsize n_pixels, guint n_frames)
+{
+    guint16 *src;
+    guint16 *dst;
+    gint64 start, elapsed;
+
+    if (n_pixels == 0 || n_frames == 0)
+        return 0.0;
+
+    src = g_new (guint16, n_pixels);
+    dst = g_new (guint16, n_pixels);
+
+    for (gsize i = 0; i < n_pixels; i++)
+        src[i] = (guint16) ((i * 2654435761u) >> 7) & decoder->mask;
+
+    // The first pass only warms up caches and page tables
+    expand (decoder, src, dst, n_pixels);
+    start = g_get_monotonic_time ();
+
+    for (guint i = 0; i < n_frames; i++)
+        expand (decoder, src, dst, n_pixels);
+
+    elapsed = MAX (g_get_monotonic_time () - start, 1);
+    g_free (src);
+    g_free (dst);
+
+    return (gdouble) n_pixels * n_frames / elapsed * G_USEC_PER_SEC;
+}
+
+void
+uca_pcowin_decoder_get_stats (UcaPcowinDecoder *decoder, UcaPcowinDecoderStats *stats)
+{
+    g_mutex_lock (&decoder->lock);
+    stats->n_frames = decoder->n_frames;
+    stats->n_pixels = decoder->n_pixels;
+    stats->throughput = decoder->time_spent > 0 ? (gdouble) decoder->n_pixels / decoder->time_spent * G_USEC_PER_SEC : 0.0;
+    g_mutex_unlock (&decoder->lock);
+    stats->simd = uca_pcowin_decoder_has_simd ();
+}
+
+void
+uca_pcowin_decoder_reset_stats (UcaPcowinDecoder *decoder)
+{
+    g_mutex_lock (&decoder->lock);
+    decoder->n_frames = 0;
+    decoder->n_pixels = 0;
+    decoder->time_spent = 0;
+    g_mutex_unlock (&decoder->lock);
+}
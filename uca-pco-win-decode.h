@@ -0,0 +1,59 @@
+/*
+Copyright (C) 2016  Sai Sasidhar Maddali <sai.sasidhar92@gmail.com>
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+
+#ifndef __UCA_PCOWIN_DECODE_H
+#define __UCA_PCOWIN_DECODE_H
+
+#include <glib.h>
+
+G_BEGIN_DECLS
+
+/*
+ * Decoding work so far. @throughput is in pixels per second of time spent
+ * decoding, @simd is TRUE if the AVX2 kernel is used.
+ */
+typedef struct {
+    guint64 n_frames;
+    guint64 n_pixels;
+    gdouble throughput;
+    gboolean simd;
+} UcaPcowinDecoderStats;
+
+typedef struct _UcaPcowinDecoder UcaPcowinDecoder;
+
+UcaPcowinDecoder   *uca_pcowin_decoder_new          (guint               code_bits);
+void                uca_pcowin_decoder_free         (UcaPcowinDecoder   *decoder);
+gboolean            uca_pcowin_decoder_load_table   (UcaPcowinDecoder   *decoder,
+                                                     const gchar        *filename,
+                                                     GError            **error);
+void                uca_pcowin_decoder_expand       (UcaPcowinDecoder   *decoder,
+                                                     const guint16      *src,
+                                                     guint16            *dst,
+                                                     gsize               n_pixels);
+gdouble             uca_pcowin_decoder_benchmark    (UcaPcowinDecoder   *decoder,
+                                                     gsize               n_pixels,
+                                                     guint               n_frames);
+void                uca_pcowin_decoder_get_stats    (UcaPcowinDecoder   *decoder,
+                                                     UcaPcowinDecoderStats *stats);
+void                uca_pcowin_decoder_reset_stats  (UcaPcowinDecoder   *decoder);
+gboolean            uca_pcowin_decoder_has_simd     (void);
+
+G_END_DECLS
+
+#endif
@@ -0,0 +1,258 @@
+/**
+Copyright (C) 2016  Sai Sasidhar Maddali <sai.sasidhar92@gmail.com>
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+**/
+
+#include <glib/gstdio.h>
+#include <string.h>
+#include <windows.h>
+
+#include "uca-pco-win-camera.h"
+#include "uca-pco-win-dump.h"
+
+#define DUMP_ALIGNMENT  4096
+
+struct _UcaPcowinDumpWriter {
+    FILE *fp;
+    UcaPcowinDumpHeader header;
+    GArray *index;
+    guint8 *padding;
+    gsize frame_size;
+};
+
+struct _UcaPcowinDump {
+    HANDLE file;
+    HANDLE mapping;
+    const guint8 *base;
+    gsize size;
+    const UcaPcowinDumpHeader *header;
+    const UcaPcowinDumpIndexEntry *index;
+    guint64 frame_size;
+};
+
+static guint64
+align (guint64 value)
+{
+    return (value + DUMP_ALIGNMENT - 1) & ~((guint64) DUMP_ALIGNMENT - 1);
+}
+
+static void
+set_dump_error (GError **error, const gchar *message, const gchar *filename)
+{
+    g_set_error (error, UCA_PCOWIN_CAMERA_ERROR, UCA_PCOWIN_CAMERA_ERROR_GENERAL,
+                 "%s `%s'", message, filename);
+}
+
+UcaPcowinDumpWriter *
+uca_pcowin_dump_writer_new (const gchar *filename, const UcaPcowinDumpHeader *header, GError **error)
+{
+    UcaPcowinDumpWriter *writer;
+
+    g_return_val_if_fail (filename != NULL && header != NULL, NULL);
+
+    writer = g_new0 (UcaPcowinDumpWriter, 1);
+    writer->fp = g_fopen (filename, "wb");
+
+    if (writer->fp == NULL) {
+        set_dump_error (error, "Could not create camRAM dump", filename);
+        g_free (writer);
+        return NULL;
+    }
+
+    writer->header = *header;
+    memcpy (writer->header.magic, UCA_PCOWIN_DUMP_MAGIC, sizeof (UCA_PCOWIN_DUMP_MAGIC));
+    writer->header.version = UCA_PCOWIN_DUMP_VERSION;
+    writer->header.header_size = DUMP_ALIGNMENT;
+    writer->header.n_frames = 0;
+    writer->header.frames_offset = DUMP_ALIGNMENT;
+    writer->frame_size = (gsize) header->width * header->height * header->bytes_per_pixel;
+    writer->header.frame_stride = (guint32) align (writer->frame_size);
+    writer->index = g_array_new (FALSE, FALSE, sizeof (UcaPcowinDumpIndexEntry));
+    writer->padding = g_malloc0 (DUMP_ALIGNMENT);
+
+    // The header is rewritten with the final frame count and index offset when finishing
+    if (fwrite (writer->padding, DUMP_ALIGNMENT, 1, writer->fp) != 1) {
+        set_dump_error (error, "Could not write camRAM dump", filename);
+        fclose (writer->fp);
+        writer->fp = NULL;
+        uca_pcowin_dump_writer_finish (writer, NULL);
+        return NULL;
+    }
+
+    return writer;
+}
+
+gboolean
+uca_pcowin_dump_writer_append (UcaPcowinDumpWriter *writer, gconstpointer frame,
+                               guint32 image_index, guint32 image_number, gint64 timestamp, GError **error)
+{
+    UcaPcowinDumpIndexEntry entry;
+    gsize padding = writer->header.frame_stride - writer->frame_size;
+
+    entry.image_index = image_index;
+    entry.image_number = image_number;
+    entry.timestamp = timestamp;
+    entry.offset = writer->header.frames_offset + (guint64) writer->header.n_frames * writer->header.frame_stride;
+
+    if (fwrite (frame, writer->frame_size, 1, writer->fp) != 1 ||
+        (padding > 0 && fwrite (writer->padding, padding, 1, writer->fp) != 1)) {
+        g_set_error_literal (error, UCA_PCOWIN_CAMERA_ERROR, UCA_PCOWIN_CAMERA_ERROR_GENERAL,
+                             "Could not write frame to camRAM dump");
+        return FALSE;
+    }
+
+    g_array_append_val (writer->index, entry);
+    writer->header.n_frames++;
+
+    return TRUE;
+}
+
+gboolean
+uca_pcowin_dump_writer_finish (UcaPcowinDumpWriter *writer, GError **error)
+{
+    gboolean success = TRUE;
+
+    if (writer == NULL)
+        return TRUE;
+
+    if (writer->fp != NULL) {
+        writer->header.index_offset = writer->header.frames_offset + (guint64) writer->header.n_frames * writer->header.frame_stride;
+
+        if ((writer->index->len > 0 &&
+             fwrite (writer->index->data, sizeof (UcaPcowinDumpIndexEntry), writer->index->len, writer->fp) != writer->index->len) ||
+            fseek (writer->fp, 0, SEEK_SET) != 0 ||
+            fwrite (&writer->header, sizeof (UcaPcowinDumpHeader), 1, writer->fp) != 1) {
+            g_set_error_literal (error, UCA_PCOWIN_CAMERA_ERROR, UCA_PCOWIN_CAMERA_ERROR_GENERAL,
+                                 "Could not finish camRAM dump");
+            success = FALSE;
+        }
+
+        if (fclose (writer->fp) != 0 && success) {
+            g_set_error_literal (error, UCA_PCOWIN_CAMERA_ERROR, UCA_PCOWIN_CAMERA_ERROR_GENERAL,
+                                 "Could not close camRAM dump");
+            success = FALSE;
+        }
+    }
+
+    g_array_free (writer->index, TRUE);
+    g_free (writer->padding);
+    g_free (writer);
+
+    return success;
+}
+
+UcaPcowinDump *
+uca_pcowin_dump_open (const gchar *filename, GError **error)
+{
+    UcaPcowinDump *dump;
+    LARGE_INTEGER size;
+
+    dump = g_new0 (UcaPcowinDump, 1);
+    dump->file = CreateFileA (filename, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING,
+                              FILE_ATTRIBUTE_NORMAL, NULL);
+
+    if (dump->file == INVALID_HANDLE_VALUE) {
+        dump->file = NULL;
+        set_dump_error (error, "Could not open camRAM dump", filename);
+        uca_pcowin_dump_close (dump);
+        return NULL;
+    }
+
+    if (!GetFileSizeEx (dump->file, &size) || (guint64) size.QuadPart < sizeof (UcaPcowinDumpHeader)) {
+        set_dump_error (error, "Truncated camRAM dump", filename);
+        uca_pcowin_dump_close (dump);
+        return NULL;
+    }
+
+    dump->size = (gsize) size.QuadPart;
+    dump->mapping = CreateFileMappingA (dump->file, NULL, PAGE_READONLY, 0, 0, NULL);
+    dump->base = dump->mapping ? MapViewOfFile (dump->mapping, FILE_MAP_READ, 0, 0, 0) : NULL;
+
+    if (dump->base == NULL) {
+        set_dump_error (error, "Could not map camRAM dump", filename);
+        uca_pcowin_dump_close (dump);
+        return NULL;
+    }
+
+    // The file size was checked against the header size before mapping
+    dump->header = (const UcaPcowinDumpHeader *) dump->base;
+
+    if (memcmp (dump->header->magic, UCA_PCOWIN_DUMP_MAGIC, sizeof (UCA_PCOWIN_DUMP_MAGIC)) != 0 ||
+        dump->header->version != UCA_PCOWIN_DUMP_VERSION ||
+        dump->header->index_offset > dump->size ||
+        dump->header->n_frames > (dump->size - dump->header->index_offset) / sizeof (UcaPcowinDumpIndexEntry)) {
+        set_dump_error (error, "Not a valid camRAM dump", filename);
+        uca_pcowin_dump_close (dump);
+        return NULL;
+    }
+
+    dump->index = (const UcaPcowinDumpIndexEntry *) (dump->base + dump->header->index_offset);
+    dump->frame_size = (guint64) dump->header->width * dump->header->height * dump->header->bytes_per_pixel;
+
+    // Frames are handed out in place, so every one of them has to lie within the file
+    for (guint i = 0; i < dump->header->n_frames; i++) {
+        if (dump->index[i].offset > dump->size || dump->frame_size > dump->size - dump->index[i].offset) {
+            set_dump_error (error, "Corrupt frame index in camRAM dump", filename);
+            uca_pcowin_dump_close (dump);
+            return NULL;
+        }
+    }
+
+    return dump;
+}
+
+void
+uca_pcowin_dump_close (UcaPcowinDump *dump)
+{
+    if (dump == NULL)
+        return;
+
+    if (dump->base != NULL)
+        UnmapViewOfFile (dump->base);
+
+    if (dump->mapping != NULL)
+        CloseHandle (dump->mapping);
+
+    if (dump->file != NULL)
+        CloseHandle (dump->file);
+
+    g_free (dump);
+}
+
+const UcaPcowinDumpHeader *
+uca_pcowin_dump_get_header (UcaPcowinDump *dump)
+{
+    return dump->header;
+}
+
+guint64
+uca_pcowin_dump_get_frame_size (UcaPcowinDump *dump)
+{
+    return dump->frame_size;
+}
+
+gconstpointer
+uca_pcowin_dump_get_frame (UcaPcowinDump *dump, guint index, const UcaPcowinDumpIndexEntry **entry)
+{
+    if (index >= dump->header->n_frames)
+        return NULL;
+
+    if (entry != NULL)
+        *entry = &dump->index[index];
+
+    return dump->base + dump->index[index].offset;
+}
@@ -0,0 +1,98 @@
+/*
+Copyright (C) 2016  Sai Sasidhar Maddali <sai.sasidhar92@gmail.com>
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+
+#ifndef __UCA_PCOWIN_DUMP_H
+#define __UCA_PCOWIN_DUMP_H
+
+#include <glib.h>
+
+G_BEGIN_DECLS
+
+/*
+ * A camRAM dump is a single file made of a UcaPcowinDumpHeader padded to
+ * header_size bytes, n_frames frames of frame_stride bytes each starting at
+ * frames_offset and n_frames UcaPcowinDumpIndexEntry records at index_offset.
+ * All offsets are page aligned so the file can be mapped and frames handed
+ * out in place.
+ */
+#define UCA_PCOWIN_DUMP_MAGIC       "PCODUMP"
+#define UCA_PCOWIN_DUMP_VERSION     1
+
+typedef struct {
+    gchar magic[8];
+    guint32 version;
+    guint32 header_size;
+
+    guint32 width;
+    guint32 height;
+    guint32 bit_per_pixel;
+    guint32 bytes_per_pixel;
+    guint32 n_frames;
+    guint32 frame_stride;
+    guint64 frames_offset;
+    guint64 index_offset;
+
+    // Camera and settings the segment was recorded with
+    gchar camera_version[64];
+    guint32 camera_type;
+    guint32 ram_segment;
+    guint32 roi_x, roi_y, roi_width, roi_height;
+    guint32 horizontal_binning, vertical_binning;
+    guint32 pixelrate;
+    guint32 timestamp_mode;
+    gdouble exposure_time;
+    gdouble frames_per_second;
+    gint64 created;
+} UcaPcowinDumpHeader;
+
+typedef struct {
+    guint32 image_index;
+    guint32 image_number;
+    gint64 timestamp;
+    guint64 offset;
+} UcaPcowinDumpIndexEntry;
+
+typedef struct _UcaPcowinDumpWriter UcaPcowinDumpWriter;
+typedef struct _UcaPcowinDump UcaPcowinDump;
+
+UcaPcowinDumpWriter *uca_pcowin_dump_writer_new     (const gchar                *filename,
+                                                     const UcaPcowinDumpHeader  *header,
+                                                     GError                    **error);
+gboolean            uca_pcowin_dump_writer_append   (UcaPcowinDumpWriter        *writer,
+                                                     gconstpointer               frame,
+                                                     guint32                     image_index,
+                                                     guint32                     image_number,
+                                                     gint64                      timestamp,
+                                                     GError                    **error);
+gboolean            uca_pcowin_dump_writer_finish   (UcaPcowinDumpWriter        *writer,
+                                                     GError                    **error);
+
+UcaPcowinDump      *uca_pcowin_dump_open            (const gchar                *filename,
+                                                     GError                    **error);
+void                uca_pcowin_dump_close           (UcaPcowinDump              *dump);
+const UcaPcowinDumpHeader *
+                    uca_pcowin_dump_get_header      (UcaPcowinDump              *dump);
+guint64             uca_pcowin_dump_get_frame_size  (UcaPcowinDump              *dump);
+gconstpointer       uca_pcowin_dump_get_frame       (UcaPcowinDump              *dump,
+                                                     guint                       index,
+                                                     const UcaPcowinDumpIndexEntry **entry);
+
+G_END_DECLS
+
+#endif
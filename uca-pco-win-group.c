@@ -0,0 +1,512 @@
+/**
+Copyright (C) 2016  Sai Sasidhar Maddali <sai.sasidhar92@gmail.com>
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+**/
+
+#include <string.h>
+#include <uca/uca-camera.h>
+
+#include "uca-pco-win-group.h"
+
+// Frames a camera may run ahead of the slowest one or of the consumer before they are given up
+#define MAX_PENDING_FRAMES  256
+
+// Backoff while a short grab-timeout keeps returning without a frame
+#define MIN_IDLE_SLEEP_US   100
+#define MAX_IDLE_SLEEP_US   10000
+
+typedef struct {
+    guint camera;
+    guint64 key;
+    gpointer data;
+} GroupFrame;
+
+typedef struct {
+    UcaPcowinGroup *group;
+    UcaPcowinCamera *camera;
+    guint index;
+    GThread *thread;
+    gsize frame_size;
+
+    // Only touched by the consumer in uca_pcowin_group_grab
+    GQueue pending;
+    guint64 last_key;
+    gboolean has_last_key;
+
+    // Frames pushed to the group queue and not yet popped, under the group lock
+    GQueue queued;
+
+    guint64 unmatched;
+    guint64 undecodable;
+} GroupMember;
+
+struct _UcaPcowinGroup {
+    GroupMember *members;
+    guint n_members;
+    UcaPcowinGroupMatch match;
+    guint64 tolerance;
+
+    GAsyncQueue *queue;
+    gint running;
+
+    GMutex lock;
+    GError *error;
+    guint64 matched;
+};
+
+static void
+group_frame_free (GroupFrame *frame)
+{
+    g_free (frame->data);
+    g_free (frame);
+}
+
+/*
+ * Hands @frame on to the consumer. A camera that runs too far ahead of a
+ * stalled consumer gives up its oldest queued frame, the frame itself is
+ * still popped but without data.
+ */
+static void
+push_frame (UcaPcowinGroup *group, GroupMember *member, GroupFrame *frame)
+{
+    g_mutex_lock (&group->lock);
+
+    if (g_queue_get_length (&member->queued) >= MAX_PENDING_FRAMES) {
+        GroupFrame *oldest = g_queue_pop_head (&member->queued);
+
+        g_free (oldest->data);
+        oldest->data = NULL;
+        member->unmatched++;
+    }
+
+    g_queue_push_tail (&member->queued, frame);
+
+    // Pushed under the lock so that the group queue keeps the order of queued
+    g_async_queue_push (group->queue, frame);
+    g_mutex_unlock (&group->lock);
+}
+
+/*
+ * Drains one camera so that a slow link only delays its own frames. Frames
+ * are passed on to the consumer tagged with the decoded match key.
+ */
+static gpointer
+drain_camera (GroupMember *member)
+{
+    UcaPcowinGroup *group = member->group;
+    gpointer data = NULL;
+    gulong idle_sleep = 0;
+
+    while (g_atomic_int_get (&group->running)) {
+        GroupFrame *frame;
+        GError *error = NULL;
+        guint32 image_number;
+        gint64 timestamp, start;
+
+        // Kept across timeouts and undecodable frames, only handed on with a frame
+        if (data == NULL)
+            data = g_malloc (member->frame_size);
+
+        start = g_get_monotonic_time ();
+
+        if (!uca_camera_grab (UCA_CAMERA (member->camera), data, &error)) {
+            // No trigger within grab-timeout is not an error for the group
+            if (g_error_matches (error, UCA_PCOWIN_CAMERA_ERROR, UCA_PCOWIN_CAMERA_ERROR_TIMEOUT)) {
+                g_error_free (error);
+
+                // A short grab-timeout returns right away, sleep instead of spinning
+                if (g_get_monotonic_time () - start < MAX_IDLE_SLEEP_US) {
+                    idle_sleep = CLAMP (idle_sleep * 2, MIN_IDLE_SLEEP_US, MAX_IDLE_SLEEP_US);
+                    g_usleep (idle_sleep);
+                }
+
+                continue;
+            }
+
+            g_mutex_lock (&group->lock);
+
+            if (group->error == NULL)
+                group->error = error;
+            else
+                g_error_free (error);
+
+            g_mutex_unlock (&group->lock);
+
+            // Wakes up the consumer so that it reports the error right away
+            frame = g_new0 (GroupFrame, 1);
+            frame->camera = member->index;
+            g_async_queue_push (group->queue, frame);
+            break;
+        }
+
+        idle_sleep = 0;
+
+        if (!uca_pcowin_camera_decode_timestamp (member->camera, data, &image_number, &timestamp)) {
+            g_mutex_lock (&group->lock);
+            member->undecodable++;
+            g_mutex_unlock (&group->lock);
+            continue;
+        }
+
+        frame = g_new0 (GroupFrame, 1);
+        frame->camera = member->index;
+        frame->key = group->match == UCA_PCOWIN_GROUP_MATCH_COUNTER ? image_number : (guint64) timestamp;
+        frame->data = data;
+        data = NULL;
+        push_frame (group, member, frame);
+    }
+
+    g_free (data);
+
+    return NULL;
+}
+
+static void
+drop_pending (UcaPcowinGroup *group, GroupMember *member)
+{
+    group_frame_free (g_queue_pop_head (&member->pending));
+
+    g_mutex_lock (&group->lock);
+    member->unmatched++;
+    g_mutex_unlock (&group->lock);
+}
+
+/*
+ * Keys increase monotonically per camera, so a pending frame whose key is
+ * below the newest head of another camera can never be matched anymore.
+ */
+static gboolean
+try_match (UcaPcowinGroup *group, gpointer *frames, guint64 *key)
+{
+    gboolean dropped = TRUE;
+    guint64 max_key = 0;
+
+    while (dropped) {
+        dropped = FALSE;
+        max_key = 0;
+
+        for (guint i = 0; i < group->n_members; i++) {
+            GroupFrame *head = g_queue_peek_head (&group->members[i].pending);
+
+            if (head == NULL)
+                return FALSE;
+
+            max_key = MAX (max_key, head->key);
+        }
+
+        for (guint i = 0; i < group->n_members; i++) {
+            GroupMember *member = &group->members[i];
+            GroupFrame *head;
+
+            while ((head = g_queue_peek_head (&member->pending)) != NULL && head->key + group->tolerance < max_key) {
+                drop_pending (group, member);
+                dropped = TRUE;
+            }
+        }
+    }
+
+    for (guint i = 0; i < group->n_members; i++) {
+        GroupFrame *head = g_queue_pop_head (&group->members[i].pending);
+
+        frames[i] = head->data;
+        head->data = NULL;
+        group_frame_free (head);
+    }
+
+    if (key)
+        *key = max_key;
+
+    g_mutex_lock (&group->lock);
+    group->matched++;
+    g_mutex_unlock (&group->lock);
+
+    return TRUE;
+}
+
+static void
+add_pending (UcaPcowinGroup *group, GroupFrame *frame)
+{
+    GroupMember *member = &group->members[frame->camera];
+
+    // A key that does not increase means the camera repeated or reset its counter
+    if (member->has_last_key && frame->key <= member->last_key) {
+        group_frame_free (frame);
+        g_mutex_lock (&group->lock);
+        member->unmatched++;
+        g_mutex_unlock (&group->lock);
+        return;
+    }
+
+    member->last_key = frame->key;
+    member->has_last_key = TRUE;
+    g_queue_push_tail (&member->pending, frame);
+
+    if (g_queue_get_length (&member->pending) > MAX_PENDING_FRAMES)
+        drop_pending (group, member);
+}
+
+/**
+ * uca_pcowin_group_new:
+ * @cameras: (array length=n_cameras): Cameras sharing a hardware trigger
+ * @n_cameras: Number of cameras
+ * @match: Key that frames are matched on
+ * @tolerance: Largest key difference of matching frames, e.g. in
+ *  microseconds for %UCA_PCOWIN_GROUP_MATCH_TIMESTAMP
+ *
+ * Returns: A new group holding a reference on each camera.
+ */
+UcaPcowinGroup *
+uca_pcowin_group_new (UcaPcowinCamera **cameras, guint n_cameras, UcaPcowinGroupMatch match, guint64 tolerance)
+{
+    UcaPcowinGroup *group;
+
+    g_return_val_if_fail (cameras != NULL && n_cameras > 0, NULL);
+
+    group = g_new0 (UcaPcowinGroup, 1);
+    group->members = g_new0 (GroupMember, n_cameras);
+    group->n_members = n_cameras;
+    group->match = match;
+    group->tolerance = tolerance;
+    group->queue = g_async_queue_new ();
+    g_mutex_init (&group->lock);
+
+    for (guint i = 0; i < n_cameras; i++) {
+        group->members[i].group = group;
+        group->members[i].camera = g_object_ref (cameras[i]);
+        group->members[i].index = i;
+        g_queue_init (&group->members[i].pending);
+        g_queue_init (&group->members[i].queued);
+    }
+
+    return group;
+}
+
+void
+uca_pcowin_group_free (UcaPcowinGroup *group)
+{
+    if (group == NULL)
+        return;
+
+    uca_pcowin_group_stop (group);
+
+    for (guint i = 0; i < group->n_members; i++)
+        g_object_unref (group->members[i].camera);
+
+    g_async_queue_unref (group->queue);
+    g_mutex_clear (&group->lock);
+    g_free (group->members);
+    g_free (group);
+}
+
+/**
+ * uca_pcowin_group_start:
+ * @group: A #UcaPcowinGroup
+ * @error: Location for a #GError or %NULL
+ *
+ * Starts one thread per camera draining its frames. All cameras must be
+ * recording and stamp frames with a binary timestamp. For counter matching
+ * they must also be armed before the first trigger so that their image
+ * counters agree.
+ *
+ * Returns: %TRUE if the threads were started.
+ */
+gboolean
+uca_pcowin_group_start (UcaPcowinGroup *group, GError **error)
+{
+    for (guint i = 0; i < group->n_members; i++) {
+        GroupMember *member = &group->members[i];
+        UcaPcoCameraTimestamp timestamp_mode;
+        gboolean is_recording;
+        guint width, height;
+
+        g_object_get (member->camera,
+                      "is-recording", &is_recording,
+                      "timestamp-mode", &timestamp_mode,
+                      "roi-width", &width,
+                      "roi-height", &height,
+                      NULL);
+
+        if (!is_recording) {
+            g_set_error (error, UCA_PCOWIN_CAMERA_ERROR, UCA_PCOWIN_CAMERA_ERROR_GENERAL,
+                         "Camera %u of the group is not recording", i);
+            return FALSE;
+        }
+
+        if (timestamp_mode != UCA_PCO_CAMERA_TIMESTAMP_BINARY && timestamp_mode != UCA_PCO_CAMERA_TIMESTAMP_BINARYANDASCII) {
+            g_set_error (error, UCA_PCOWIN_CAMERA_ERROR, UCA_PCOWIN_CAMERA_ERROR_UNSUPPORTED,
+                         "Camera %u of the group does not stamp frames with a binary timestamp", i);
+            return FALSE;
+        }
+
+        member->frame_size = (gsize) width * height * 2;
+        member->has_last_key = FALSE;
+    }
+
+    g_clear_error (&group->error);
+    g_atomic_int_set (&group->running, TRUE);
+
+    for (guint i = 0; i < group->n_members; i++) {
+        GroupMember *member = &group->members[i];
+
+        member->thread = g_thread_try_new ("pco-group", (GThreadFunc) drain_camera, member, error);
+
+        if (member->thread == NULL) {
+            uca_pcowin_group_stop (group);
+            return FALSE;
+        }
+    }
+
+    return TRUE;
+}
+
+/*
+ * Joins the camera threads and discards all frames that were not matched yet.
+ * Cameras keep recording.
+ */
+void
+uca_pcowin_group_stop (UcaPcowinGroup *group)
+{
+    GroupFrame *frame;
+
+    g_atomic_int_set (&group->running, FALSE);
+
+    for (guint i = 0; i < group->n_members; i++) {
+        GroupMember *member = &group->members[i];
+
+        if (member->thread != NULL) {
+            g_thread_join (member->thread);
+            member->thread = NULL;
+        }
+
+        while ((frame = g_queue_pop_head (&member->pending)) != NULL)
+            group_frame_free (frame);
+
+        // The frames themselves are freed from the group queue below
+        g_queue_clear (&member->queued);
+    }
+
+    while ((frame = g_async_queue_try_pop (group->queue)) != NULL)
+        group_frame_free (frame);
+}
+
+/**
+ * uca_pcowin_group_grab:
+ * @group: A #UcaPcowinGroup
+ * @frames: (out caller-allocates) (array): Receives one frame per camera,
+ *  each to be freed with g_free()
+ * @key: (out): Match key of the frame set
+ * @timeout_ms: Longest time to wait for a complete frame set
+ * @error: Location for a #GError or %NULL
+ *
+ * Waits for the next set of frames that belong to the same trigger. Frames
+ * without a partner on every other camera are discarded and counted by
+ * uca_pcowin_group_get_unmatched(). Must only be called from one thread.
+ *
+ * Returns: %TRUE if @frames holds a matched set.
+ */
+gboolean
+uca_pcowin_group_grab (UcaPcowinGroup *group, gpointer *frames, guint64 *key, guint timeout_ms, GError **error)
+{
+    gint64 end_time = g_get_monotonic_time () + (gint64) timeout_ms * 1000;
+
+    while (!try_match (group, frames, key)) {
+        GroupFrame *frame;
+        gint64 remaining;
+
+        g_mutex_lock (&group->lock);
+
+        if (group->error != NULL) {
+            g_propagate_error (error, g_error_copy (group->error));
+            g_mutex_unlock (&group->lock);
+            return FALSE;
+        }
+
+        g_mutex_unlock (&group->lock);
+
+        remaining = end_time - g_get_monotonic_time ();
+        frame = remaining > 0 ? g_async_queue_timeout_pop (group->queue, (guint64) remaining) : NULL;
+
+        if (frame == NULL) {
+            g_set_error (error, UCA_PCOWIN_CAMERA_ERROR, UCA_PCOWIN_CAMERA_ERROR_TIMEOUT,
+                         "No matching frame set within %u ms", timeout_ms);
+            return FALSE;
+        }
+
+        // push_frame may still give up the frame until it left queued
+        g_mutex_lock (&group->lock);
+
+        if (frame->data != NULL)
+            g_queue_pop_head (&group->members[frame->camera].queued);
+
+        g_mutex_unlock (&group->lock);
+
+        // Error wake-ups and frames given up by push_frame carry no data
+        if (frame->data == NULL)
+            group_frame_free (frame);
+        else
+            add_pending (group, frame);
+    }
+
+    return TRUE;
+}
+
+guint64
+uca_pcowin_group_get_matched (UcaPcowinGroup *group)
+{
+    guint64 matched;
+
+    g_mutex_lock (&group->lock);
+    matched = group->matched;
+    g_mutex_unlock (&group->lock);
+
+    return matched;
+}
+
+/*
+ * Frames of @camera that were discarded because no other camera delivered a
+ * frame with the same key.
+ */
+guint64
+uca_pcowin_group_get_unmatched (UcaPcowinGroup *group, guint camera)
+{
+    guint64 unmatched;
+
+    g_return_val_if_fail (camera < group->n_members, 0);
+
+    g_mutex_lock (&group->lock);
+    unmatched = group->members[camera].unmatched;
+    g_mutex_unlock (&group->lock);
+
+    return unmatched;
+}
+
+/*
+ * Grabs of @camera that did not carry a valid binary timestamp.
+ */
+guint64
+uca_pcowin_group_get_undecodable (UcaPcowinGroup *group, guint camera)
+{
+    guint64 undecodable;
+
+    g_return_val_if_fail (camera < group->n_members, 0);
+
+    g_mutex_lock (&group->lock);
+    undecodable = group->members[camera].undecodable;
+    g_mutex_unlock (&group->lock);
+
+    return undecodable;
+}
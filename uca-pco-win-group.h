@@ -0,0 +1,62 @@
+/*
+Copyright (C) 2016  Sai Sasidhar Maddali <sai.sasidhar92@gmail.com>
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+
+#ifndef __UCA_PCOWIN_GROUP_H
+#define __UCA_PCOWIN_GROUP_H
+
+#include <glib.h>
+#include "uca-pco-win-camera.h"
+
+G_BEGIN_DECLS
+
+/*
+ * Key that frames of the cameras in a group are matched on. Both are decoded
+ * from the binary timestamp, so "timestamp-mode" must be binary or binary and
+ * ASCII on every camera.
+ */
+typedef enum {
+    UCA_PCOWIN_GROUP_MATCH_COUNTER,
+    UCA_PCOWIN_GROUP_MATCH_TIMESTAMP
+} UcaPcowinGroupMatch;
+
+typedef struct _UcaPcowinGroup UcaPcowinGroup;
+
+UcaPcowinGroup     *uca_pcowin_group_new            (UcaPcowinCamera   **cameras,
+                                                     guint               n_cameras,
+                                                     UcaPcowinGroupMatch match,
+                                                     guint64             tolerance);
+void                uca_pcowin_group_free           (UcaPcowinGroup     *group);
+gboolean            uca_pcowin_group_start          (UcaPcowinGroup     *group,
+                                                     GError            **error);
+void                uca_pcowin_group_stop           (UcaPcowinGroup     *group);
+gboolean            uca_pcowin_group_grab           (UcaPcowinGroup     *group,
+                                                     gpointer           *frames,
+                                                     guint64            *key,
+                                                     guint               timeout_ms,
+                                                     GError            **error);
+guint64             uca_pcowin_group_get_matched    (UcaPcowinGroup     *group);
+guint64             uca_pcowin_group_get_unmatched  (UcaPcowinGroup     *group,
+                                                     guint               camera);
+guint64             uca_pcowin_group_get_undecodable
+                                                    (UcaPcowinGroup     *group,
+                                                     guint               camera);
+
+G_END_DECLS
+
+#endif
@@ -0,0 +1,322 @@
+/**
+Copyright (C) 2016  Sai Sasidhar Maddali <sai.sasidhar92@gmail.com>
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+**/
+
+#include <minwindef.h>
+#include <sc2_SDKStructures.h>
+#include <sc2_defs.h>
+#include <SC2_CamExport.h>
+#include <PCO_err.h>
+#include <windows.h>
+
+#include "uca-pco-win-health.h"
+
+struct _UcaPcowinHealth {
+    HANDLE pco;
+    UcaPcowinScheduler *scheduler;
+    GThread *thread;
+    GMutex lock;
+    GCond cond;
+    gboolean quit;
+
+    // Poll intervals in milliseconds, 0 during recording suspends polling
+    guint idle_interval;
+    guint recording_interval;
+    gboolean recording;
+
+    UcaPcowinHealthFunc changed;
+    gpointer user_data;
+
+    // Ring of the most recent samples, latest is at (first + n_samples - 1)
+    UcaPcowinHealthSample *history;
+    guint history_length;
+    guint first;
+    guint n_samples;
+
+    gboolean has_status;
+    guint32 warnings;
+    guint32 errors;
+    guint32 status;
+};
+
+static void
+append_sample (UcaPcowinHealth *health, const UcaPcowinHealthSample *sample)
+{
+    if (health->n_samples < health->history_length) {
+        health->history[(health->first + health->n_samples) % health->history_length] = *sample;
+        health->n_samples++;
+    }
+    else {
+        health->history[health->first] = *sample;
+        health->first = (health->first + 1) % health->history_length;
+    }
+}
+
+/*
+ * Stores the status bits and reports whether warnings or errors changed since
+ * the last poll. Must be called with the lock held.
+ */
+static gboolean
+update_status (UcaPcowinHealth *health, guint32 warnings, guint32 errors, guint32 status)
+{
+    gboolean changed;
+
+    changed = !health->has_status || warnings != health->warnings || errors != health->errors;
+    changed = changed && (health->has_status || warnings != 0 || errors != 0);
+
+    health->has_status = TRUE;
+    health->warnings = warnings;
+    health->errors = errors;
+    health->status = status;
+
+    return changed;
+}
+
+static gboolean
+poll_camera (UcaPcowinHealth *health, UcaPcowinHealthSample *sample)
+{
+    SHORT sensor, camera, power;
+    DWORD warnings, errors, status;
+
+    if (UCA_PCOWIN_SCHEDULE (health->scheduler, UCA_PCOWIN_PRIORITY_QUERY,
+                             PCO_GetTemperature (health->pco, &sensor, &camera, &power)) != PCO_NOERROR)
+        return FALSE;
+
+    if (UCA_PCOWIN_SCHEDULE (health->scheduler, UCA_PCOWIN_PRIORITY_QUERY,
+                             PCO_GetCameraHealthStatus (health->pco, &warnings, &errors, &status)) != PCO_NOERROR)
+        return FALSE;
+
+    sample->time = g_get_real_time ();
+    sample->sensor_temperature = sensor / 10.0;
+    sample->camera_temperature = camera;
+    sample->power_temperature = power;
+    sample->warnings = warnings;
+    sample->errors = errors;
+    sample->status = status;
+
+    return TRUE;
+}
+
+static gpointer
+run_monitor (UcaPcowinHealth *health)
+{
+    // Polling is never urgent and must not compete with the acquisition threads
+    SetThreadPriority (GetCurrentThread (), THREAD_PRIORITY_BELOW_NORMAL);
+
+    g_mutex_lock (&health->lock);
+
+    while (!health->quit) {
+        UcaPcowinHealthSample sample;
+        gboolean has_sample;
+        gboolean changed = FALSE;
+        gint64 last_poll;
+
+        last_poll = g_get_monotonic_time ();
+        g_mutex_unlock (&health->lock);
+        has_sample = poll_camera (health, &sample);
+        g_mutex_lock (&health->lock);
+
+        if (has_sample) {
+            append_sample (health, &sample);
+            changed = update_status (health, sample.warnings, sample.errors, sample.status);
+        }
+
+        if (changed && health->changed != NULL) {
+            g_mutex_unlock (&health->lock);
+            health->changed (&sample, health->user_data);
+            g_mutex_lock (&health->lock);
+        }
+
+        // Intervals and recording state may change while waiting
+        while (!health->quit) {
+            guint interval = health->recording ? health->recording_interval : health->idle_interval;
+
+            if (interval == 0)
+                g_cond_wait (&health->cond, &health->lock);
+            else if (!g_cond_wait_until (&health->cond, &health->lock, last_poll + (gint64) interval * G_TIME_SPAN_MILLISECOND))
+                break;
+        }
+    }
+
+    g_mutex_unlock (&health->lock);
+
+    return NULL;
+}
+
+UcaPcowinHealth *
+uca_pcowin_health_new (gpointer pco_handle, UcaPcowinScheduler *scheduler, guint history_length, UcaPcowinHealthFunc changed, gpointer user_data)
+{
+    UcaPcowinHealth *health;
+
+    health = g_new0 (UcaPcowinHealth, 1);
+    health->pco = pco_handle;
+    health->scheduler = scheduler;
+    health->changed = changed;
+    health->user_data = user_data;
+    health->idle_interval = 1000;
+    health->history_length = MAX (history_length, 1);
+    health->history = g_new0 (UcaPcowinHealthSample, health->history_length);
+    g_mutex_init (&health->lock);
+    g_cond_init (&health->cond);
+
+    return health;
+}
+
+void
+uca_pcowin_health_free (UcaPcowinHealth *health)
+{
+    if (health == NULL)
+        return;
+
+    uca_pcowin_health_stop (health);
+    g_mutex_clear (&health->lock);
+    g_cond_clear (&health->cond);
+    g_free (health->history);
+    g_free (health);
+}
+
+// Replaces the camera handle after a reconnect, the monitor must be stopped
+void
+uca_pcowin_health_set_handle (UcaPcowinHealth *health, gpointer pco_handle)
+{
+    g_return_if_fail (health->thread == NULL);
+    health->pco = pco_handle;
+}
+
+gboolean
+uca_pcowin_health_start (UcaPcowinHealth *health, GError **error)
+{
+    if (health->thread != NULL)
+        return TRUE;
+
+    health->quit = FALSE;
+    health->thread = g_thread_try_new ("pco-health", (GThreadFunc) run_monitor, health, error);
+
+    return health->thread != NULL;
+}
+
+void
+uca_pcowin_health_stop (UcaPcowinHealth *health)
+{
+    if (health->thread == NULL)
+        return;
+
+    g_mutex_lock (&health->lock);
+    health->quit = TRUE;
+    g_cond_signal (&health->cond);
+    g_mutex_unlock (&health->lock);
+
+    g_thread_join (health->thread);
+    health->thread = NULL;
+}
+
+gboolean
+uca_pcowin_health_is_running (UcaPcowinHealth *health)
+{
+    return health->thread != NULL;
+}
+
+void
+uca_pcowin_health_set_intervals (UcaPcowinHealth *health, guint idle_ms, guint recording_ms)
+{
+    g_mutex_lock (&health->lock);
+    health->idle_interval = MAX (idle_ms, 1);
+    health->recording_interval = recording_ms;
+    g_cond_signal (&health->cond);
+    g_mutex_unlock (&health->lock);
+}
+
+// Switches to the recording interval, no camera traffic is caused by this call
+void
+uca_pcowin_health_set_recording (UcaPcowinHealth *health, gboolean recording)
+{
+    g_mutex_lock (&health->lock);
+
+    if (health->recording != recording) {
+        health->recording = recording;
+        g_cond_signal (&health->cond);
+    }
+
+    g_mutex_unlock (&health->lock);
+}
+
+/*
+ * Feeds a health status read elsewhere into the cache, calling the change
+ * function on the caller's thread if warnings or errors changed.
+ */
+void
+uca_pcowin_health_submit_status (UcaPcowinHealth *health, guint32 warnings, guint32 errors, guint32 status)
+{
+    UcaPcowinHealthSample sample = { 0 };
+    gboolean changed;
+
+    g_mutex_lock (&health->lock);
+
+    if (health->n_samples > 0)
+        sample = health->history[(health->first + health->n_samples - 1) % health->history_length];
+
+    changed = update_status (health, warnings, errors, status);
+    g_mutex_unlock (&health->lock);
+
+    if (changed && health->changed != NULL) {
+        sample.time = g_get_real_time ();
+        sample.warnings = warnings;
+        sample.errors = errors;
+        sample.status = status;
+        health->changed (&sample, health->user_data);
+    }
+}
+
+// Returns FALSE if the camera has not been polled yet
+gboolean
+uca_pcowin_health_get_latest (UcaPcowinHealth *health, UcaPcowinHealthSample *sample)
+{
+    gboolean has_sample;
+
+    g_mutex_lock (&health->lock);
+    has_sample = health->n_samples > 0;
+
+    if (has_sample) {
+        *sample = health->history[(health->first + health->n_samples - 1) % health->history_length];
+        sample->warnings = health->warnings;
+        sample->errors = health->errors;
+        sample->status = health->status;
+    }
+
+    g_mutex_unlock (&health->lock);
+
+    return has_sample;
+}
+
+// Copy of the recorded samples, oldest first, to be freed with g_free()
+UcaPcowinHealthSample *
+uca_pcowin_health_get_history (UcaPcowinHealth *health, guint *n_samples)
+{
+    UcaPcowinHealthSample *samples;
+
+    g_mutex_lock (&health->lock);
+    samples = g_new (UcaPcowinHealthSample, MAX (health->n_samples, 1));
+
+    for (guint i = 0; i < health->n_samples; i++)
+        samples[i] = health->history[(health->first + i) % health->history_length];
+
+    *n_samples = health->n_samples;
+    g_mutex_unlock (&health->lock);
+
+    return samples;
+}
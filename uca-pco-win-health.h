@@ -0,0 +1,77 @@
+/*
+Copyright (C) 2016  Sai Sasidhar Maddali <sai.sasidhar92@gmail.com>
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+
+#ifndef __UCA_PCOWIN_HEALTH_H
+#define __UCA_PCOWIN_HEALTH_H
+
+#include <glib.h>
+#include "uca-pco-win-scheduler.h"
+
+G_BEGIN_DECLS
+
+/*
+ * One poll of the camera. @time is the wall clock time in microseconds, the
+ * sensor temperature is in degree Celsius with 0.1 resolution, the camera and
+ * power supply temperatures in whole degrees.
+ */
+typedef struct {
+    gint64 time;
+    gdouble sensor_temperature;
+    gdouble camera_temperature;
+    gdouble power_temperature;
+    guint32 warnings;
+    guint32 errors;
+    guint32 status;
+} UcaPcowinHealthSample;
+
+typedef void (*UcaPcowinHealthFunc) (const UcaPcowinHealthSample *sample,
+                                     gpointer user_data);
+
+typedef struct _UcaPcowinHealth UcaPcowinHealth;
+
+UcaPcowinHealth    *uca_pcowin_health_new           (gpointer            pco_handle,
+                                                     UcaPcowinScheduler *scheduler,
+                                                     guint               history_length,
+                                                     UcaPcowinHealthFunc changed,
+                                                     gpointer            user_data);
+void                uca_pcowin_health_free          (UcaPcowinHealth    *health);
+void                uca_pcowin_health_set_handle    (UcaPcowinHealth    *health,
+                                                     gpointer            pco_handle);
+gboolean            uca_pcowin_health_start         (UcaPcowinHealth    *health,
+                                                     GError            **error);
+void                uca_pcowin_health_stop          (UcaPcowinHealth    *health);
+gboolean            uca_pcowin_health_is_running    (UcaPcowinHealth    *health);
+void                uca_pcowin_health_set_intervals (UcaPcowinHealth    *health,
+                                                     guint               idle_ms,
+                                                     guint               recording_ms);
+void                uca_pcowin_health_set_recording (UcaPcowinHealth    *health,
+                                                     gboolean            recording);
+void                uca_pcowin_health_submit_status (UcaPcowinHealth    *health,
+                                                     guint32             warnings,
+                                                     guint32             errors,
+                                                     guint32             status);
+gboolean            uca_pcowin_health_get_latest    (UcaPcowinHealth    *health,
+                                                     UcaPcowinHealthSample *sample);
+UcaPcowinHealthSample *
+                    uca_pcowin_health_get_history   (UcaPcowinHealth    *health,
+                                                     guint              *n_samples);
+
+G_END_DECLS
+
+#endif
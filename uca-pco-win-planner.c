@@ -0,0 +1,144 @@
+/**
+Copyright (C) 2016  Sai Sasidhar Maddali <sai.sasidhar92@gmail.com>
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+**/
+
+#include "uca-pco-win-planner.h"
+
+// Estimates within this relative distance of the target count as reaching it
+#define FPS_TOLERANCE   1e-3
+
+/*
+ * Readout model: the ADCs convert pixels at the pixel rate each, the rows of
+ * a frame are read one after the other or in pairs, and exposure overlaps
+ * with the readout of the previous frame. The estimate only has to rank
+ * configurations, arming the camera tells the actual frame rate.
+ */
+gdouble
+uca_pcowin_planner_estimate_fps (const UcaPcowinSensorLimits *limits, guint32 pixelrate, guint adcs, guint roi_width, guint roi_height, gdouble exposure)
+{
+    gdouble readout_time;
+    gdouble frame_time;
+
+    if (pixelrate == 0 || adcs == 0)
+        return 0.0;
+
+    readout_time = (gdouble) roi_width * roi_height / ((gdouble) pixelrate * adcs * MAX (limits->rows_in_parallel, 1));
+    frame_time = MAX (readout_time, exposure);
+
+    return frame_time > 0.0 ? 1.0 / frame_time : 0.0;
+}
+
+/*
+ * Tallest ROI, in multiples of the vertical steps, whose estimate reaches
+ * @fps. Returns 0 if even the smallest ROI does not.
+ */
+static guint
+find_roi_height (const UcaPcowinSensorLimits *limits, guint32 pixelrate, guint adcs, guint roi_width, guint max_height, gdouble fps, gdouble exposure)
+{
+    guint step = MAX (limits->roi_vertical_steps, 1) * MAX (limits->rows_in_parallel, 1);
+    guint height = max_height / step * step;
+
+    for (; height >= MAX (limits->min_roi_height, step); height -= step) {
+        if (uca_pcowin_planner_estimate_fps (limits, pixelrate, adcs, roi_width, height, exposure) >= fps * (1.0 - FPS_TOLERANCE))
+            return height;
+    }
+
+    return 0;
+}
+
+static gboolean
+is_feasible (const UcaPcowinFrameRatePlan *plan, gdouble fps)
+{
+    return plan->estimated_fps >= fps * (1.0 - FPS_TOLERANCE);
+}
+
+/*
+ * Feasible plans come first. Among those the one keeping most of the ROI
+ * wins, then the lowest pixel rate and the fewest ADCs because they read out
+ * with less noise. Plans that do not reach the frame rate are ordered by
+ * how close they get.
+ */
+static gint
+compare_plans (gconstpointer a, gconstpointer b, gpointer user_data)
+{
+    const UcaPcowinFrameRatePlan *pa = a;
+    const UcaPcowinFrameRatePlan *pb = b;
+    gdouble fps = *(const gdouble *) user_data;
+    gboolean feasible_a = is_feasible (pa, fps);
+    gboolean feasible_b = is_feasible (pb, fps);
+
+    if (feasible_a != feasible_b)
+        return feasible_a ? -1 : 1;
+
+    if (!feasible_a)
+        return pa->estimated_fps > pb->estimated_fps ? -1 : (pa->estimated_fps < pb->estimated_fps ? 1 : 0);
+
+    if (pa->roi_height != pb->roi_height)
+        return pa->roi_height > pb->roi_height ? -1 : 1;
+
+    if (pa->pixelrate != pb->pixelrate)
+        return pa->pixelrate < pb->pixelrate ? -1 : 1;
+
+    return (gint) pa->adcs - (gint) pb->adcs;
+}
+
+/*
+ * Fills @plans, which must hold UCA_PCOWIN_PLANNER_MAX_PLANS entries, with
+ * one plan per pixel rate and number of ADCs, best first. With @shrink_roi
+ * the ROI height is reduced around its center where that makes a plan reach
+ * @fps. Returns the number of plans.
+ */
+guint
+uca_pcowin_planner_plan (const UcaPcowinSensorLimits *limits, guint roi_width, guint roi_y, guint roi_height, gdouble fps, gdouble exposure, gboolean shrink_roi, UcaPcowinFrameRatePlan *plans)
+{
+    guint n_plans = 0;
+
+    for (guint i = 0; i < G_N_ELEMENTS (limits->pixelrates); i++) {
+        if (limits->pixelrates[i] == 0)
+            continue;
+
+        for (guint adcs = 1; adcs <= MAX (limits->max_adcs, 1) && n_plans < UCA_PCOWIN_PLANNER_MAX_PLANS; adcs++) {
+            UcaPcowinFrameRatePlan *plan = &plans[n_plans++];
+
+            plan->pixelrate = limits->pixelrates[i];
+            plan->adcs = adcs;
+            plan->roi_y = roi_y;
+            plan->roi_height = roi_height;
+            plan->estimated_fps = uca_pcowin_planner_estimate_fps (limits, plan->pixelrate, adcs, roi_width, roi_height, exposure);
+            plan->fps = 0.0;
+            plan->exposure = 0.0;
+            plan->status = 0;
+            plan->trimmed = FALSE;
+
+            if (shrink_roi && !is_feasible (plan, fps)) {
+                guint height = find_roi_height (limits, plan->pixelrate, adcs, roi_width, roi_height, fps, exposure);
+                guint step = MAX (limits->roi_vertical_steps, 1);
+
+                if (height > 0) {
+                    plan->roi_y = roi_y + (roi_height - height) / 2 / step * step;
+                    plan->roi_height = height;
+                    plan->estimated_fps = uca_pcowin_planner_estimate_fps (limits, plan->pixelrate, adcs, roi_width, height, exposure);
+                }
+            }
+        }
+    }
+
+    g_qsort_with_data (plans, n_plans, sizeof (UcaPcowinFrameRatePlan), compare_plans, &fps);
+
+    return n_plans;
+}
@@ -0,0 +1,78 @@
+/*
+Copyright (C) 2016  Sai Sasidhar Maddali <sai.sasidhar92@gmail.com>
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+
+#ifndef __UCA_PCOWIN_PLANNER_H
+#define __UCA_PCOWIN_PLANNER_H
+
+#include <glib.h>
+
+G_BEGIN_DECLS
+
+#define UCA_PCOWIN_PLANNER_MAX_PLANS    16
+
+/*
+ * A sensor configuration for a requested frame rate. @estimated_fps is the
+ * planner's estimate, @fps, @exposure and @status are what the camera
+ * reported after arming, @status holding the PCO frame rate status bits.
+ * @trimmed is set if the camera changed the requested frame rate or exposure
+ * or did not reach the frame rate.
+ */
+typedef struct {
+    guint32 pixelrate;
+    guint adcs;
+    guint roi_y;
+    guint roi_height;
+    gdouble estimated_fps;
+    gdouble fps;
+    gdouble exposure;
+    guint32 status;
+    gboolean trimmed;
+} UcaPcowinFrameRatePlan;
+
+/*
+ * What the planner knows about the sensor, from the camera description.
+ * Heights are in binned rows. @rows_in_parallel is 2 for sensors read out
+ * from the center towards top and bottom at the same time.
+ */
+typedef struct {
+    guint32 pixelrates[4];
+    guint max_adcs;
+    guint roi_vertical_steps;
+    guint min_roi_height;
+    guint rows_in_parallel;
+} UcaPcowinSensorLimits;
+
+gdouble             uca_pcowin_planner_estimate_fps (const UcaPcowinSensorLimits *limits,
+                                                     guint32             pixelrate,
+                                                     guint               adcs,
+                                                     guint               roi_width,
+                                                     guint               roi_height,
+                                                     gdouble             exposure);
+guint               uca_pcowin_planner_plan         (const UcaPcowinSensorLimits *limits,
+                                                     guint               roi_width,
+                                                     guint               roi_y,
+                                                     guint               roi_height,
+                                                     gdouble             fps,
+                                                     gdouble             exposure,
+                                                     gboolean            shrink_roi,
+                                                     UcaPcowinFrameRatePlan *plans);
+
+G_END_DECLS
+
+#endif
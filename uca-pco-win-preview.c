@@ -0,0 +1,283 @@
+/**
+Copyright (C) 2016  Sai Sasidhar Maddali <sai.sasidhar92@gmail.com>
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+**/
+
+#include <string.h>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+#include "uca-pco-win-preview.h"
+
+/*
+ * The preview channel keeps a single "latest frame" slot that is filled from
+ * the grab path and drained by a (possibly slow) consumer. The producer renders
+ * into its private back buffer and only swaps it into the slot if it can take
+ * the lock without waiting. If the consumer is busy copying, the preview frame
+ * is simply dropped, so grab never blocks on the preview.
+ */
+struct _UcaPcowinPreview {
+    GMutex lock;
+
+    // Held only for a few assignments, never while copying, so grab does not stall on it
+    GMutex settings_lock;
+
+    // Protected by settings_lock
+    guint decimation;
+    gdouble max_fps;
+    guint downsampling;
+    gboolean eight_bit;
+
+    guint64 counter;
+    gint64 last_push;
+
+    // Owned by the producer
+    guint16 *scratch;
+    gsize scratch_size;
+    gpointer back;
+    gsize back_size;
+
+    // Protected by lock
+    gpointer slot;
+    gsize slot_size;
+    guint width, height, bytes_per_pixel;
+    guint64 frame_number;
+    gboolean fresh;
+};
+
+UcaPcowinPreview *
+uca_pcowin_preview_new (void)
+{
+    UcaPcowinPreview *preview = g_new0 (UcaPcowinPreview, 1);
+
+    g_mutex_init (&preview->lock);
+    g_mutex_init (&preview->settings_lock);
+    preview->downsampling = 1;
+
+    return preview;
+}
+
+void
+uca_pcowin_preview_free (UcaPcowinPreview *preview)
+{
+    if (preview == NULL)
+        return;
+
+    g_mutex_clear (&preview->lock);
+    g_mutex_clear (&preview->settings_lock);
+    g_free (preview->scratch);
+    g_free (preview->back);
+    g_free (preview->slot);
+    g_free (preview);
+}
+
+void
+uca_pcowin_preview_configure (UcaPcowinPreview *preview, guint decimation, gdouble max_fps, guint downsampling, gboolean eight_bit)
+{
+    g_mutex_lock (&preview->settings_lock);
+    preview->decimation = decimation;
+    preview->max_fps = max_fps;
+    preview->downsampling = downsampling == 2 || downsampling == 4 ? downsampling : 1;
+    preview->eight_bit = eight_bit;
+    g_mutex_unlock (&preview->settings_lock);
+}
+
+void
+uca_pcowin_preview_reset (UcaPcowinPreview *preview)
+{
+    g_mutex_lock (&preview->settings_lock);
+    preview->counter = 0;
+    preview->last_push = 0;
+    g_mutex_unlock (&preview->settings_lock);
+
+    g_mutex_lock (&preview->lock);
+    preview->fresh = FALSE;
+    g_mutex_unlock (&preview->lock);
+}
+
+static void
+downsample (const guint16 *src, guint width, guint height, guint factor, guint16 *dst)
+{
+    guint out_width = width / factor;
+    guint out_height = height / factor;
+    guint shift = factor == 4 ? 4 : 2;
+
+    for (guint y = 0; y < out_height; y++) {
+        const guint16 *row = src + (gsize) y * factor * width;
+
+        for (guint x = 0; x < out_width; x++) {
+            guint32 sum = 0;
+
+            for (guint j = 0; j < factor; j++)
+                for (guint i = 0; i < factor; i++)
+                    sum += row[(gsize) j * width + x * factor + i];
+
+            dst[(gsize) y * out_width + x] = (guint16) (sum >> shift);
+        }
+    }
+}
+
+static void
+convert_to_8bit (const guint16 *src, guint8 *dst, gsize n_pixels, guint shift)
+{
+    gsize i = 0;
+
+#ifdef __SSE2__
+    __m128i count = _mm_cvtsi32_si128 ((int) shift);
+
+    for (; i + 16 <= n_pixels; i += 16) {
+        __m128i lo = _mm_srl_epi16 (_mm_loadu_si128 ((const __m128i *) (src + i)), count);
+        __m128i hi = _mm_srl_epi16 (_mm_loadu_si128 ((const __m128i *) (src + i + 8)), count);
+        _mm_storeu_si128 ((__m128i *) (dst + i), _mm_packus_epi16 (lo, hi));
+    }
+#endif
+
+    for (; i < n_pixels; i++) {
+        guint16 value = src[i] >> shift;
+        dst[i] = value > 255 ? 255 : (guint8) value;
+    }
+}
+
+void
+uca_pcowin_preview_push (UcaPcowinPreview *preview, const guint16 *frame, guint width, guint height, guint bit_per_pixel)
+{
+    guint decimation, downsampling;
+    gdouble max_fps;
+    gboolean eight_bit, skip;
+    guint out_width, out_height, bytes_per_pixel;
+    const guint16 *source;
+    gsize n_pixels, size;
+    guint64 counter;
+    gint64 now;
+
+    now = g_get_monotonic_time ();
+
+    // Settings and rate limiting are decided on a consistent snapshot
+    g_mutex_lock (&preview->settings_lock);
+    decimation = preview->decimation;
+    max_fps = preview->max_fps;
+    downsampling = preview->downsampling;
+    eight_bit = preview->eight_bit;
+
+    skip = decimation == 0 || preview->counter++ % decimation != 0 ||
+        (max_fps > 0.0 && preview->last_push != 0 && (now - preview->last_push) < (gint64) (G_USEC_PER_SEC / max_fps));
+
+    if (!skip)
+        preview->last_push = now;
+
+    counter = preview->counter;
+    g_mutex_unlock (&preview->settings_lock);
+
+    if (skip)
+        return;
+
+    out_width = width / downsampling;
+    out_height = height / downsampling;
+    n_pixels = (gsize) out_width * out_height;
+    bytes_per_pixel = eight_bit ? 1 : 2;
+    size = n_pixels * bytes_per_pixel;
+
+    if (n_pixels == 0)
+        return;
+
+    if (preview->back_size < size) {
+        g_free (preview->back);
+        preview->back = g_malloc (size);
+        preview->back_size = size;
+    }
+
+    if (downsampling > 1) {
+        if (eight_bit) {
+            if (preview->scratch_size < n_pixels * 2) {
+                g_free (preview->scratch);
+                preview->scratch = g_malloc (n_pixels * 2);
+                preview->scratch_size = n_pixels * 2;
+            }
+
+            downsample (frame, width, height, downsampling, preview->scratch);
+            source = preview->scratch;
+        }
+        else {
+            downsample (frame, width, height, downsampling, preview->back);
+            source = NULL;
+        }
+    }
+    else
+        source = frame;
+
+    if (eight_bit)
+        convert_to_8bit (source, preview->back, n_pixels, bit_per_pixel > 8 ? bit_per_pixel - 8 : 0);
+    else if (source != NULL)
+        memcpy (preview->back, source, size);
+
+    if (!g_mutex_trylock (&preview->lock))
+        return;
+
+    {
+        gpointer slot = preview->slot;
+        gsize slot_size = preview->slot_size;
+
+        preview->slot = preview->back;
+        preview->slot_size = preview->back_size;
+        preview->back = slot;
+        preview->back_size = slot_size;
+    }
+
+    preview->width = out_width;
+    preview->height = out_height;
+    preview->bytes_per_pixel = bytes_per_pixel;
+    preview->frame_number = counter;
+    preview->fresh = TRUE;
+
+    g_mutex_unlock (&preview->lock);
+}
+
+gboolean
+uca_pcowin_preview_fetch (UcaPcowinPreview *preview, gpointer data, gsize size,
+                          guint *width, guint *height, guint *bytes_per_pixel, guint64 *frame_number)
+{
+    gboolean fetched = FALSE;
+    gsize frame_size;
+
+    g_mutex_lock (&preview->lock);
+
+    frame_size = (gsize) preview->width * preview->height * preview->bytes_per_pixel;
+
+    if (width)
+        *width = preview->width;
+
+    if (height)
+        *height = preview->height;
+
+    if (bytes_per_pixel)
+        *bytes_per_pixel = preview->bytes_per_pixel;
+
+    if (frame_number)
+        *frame_number = preview->frame_number;
+
+    if (preview->fresh && frame_size <= size) {
+        memcpy (data, preview->slot, frame_size);
+        preview->fresh = FALSE;
+        fetched = TRUE;
+    }
+
+    g_mutex_unlock (&preview->lock);
+
+    return fetched;
+}
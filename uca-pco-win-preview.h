@@ -0,0 +1,52 @@
+/*
+Copyright (C) 2016  Sai Sasidhar Maddali <sai.sasidhar92@gmail.com>
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+
+#ifndef __UCA_PCOWIN_PREVIEW_H
+#define __UCA_PCOWIN_PREVIEW_H
+
+#include <glib.h>
+
+G_BEGIN_DECLS
+
+typedef struct _UcaPcowinPreview UcaPcowinPreview;
+
+UcaPcowinPreview   *uca_pcowin_preview_new          (void);
+void                uca_pcowin_preview_free         (UcaPcowinPreview   *preview);
+void                uca_pcowin_preview_configure    (UcaPcowinPreview   *preview,
+                                                     guint               decimation,
+                                                     gdouble             max_fps,
+                                                     guint               downsampling,
+                                                     gboolean            eight_bit);
+void                uca_pcowin_preview_reset        (UcaPcowinPreview   *preview);
+void                uca_pcowin_preview_push         (UcaPcowinPreview   *preview,
+                                                     const guint16      *frame,
+                                                     guint               width,
+                                                     guint               height,
+                                                     guint               bit_per_pixel);
+gboolean            uca_pcowin_preview_fetch        (UcaPcowinPreview   *preview,
+                                                     gpointer            data,
+                                                     gsize               size,
+                                                     guint              *width,
+                                                     guint              *height,
+                                                     guint              *bytes_per_pixel,
+                                                     guint64            *frame_number);
+
+G_END_DECLS
+
+#endif
@@ -0,0 +1,288 @@
+/**
+Copyright (C) 2016  Sai Sasidhar Maddali <sai.sasidhar92@gmail.com>
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+**/
+
+#include <glib/gstdio.h>
+#include <string.h>
+#include <windows.h>
+
+#include "uca-pco-win-camera.h"
+#include "uca-pco-win-recorder.h"
+
+// Unbuffered I/O requires sector aligned sizes and offsets, a page covers all common sector sizes
+#define RECORDER_ALIGNMENT  4096
+
+typedef struct {
+    gpointer data;
+    OVERLAPPED overlapped;
+    gboolean pending;
+
+    // Memory the pending write reads from, the staging data or a caller's frame
+    gconstpointer source;
+} StagingBuffer;
+
+struct _UcaPcowinRecorder {
+    HANDLE file;
+    FILE *index;
+
+    gsize frame_size;
+    gsize frame_stride;
+    guint64 offset;
+
+    StagingBuffer *buffers;
+    guint n_buffers;
+    guint current;
+    guint pending;
+
+    guint64 bytes_written;
+    gint64 first_submit;
+    gint64 last_completion;
+};
+
+static void
+set_windows_error (GError **error, const gchar *what)
+{
+    g_set_error (error, UCA_PCOWIN_CAMERA_ERROR, UCA_PCOWIN_CAMERA_ERROR_GENERAL,
+                 "%s failed (error %lu)", what, (gulong) GetLastError ());
+}
+
+static gboolean
+complete_write (UcaPcowinRecorder *recorder, StagingBuffer *buffer, GError **error)
+{
+    DWORD transferred;
+
+    if (!buffer->pending)
+        return TRUE;
+
+    buffer->pending = FALSE;
+    recorder->pending--;
+
+    if (!GetOverlappedResult (recorder->file, &buffer->overlapped, &transferred, TRUE)) {
+        set_windows_error (error, "Writing frame to disk");
+        return FALSE;
+    }
+
+    recorder->bytes_written += transferred;
+    recorder->last_completion = g_get_monotonic_time ();
+
+    return TRUE;
+}
+
+UcaPcowinRecorder *
+uca_pcowin_recorder_new (const gchar *filename, gsize frame_size, guint n_buffers, GError **error)
+{
+    UcaPcowinRecorder *recorder;
+    gchar *index_name;
+
+    g_return_val_if_fail (filename != NULL && frame_size > 0, NULL);
+
+    recorder = g_new0 (UcaPcowinRecorder, 1);
+    recorder->frame_size = frame_size;
+    recorder->frame_stride = (frame_size + RECORDER_ALIGNMENT - 1) & ~((gsize) RECORDER_ALIGNMENT - 1);
+    recorder->n_buffers = MAX (n_buffers, 2);
+    recorder->buffers = g_new0 (StagingBuffer, recorder->n_buffers);
+
+    recorder->file = CreateFileA (filename, GENERIC_WRITE, FILE_SHARE_READ, NULL, CREATE_ALWAYS,
+                                  FILE_ATTRIBUTE_NORMAL | FILE_FLAG_NO_BUFFERING | FILE_FLAG_OVERLAPPED, NULL);
+
+    if (recorder->file == INVALID_HANDLE_VALUE) {
+        set_windows_error (error, "Opening record file");
+        recorder->file = NULL;
+        uca_pcowin_recorder_close (recorder, NULL);
+        return NULL;
+    }
+
+    index_name = g_strdup_printf ("%s.idx", filename);
+    recorder->index = g_fopen (index_name, "wb");
+    g_free (index_name);
+
+    if (recorder->index == NULL) {
+        g_set_error (error, UCA_PCOWIN_CAMERA_ERROR, UCA_PCOWIN_CAMERA_ERROR_GENERAL,
+                     "Could not open index file for `%s'", filename);
+        uca_pcowin_recorder_close (recorder, NULL);
+        return NULL;
+    }
+
+    for (guint i = 0; i < recorder->n_buffers; i++) {
+        StagingBuffer *buffer = &recorder->buffers[i];
+
+        // VirtualAlloc returns page aligned memory as required for unbuffered writes
+        buffer->data = VirtualAlloc (NULL, recorder->frame_stride, MEM_COMMIT | MEM_RESERVE, PAGE_READWRITE);
+        buffer->overlapped.hEvent = CreateEventA (NULL, TRUE, FALSE, NULL);
+
+        if (buffer->data == NULL || buffer->overlapped.hEvent == NULL) {
+            set_windows_error (error, "Allocating staging buffer");
+            uca_pcowin_recorder_close (recorder, NULL);
+            return NULL;
+        }
+
+        // Padding bytes are written to disk, do not leak old heap contents
+        memset ((guint8 *) buffer->data + frame_size, 0, recorder->frame_stride - frame_size);
+    }
+
+    return recorder;
+}
+
+gboolean
+uca_pcowin_recorder_close (UcaPcowinRecorder *recorder, GError **error)
+{
+    gboolean success = TRUE;
+
+    if (recorder == NULL)
+        return TRUE;
+
+    for (guint i = 0; i < recorder->n_buffers; i++) {
+        StagingBuffer *buffer = &recorder->buffers[i];
+
+        if (!complete_write (recorder, buffer, success ? error : NULL))
+            success = FALSE;
+
+        if (buffer->data != NULL)
+            VirtualFree (buffer->data, 0, MEM_RELEASE);
+
+        if (buffer->overlapped.hEvent != NULL)
+            CloseHandle (buffer->overlapped.hEvent);
+    }
+
+    if (recorder->index != NULL)
+        fclose (recorder->index);
+
+    if (recorder->file != NULL)
+        CloseHandle (recorder->file);
+
+    g_free (recorder->buffers);
+    g_free (recorder);
+
+    return success;
+}
+
+static gboolean
+submit_write (UcaPcowinRecorder *recorder, gconstpointer frame, gboolean in_place, guint64 frame_counter, gint64 timestamp, GError **error)
+{
+    StagingBuffer *buffer;
+    UcaPcowinRecorderIndexEntry entry;
+
+    buffer = &recorder->buffers[recorder->current];
+    recorder->current = (recorder->current + 1) % recorder->n_buffers;
+
+    // Only blocks if the disk fell behind by more than n_buffers frames
+    if (!complete_write (recorder, buffer, error))
+        return FALSE;
+
+    if (in_place)
+        buffer->source = frame;
+    else {
+        memcpy (buffer->data, frame, recorder->frame_size);
+        buffer->source = buffer->data;
+    }
+
+    memset (&buffer->overlapped, 0, G_STRUCT_OFFSET (OVERLAPPED, hEvent));
+    buffer->overlapped.u.s.Offset = (DWORD) (recorder->offset & 0xFFFFFFFF);
+    buffer->overlapped.u.s.OffsetHigh = (DWORD) (recorder->offset >> 32);
+    ResetEvent (buffer->overlapped.hEvent);
+
+    if (!WriteFile (recorder->file, buffer->source, (DWORD) recorder->frame_stride, NULL, &buffer->overlapped) &&
+        GetLastError () != ERROR_IO_PENDING) {
+        set_windows_error (error, "Writing frame to disk");
+        return FALSE;
+    }
+
+    buffer->pending = TRUE;
+    recorder->pending++;
+
+    if (recorder->first_submit == 0)
+        recorder->first_submit = g_get_monotonic_time ();
+
+    entry.frame_counter = frame_counter;
+    entry.timestamp = timestamp;
+    entry.offset = recorder->offset;
+    entry.size = (guint32) recorder->frame_size;
+    entry.reserved = 0;
+
+    if (fwrite (&entry, sizeof (entry), 1, recorder->index) != 1) {
+        g_set_error_literal (error, UCA_PCOWIN_CAMERA_ERROR, UCA_PCOWIN_CAMERA_ERROR_GENERAL,
+                             "Could not write frame index entry");
+        return FALSE;
+    }
+
+    recorder->offset += recorder->frame_stride;
+
+    return TRUE;
+}
+
+gboolean
+uca_pcowin_recorder_write (UcaPcowinRecorder *recorder, gconstpointer frame, guint64 frame_counter, gint64 timestamp, GError **error)
+{
+    return submit_write (recorder, frame, FALSE, frame_counter, timestamp, error);
+}
+
+/*
+ * Writes @frame without copying it. The frame must be page aligned, readable
+ * up to the next page boundary and left untouched until
+ * uca_pcowin_recorder_release() reports it as released.
+ */
+gboolean
+uca_pcowin_recorder_write_in_place (UcaPcowinRecorder *recorder, gconstpointer frame, guint64 frame_counter, gint64 timestamp, GError **error)
+{
+    g_return_val_if_fail (((gsize) frame & (RECORDER_ALIGNMENT - 1)) == 0, FALSE);
+
+    return submit_write (recorder, frame, TRUE, frame_counter, timestamp, error);
+}
+
+/*
+ * Sets @released once no write reads from @frame any more. Without @wait this
+ * never blocks and @released stays FALSE while the write is in flight.
+ */
+gboolean
+uca_pcowin_recorder_release (UcaPcowinRecorder *recorder, gconstpointer frame, gboolean wait, gboolean *released, GError **error)
+{
+    *released = TRUE;
+
+    for (guint i = 0; i < recorder->n_buffers; i++) {
+        StagingBuffer *buffer = &recorder->buffers[i];
+
+        if (!buffer->pending || buffer->source != frame)
+            continue;
+
+        if (!wait && !HasOverlappedIoCompleted (&buffer->overlapped)) {
+            *released = FALSE;
+            return TRUE;
+        }
+
+        return complete_write (recorder, buffer, error);
+    }
+
+    return TRUE;
+}
+
+gdouble
+uca_pcowin_recorder_get_throughput (UcaPcowinRecorder *recorder)
+{
+    gint64 elapsed = recorder->last_completion - recorder->first_submit;
+
+    if (elapsed <= 0)
+        return 0.0;
+
+    return recorder->bytes_written / 1024.0 / 1024.0 / (elapsed / (gdouble) G_USEC_PER_SEC);
+}
+
+guint
+uca_pcowin_recorder_get_queue_depth (UcaPcowinRecorder *recorder)
+{
+    return recorder->pending;
+}
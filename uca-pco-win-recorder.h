@@ -0,0 +1,71 @@
+/*
+Copyright (C) 2016  Sai Sasidhar Maddali <sai.sasidhar92@gmail.com>
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+
+#ifndef __UCA_PCOWIN_RECORDER_H
+#define __UCA_PCOWIN_RECORDER_H
+
+#include <glib.h>
+
+G_BEGIN_DECLS
+
+/*
+ * Entry of the index file written next to the raw frame file. Frames are
+ * stored back to back: every frame starts at a multiple of the sector
+ * aligned frame stride, @size bytes of which are image data.
+ */
+typedef struct {
+    guint64 frame_counter;
+    gint64 timestamp;
+    guint64 offset;
+    guint32 size;
+    guint32 reserved;
+} UcaPcowinRecorderIndexEntry;
+
+typedef struct _UcaPcowinRecorder UcaPcowinRecorder;
+
+UcaPcowinRecorder  *uca_pcowin_recorder_new         (const gchar        *filename,
+                                                     gsize               frame_size,
+                                                     guint               n_buffers,
+                                                     GError            **error);
+gboolean            uca_pcowin_recorder_close       (UcaPcowinRecorder  *recorder,
+                                                     GError            **error);
+gboolean            uca_pcowin_recorder_write       (UcaPcowinRecorder  *recorder,
+                                                     gconstpointer       frame,
+                                                     guint64             frame_counter,
+                                                     gint64              timestamp,
+                                                     GError            **error);
+gboolean            uca_pcowin_recorder_write_in_place
+                                                    (UcaPcowinRecorder  *recorder,
+                                                     gconstpointer       frame,
+                                                     guint64             frame_counter,
+                                                     gint64              timestamp,
+                                                     GError            **error);
+gboolean            uca_pcowin_recorder_release     (UcaPcowinRecorder  *recorder,
+                                                     gconstpointer       frame,
+                                                     gboolean            wait,
+                                                     gboolean           *released,
+                                                     GError            **error);
+gdouble             uca_pcowin_recorder_get_throughput
+                                                    (UcaPcowinRecorder  *recorder);
+guint               uca_pcowin_recorder_get_queue_depth
+                                                    (UcaPcowinRecorder  *recorder);
+
+G_END_DECLS
+
+#endif
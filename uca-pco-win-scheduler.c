@@ -0,0 +1,223 @@
+/**
+Copyright (C) 2016  Sai Sasidhar Maddali <sai.sasidhar92@gmail.com>
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+**/
+
+#include <string.h>
+
+#include "uca-pco-win-scheduler.h"
+
+/*
+ * Every SDK call is a blocking round trip to the camera, so instead of a
+ * command queue and a worker thread the scheduler is a gate that hands the
+ * camera to the highest priority waiter whenever the current call returns.
+ */
+struct _UcaPcowinScheduler {
+    GMutex lock;
+    GCond cond;
+    gboolean busy;
+    UcaPcowinPriority current;
+    guint n_waiting[UCA_PCOWIN_N_PRIORITIES];
+
+    // Reads in flight by key that may still be joined, identical reads wait for their result
+    GHashTable *reads;
+
+    struct {
+        guint64 n_calls;
+        guint64 n_coalesced;
+        gint64 total_wait;
+        gint64 max_wait;
+    } stats[UCA_PCOWIN_N_PRIORITIES];
+};
+
+struct _UcaPcowinPendingRead {
+    GValue value;
+    gboolean done;
+    guint refs;
+    guint key;
+};
+
+static void
+release_read (UcaPcowinPendingRead *read)
+{
+    if (--read->refs > 0)
+        return;
+
+    if (G_IS_VALUE (&read->value))
+        g_value_unset (&read->value);
+
+    g_free (read);
+}
+
+static gboolean
+has_precedence (UcaPcowinScheduler *scheduler, UcaPcowinPriority priority)
+{
+    for (guint p = 0; p < priority; p++) {
+        if (scheduler->n_waiting[p] > 0)
+            return FALSE;
+    }
+
+    return TRUE;
+}
+
+UcaPcowinScheduler *
+uca_pcowin_scheduler_new (void)
+{
+    UcaPcowinScheduler *scheduler;
+
+    scheduler = g_new0 (UcaPcowinScheduler, 1);
+    scheduler->reads = g_hash_table_new (g_direct_hash, g_direct_equal);
+    g_mutex_init (&scheduler->lock);
+    g_cond_init (&scheduler->cond);
+
+    return scheduler;
+}
+
+void
+uca_pcowin_scheduler_free (UcaPcowinScheduler *scheduler)
+{
+    if (scheduler == NULL)
+        return;
+
+    g_hash_table_destroy (scheduler->reads);
+    g_mutex_clear (&scheduler->lock);
+    g_cond_clear (&scheduler->cond);
+    g_free (scheduler);
+}
+
+// Blocks until the calling thread may talk to the camera
+void
+uca_pcowin_scheduler_enter (UcaPcowinScheduler *scheduler, UcaPcowinPriority priority)
+{
+    gint64 start, wait;
+
+    start = g_get_monotonic_time ();
+    g_mutex_lock (&scheduler->lock);
+    scheduler->n_waiting[priority]++;
+
+    while (scheduler->busy || !has_precedence (scheduler, priority))
+        g_cond_wait (&scheduler->cond, &scheduler->lock);
+
+    scheduler->n_waiting[priority]--;
+    scheduler->busy = TRUE;
+    scheduler->current = priority;
+
+    wait = g_get_monotonic_time () - start;
+    scheduler->stats[priority].n_calls++;
+    scheduler->stats[priority].total_wait += wait;
+    scheduler->stats[priority].max_wait = MAX (scheduler->stats[priority].max_wait, wait);
+    g_mutex_unlock (&scheduler->lock);
+}
+
+// Hands the camera to the next waiter and passes @result through
+gint
+uca_pcowin_scheduler_leave (UcaPcowinScheduler *scheduler, gint result)
+{
+    g_mutex_lock (&scheduler->lock);
+    scheduler->busy = FALSE;
+
+    // A read that started before a setting changed may not answer later reads
+    if (scheduler->current == UCA_PCOWIN_PRIORITY_CONTROL)
+        g_hash_table_remove_all (scheduler->reads);
+
+    g_cond_broadcast (&scheduler->cond);
+    g_mutex_unlock (&scheduler->lock);
+
+    return result;
+}
+
+/*
+ * Returns TRUE with @value set if an identical read of @key was in flight and
+ * has finished meanwhile. Otherwise the caller owns @pending and must call
+ * uca_pcowin_scheduler_finish_read() with its result.
+ */
+gboolean
+uca_pcowin_scheduler_join_read (UcaPcowinScheduler *scheduler, guint key, GValue *value, UcaPcowinPendingRead **pending)
+{
+    UcaPcowinPendingRead *read;
+
+    g_mutex_lock (&scheduler->lock);
+    read = g_hash_table_lookup (scheduler->reads, GUINT_TO_POINTER (key));
+
+    if (read == NULL) {
+        read = g_new0 (UcaPcowinPendingRead, 1);
+        read->refs = 1;
+        read->key = key;
+        g_hash_table_insert (scheduler->reads, GUINT_TO_POINTER (key), read);
+        g_mutex_unlock (&scheduler->lock);
+        *pending = read;
+        return FALSE;
+    }
+
+    read->refs++;
+
+    while (!read->done)
+        g_cond_wait (&scheduler->cond, &scheduler->lock);
+
+    g_value_copy (&read->value, value);
+    scheduler->stats[UCA_PCOWIN_PRIORITY_QUERY].n_coalesced++;
+    release_read (read);
+    g_mutex_unlock (&scheduler->lock);
+
+    return TRUE;
+}
+
+void
+uca_pcowin_scheduler_finish_read (UcaPcowinScheduler *scheduler, UcaPcowinPendingRead *pending, const GValue *value)
+{
+    g_mutex_lock (&scheduler->lock);
+
+    // Invalidated reads are no longer listed but still answer those that joined before
+    if (g_hash_table_lookup (scheduler->reads, GUINT_TO_POINTER (pending->key)) == pending)
+        g_hash_table_remove (scheduler->reads, GUINT_TO_POINTER (pending->key));
+
+    g_value_init (&pending->value, G_VALUE_TYPE (value));
+    g_value_copy (value, &pending->value);
+    pending->done = TRUE;
+    g_cond_broadcast (&scheduler->cond);
+    release_read (pending);
+
+    g_mutex_unlock (&scheduler->lock);
+}
+
+// Keeps reads that are in flight from answering reads issued from now on
+void
+uca_pcowin_scheduler_invalidate_reads (UcaPcowinScheduler *scheduler)
+{
+    g_mutex_lock (&scheduler->lock);
+    g_hash_table_remove_all (scheduler->reads);
+    g_mutex_unlock (&scheduler->lock);
+}
+
+void
+uca_pcowin_scheduler_get_stats (UcaPcowinScheduler *scheduler, UcaPcowinPriority priority, UcaPcowinSchedulerStats *stats)
+{
+    g_mutex_lock (&scheduler->lock);
+    stats->n_calls = scheduler->stats[priority].n_calls;
+    stats->n_coalesced = scheduler->stats[priority].n_coalesced;
+    stats->mean_wait = stats->n_calls > 0 ? (gdouble) scheduler->stats[priority].total_wait / stats->n_calls : 0.0;
+    stats->max_wait = scheduler->stats[priority].max_wait;
+    g_mutex_unlock (&scheduler->lock);
+}
+
+void
+uca_pcowin_scheduler_reset_stats (UcaPcowinScheduler *scheduler)
+{
+    g_mutex_lock (&scheduler->lock);
+    memset (scheduler->stats, 0, sizeof (scheduler->stats));
+    g_mutex_unlock (&scheduler->lock);
+}
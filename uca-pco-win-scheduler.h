@@ -0,0 +1,85 @@
+/*
+Copyright (C) 2016  Sai Sasidhar Maddali <sai.sasidhar92@gmail.com>
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+
+#ifndef __UCA_PCOWIN_SCHEDULER_H
+#define __UCA_PCOWIN_SCHEDULER_H
+
+#include <glib-object.h>
+
+G_BEGIN_DECLS
+
+/*
+ * Priorities of SDK calls, lower values go first. Transfer calls feed and
+ * drain image buffers, control calls change the camera state and queries
+ * only read it.
+ */
+typedef enum {
+    UCA_PCOWIN_PRIORITY_TRANSFER,
+    UCA_PCOWIN_PRIORITY_CONTROL,
+    UCA_PCOWIN_PRIORITY_QUERY,
+    UCA_PCOWIN_N_PRIORITIES
+} UcaPcowinPriority;
+
+/*
+ * Wait times are in microseconds from requesting the camera until the call
+ * could be issued. Coalesced reads were answered by a concurrent identical
+ * read and did not reach the camera.
+ */
+typedef struct {
+    guint64 n_calls;
+    guint64 n_coalesced;
+    gdouble mean_wait;
+    gint64 max_wait;
+} UcaPcowinSchedulerStats;
+
+typedef struct _UcaPcowinScheduler UcaPcowinScheduler;
+typedef struct _UcaPcowinPendingRead UcaPcowinPendingRead;
+
+UcaPcowinScheduler *uca_pcowin_scheduler_new        (void);
+void                uca_pcowin_scheduler_free       (UcaPcowinScheduler *scheduler);
+void                uca_pcowin_scheduler_enter      (UcaPcowinScheduler *scheduler,
+                                                     UcaPcowinPriority   priority);
+gint                uca_pcowin_scheduler_leave      (UcaPcowinScheduler *scheduler,
+                                                     gint                result);
+gboolean            uca_pcowin_scheduler_join_read  (UcaPcowinScheduler *scheduler,
+                                                     guint               key,
+                                                     GValue             *value,
+                                                     UcaPcowinPendingRead **pending);
+void                uca_pcowin_scheduler_finish_read
+                                                    (UcaPcowinScheduler *scheduler,
+                                                     UcaPcowinPendingRead *pending,
+                                                     const GValue       *value);
+void                uca_pcowin_scheduler_invalidate_reads
+                                                    (UcaPcowinScheduler *scheduler);
+void                uca_pcowin_scheduler_get_stats  (UcaPcowinScheduler *scheduler,
+                                                     UcaPcowinPriority   priority,
+                                                     UcaPcowinSchedulerStats *stats);
+void                uca_pcowin_scheduler_reset_stats
+                                                    (UcaPcowinScheduler *scheduler);
+
+/*
+ * Issues @call once the camera is free and no call of higher priority waits.
+ * Evaluates to the result of @call.
+ */
+#define UCA_PCOWIN_SCHEDULE(scheduler, priority, call) \
+    (uca_pcowin_scheduler_enter ((scheduler), (priority)), uca_pcowin_scheduler_leave ((scheduler), (call)))
+
+G_END_DECLS
+
+#endif
@@ -0,0 +1,170 @@
+/**
+Copyright (C) 2016  Sai Sasidhar Maddali <sai.sasidhar92@gmail.com>
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+**/
+
+#include <string.h>
+
+#include "uca-pco-win-camera.h"
+#include "uca-pco-win-shm.h"
+
+struct _UcaPcowinShmRing {
+    gchar *name;
+    HANDLE mapping;
+    guint8 *base;
+    UcaPcowinShmHeader *header;
+    gsize max_frame_size;
+    gint64 sequence;
+};
+
+UcaPcowinShmRing *
+uca_pcowin_shm_ring_new (const gchar *name, guint n_slots, gsize max_frame_size, GError **error)
+{
+    UcaPcowinShmRing *ring;
+    guint64 slot_stride, total_size;
+    gboolean existed;
+
+    g_return_val_if_fail (name != NULL && n_slots > 0, NULL);
+
+    // Slots start on page boundaries, frame data follows the 64 byte slot header
+    slot_stride = (sizeof (UcaPcowinShmSlot) + max_frame_size + 4095) & ~((guint64) 4095);
+    total_size = UCA_PCOWIN_SHM_HEADER_SIZE + slot_stride * n_slots;
+
+    ring = g_new0 (UcaPcowinShmRing, 1);
+    ring->name = g_strdup (name);
+    ring->max_frame_size = max_frame_size;
+    ring->mapping = CreateFileMappingA (INVALID_HANDLE_VALUE, NULL, PAGE_READWRITE,
+                                        (DWORD) (total_size >> 32), (DWORD) (total_size & 0xFFFFFFFF), name);
+
+    if (ring->mapping == NULL) {
+        g_set_error (error, UCA_PCOWIN_CAMERA_ERROR, UCA_PCOWIN_CAMERA_ERROR_GENERAL,
+                     "Could not create shared memory `%s' of %" G_GUINT64_FORMAT " bytes (error %lu)",
+                     name, total_size, (gulong) GetLastError ());
+        uca_pcowin_shm_ring_free (ring);
+        return NULL;
+    }
+
+    existed = GetLastError () == ERROR_ALREADY_EXISTS;
+    ring->base = MapViewOfFile (ring->mapping, FILE_MAP_ALL_ACCESS, 0, 0, 0);
+
+    if (ring->base == NULL) {
+        g_set_error (error, UCA_PCOWIN_CAMERA_ERROR, UCA_PCOWIN_CAMERA_ERROR_GENERAL,
+                     "Could not map shared memory `%s' (error %lu)", name, (gulong) GetLastError ());
+        uca_pcowin_shm_ring_free (ring);
+        return NULL;
+    }
+
+    ring->header = (UcaPcowinShmHeader *) ring->base;
+
+    /*
+     * An existing section keeps the size it was created with, so a ring of
+     * another geometry may only be laid out anew if it still fits.
+     */
+    if (existed) {
+        MEMORY_BASIC_INFORMATION info;
+
+        if (VirtualQuery (ring->base, &info, sizeof (info)) == 0 || info.RegionSize < total_size) {
+            g_set_error (error, UCA_PCOWIN_CAMERA_ERROR, UCA_PCOWIN_CAMERA_ERROR_GENERAL,
+                         "Shared memory `%s' is still open with a smaller size, close its readers first",
+                         name);
+            uca_pcowin_shm_ring_free (ring);
+            return NULL;
+        }
+    }
+
+    /*
+     * A mapping that is still held open by readers survives the plugin. Keep
+     * counting from its last sequence so readers never see numbers go back.
+     */
+    if (existed && ring->header->magic == UCA_PCOWIN_SHM_MAGIC &&
+        ring->header->n_slots == n_slots && ring->header->slot_stride == slot_stride) {
+        ring->sequence = ring->header->last_sequence;
+    }
+    else {
+        memset (ring->base, 0, UCA_PCOWIN_SHM_HEADER_SIZE);
+
+        for (guint i = 0; i < n_slots; i++)
+            memset (ring->base + UCA_PCOWIN_SHM_HEADER_SIZE + i * slot_stride, 0, sizeof (UcaPcowinShmSlot));
+
+        ring->header->n_slots = n_slots;
+        ring->header->slot_stride = (guint32) slot_stride;
+        ring->header->version = UCA_PCOWIN_SHM_VERSION;
+        MemoryBarrier ();
+        ring->header->magic = UCA_PCOWIN_SHM_MAGIC;
+    }
+
+    return ring;
+}
+
+void
+uca_pcowin_shm_ring_free (UcaPcowinShmRing *ring)
+{
+    if (ring == NULL)
+        return;
+
+    if (ring->base != NULL)
+        UnmapViewOfFile (ring->base);
+
+    if (ring->mapping != NULL)
+        CloseHandle (ring->mapping);
+
+    g_free (ring->name);
+    g_free (ring);
+}
+
+const gchar *
+uca_pcowin_shm_ring_get_name (UcaPcowinShmRing *ring)
+{
+    return ring->name;
+}
+
+gsize
+uca_pcowin_shm_ring_get_max_frame_size (UcaPcowinShmRing *ring)
+{
+    return ring->max_frame_size;
+}
+
+gint64
+uca_pcowin_shm_ring_publish (UcaPcowinShmRing *ring, gconstpointer frame, guint width, guint height, guint bytes_per_pixel)
+{
+    UcaPcowinShmSlot *slot;
+    gint64 sequence;
+    gsize size;
+
+    size = (gsize) width * height * bytes_per_pixel;
+
+    if (size > ring->max_frame_size)
+        return 0;
+
+    sequence = ++ring->sequence;
+    slot = (UcaPcowinShmSlot *) (ring->base + UCA_PCOWIN_SHM_HEADER_SIZE +
+                                 (gsize) (sequence % ring->header->n_slots) * ring->header->slot_stride);
+
+    InterlockedExchange64 (&slot->sequence, 2 * sequence + 1);
+
+    slot->timestamp = g_get_real_time ();
+    slot->width = width;
+    slot->height = height;
+    slot->bytes_per_pixel = bytes_per_pixel;
+    slot->size = (guint32) size;
+    memcpy ((guint8 *) slot + sizeof (UcaPcowinShmSlot), frame, size);
+
+    InterlockedExchange64 (&slot->sequence, 2 * sequence);
+    InterlockedExchange64 (&ring->header->last_sequence, sequence);
+
+    return sequence;
+}
@@ -0,0 +1,171 @@
+/*
+Copyright (C) 2016  Sai Sasidhar Maddali <sai.sasidhar92@gmail.com>
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+
+#ifndef __UCA_PCOWIN_SHM_H
+#define __UCA_PCOWIN_SHM_H
+
+#include <glib.h>
+#include <windows.h>
+
+G_BEGIN_DECLS
+
+/*
+ * Layout of the named shared-memory frame ring. The mapping starts with a
+ * UcaPcowinShmHeader padded to UCA_PCOWIN_SHM_HEADER_SIZE, followed by
+ * n_slots slots of slot_stride bytes each. Every slot starts with a
+ * UcaPcowinShmSlot followed by the frame data.
+ *
+ * The writer follows a per-slot sequence lock: while frame n is being written
+ * the slot sequence is 2n+1, afterwards it is 2n. Readers map the ring
+ * read-only, look at the frame in place and re-check the slot sequence
+ * afterwards to make sure the writer did not overwrite it meanwhile.
+ */
+#define UCA_PCOWIN_SHM_MAGIC        0x4d534350  /* "PCSM" */
+#define UCA_PCOWIN_SHM_VERSION      1
+#define UCA_PCOWIN_SHM_HEADER_SIZE  4096
+
+typedef struct {
+    guint32 magic;
+    guint32 version;
+    guint32 n_slots;
+    guint32 slot_stride;
+    volatile gint64 last_sequence;
+} UcaPcowinShmHeader;
+
+typedef struct {
+    volatile gint64 sequence;
+    gint64 timestamp;
+    guint32 width;
+    guint32 height;
+    guint32 bytes_per_pixel;
+    guint32 size;
+    guint8 reserved[32];
+} UcaPcowinShmSlot;
+
+typedef struct _UcaPcowinShmRing UcaPcowinShmRing;
+
+UcaPcowinShmRing   *uca_pcowin_shm_ring_new         (const gchar        *name,
+                                                     guint               n_slots,
+                                                     gsize               max_frame_size,
+                                                     GError            **error);
+void                uca_pcowin_shm_ring_free        (UcaPcowinShmRing   *ring);
+const gchar        *uca_pcowin_shm_ring_get_name    (UcaPcowinShmRing   *ring);
+gsize               uca_pcowin_shm_ring_get_max_frame_size
+                                                    (UcaPcowinShmRing   *ring);
+gint64              uca_pcowin_shm_ring_publish     (UcaPcowinShmRing   *ring,
+                                                     gconstpointer       frame,
+                                                     guint               width,
+                                                     guint               height,
+                                                     guint               bytes_per_pixel);
+
+/*
+ * Reader side. These are inline so that consumer processes only need this
+ * header and do not have to link against the plugin.
+ */
+typedef struct {
+    HANDLE mapping;
+    const guint8 *base;
+    const UcaPcowinShmHeader *header;
+} UcaPcowinShmReader;
+
+static inline gboolean
+uca_pcowin_shm_reader_open (UcaPcowinShmReader *reader, const gchar *name)
+{
+    reader->mapping = OpenFileMappingA (FILE_MAP_READ, FALSE, name);
+
+    if (reader->mapping == NULL)
+        return FALSE;
+
+    reader->base = (const guint8 *) MapViewOfFile (reader->mapping, FILE_MAP_READ, 0, 0, 0);
+    reader->header = (const UcaPcowinShmHeader *) reader->base;
+
+    if (reader->base == NULL || reader->header->magic != UCA_PCOWIN_SHM_MAGIC ||
+        reader->header->version != UCA_PCOWIN_SHM_VERSION) {
+        if (reader->base != NULL)
+            UnmapViewOfFile (reader->base);
+
+        CloseHandle (reader->mapping);
+        reader->mapping = NULL;
+        reader->base = NULL;
+        return FALSE;
+    }
+
+    return TRUE;
+}
+
+static inline void
+uca_pcowin_shm_reader_close (UcaPcowinShmReader *reader)
+{
+    if (reader->base != NULL)
+        UnmapViewOfFile (reader->base);
+
+    if (reader->mapping != NULL)
+        CloseHandle (reader->mapping);
+
+    reader->base = NULL;
+    reader->mapping = NULL;
+}
+
+static inline gint64
+uca_pcowin_shm_reader_latest (const UcaPcowinShmReader *reader)
+{
+    gint64 sequence = reader->header->last_sequence;
+
+    MemoryBarrier ();
+    return sequence;
+}
+
+static inline const UcaPcowinShmSlot *
+uca_pcowin_shm_reader_slot (const UcaPcowinShmReader *reader, gint64 sequence)
+{
+    return (const UcaPcowinShmSlot *) (reader->base + UCA_PCOWIN_SHM_HEADER_SIZE +
+                                       (gsize) (sequence % reader->header->n_slots) * reader->header->slot_stride);
+}
+
+/*
+ * Returns a pointer to the data of frame @sequence inside the mapping or NULL
+ * if that frame has not been published yet or was already overwritten. The
+ * data must be checked with uca_pcowin_shm_reader_validate() after use.
+ */
+static inline gconstpointer
+uca_pcowin_shm_reader_peek (const UcaPcowinShmReader *reader, gint64 sequence, UcaPcowinShmSlot *info)
+{
+    const UcaPcowinShmSlot *slot = uca_pcowin_shm_reader_slot (reader, sequence);
+
+    if (slot->sequence != 2 * sequence)
+        return NULL;
+
+    MemoryBarrier ();
+
+    if (info != NULL)
+        *info = *slot;
+
+    return (const guint8 *) slot + sizeof (UcaPcowinShmSlot);
+}
+
+static inline gboolean
+uca_pcowin_shm_reader_validate (const UcaPcowinShmReader *reader, gint64 sequence)
+{
+    MemoryBarrier ();
+    return uca_pcowin_shm_reader_slot (reader, sequence)->sequence == 2 * sequence;
+}
+
+G_END_DECLS
+
+#endif
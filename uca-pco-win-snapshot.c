@@ -0,0 +1,211 @@
+/**
+Copyright (C) 2016  Sai Sasidhar Maddali <sai.sasidhar92@gmail.com>
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+**/
+
+#include <string.h>
+
+#include "uca-pco-win-camera.h"
+#include "uca-pco-win-snapshot.h"
+
+#define SNAPSHOT_MAGIC      "PCOSNAP"
+#define SNAPSHOT_VERSION    1
+
+// Zero runs shorter than this are stored rather than starting a new span
+#define MIN_ZERO_RUN        8
+
+/*
+ * A snapshot is a header followed by one section per SDK structure. Most of
+ * the structures are reserved space, so a section only stores the spans of
+ * non-zero bytes, each as offset, length and data. All numbers are stored in
+ * host byte order, snapshots are not meant to move between machines.
+ */
+typedef struct {
+    gchar magic[8];
+    guint32 version;
+    guint32 serial_number;
+    guint16 camera_type;
+    guint16 reserved;
+} SnapshotHeader;
+
+typedef struct {
+    guint16 id;
+    guint16 n_spans;
+    guint32 struct_size;
+    guint32 length;
+} SectionHeader;
+
+typedef struct {
+    guint16 offset;
+    guint16 length;
+} SpanHeader;
+
+GByteArray *
+uca_pcowin_snapshot_new (guint16 camera_type, guint32 serial_number)
+{
+    GByteArray *snapshot;
+    SnapshotHeader header;
+
+    memset (&header, 0, sizeof (header));
+    memcpy (header.magic, SNAPSHOT_MAGIC, sizeof (SNAPSHOT_MAGIC));
+    header.version = SNAPSHOT_VERSION;
+    header.serial_number = serial_number;
+    header.camera_type = camera_type;
+
+    snapshot = g_byte_array_new ();
+    g_byte_array_append (snapshot, (const guint8 *) &header, sizeof (header));
+
+    return snapshot;
+}
+
+void
+uca_pcowin_snapshot_append (GByteArray *snapshot, guint16 id, gconstpointer data, gsize size)
+{
+    const guint8 *bytes = data;
+    SectionHeader section = { 0 };
+    guint section_start;
+    gsize i = 0;
+
+    g_return_if_fail (size <= G_MAXUINT16);
+
+    section_start = snapshot->len;
+    g_byte_array_append (snapshot, (const guint8 *) &section, sizeof (section));
+
+    while (i < size) {
+        SpanHeader span;
+        gsize end, zeros = 0;
+
+        if (bytes[i] == 0) {
+            i++;
+            continue;
+        }
+
+        // Extend the span until a long enough zero run or the end
+        for (end = i; end < size && zeros < MIN_ZERO_RUN; end++)
+            zeros = bytes[end] == 0 ? zeros + 1 : 0;
+
+        end -= zeros;
+        span.offset = (guint16) i;
+        span.length = (guint16) (end - i);
+        g_byte_array_append (snapshot, (const guint8 *) &span, sizeof (span));
+        g_byte_array_append (snapshot, bytes + i, span.length);
+        section.n_spans++;
+        i = end;
+    }
+
+    section.id = id;
+    section.struct_size = (guint32) size;
+    section.length = snapshot->len - section_start - sizeof (section);
+    memcpy (snapshot->data + section_start, &section, sizeof (section));
+}
+
+gboolean
+uca_pcowin_snapshot_check (GBytes *snapshot, guint16 camera_type, guint32 serial_number, GError **error)
+{
+    const SnapshotHeader *header;
+    gsize size;
+
+    header = g_bytes_get_data (snapshot, &size);
+
+    if (size < sizeof (SnapshotHeader) ||
+        memcmp (header->magic, SNAPSHOT_MAGIC, sizeof (SNAPSHOT_MAGIC)) != 0 ||
+        header->version != SNAPSHOT_VERSION) {
+        g_set_error_literal (error, UCA_PCOWIN_CAMERA_ERROR, UCA_PCOWIN_CAMERA_ERROR_GENERAL,
+                             "Not a camera snapshot of this version");
+        return FALSE;
+    }
+
+    // Other cameras of the same type accept the settings as well
+    if (header->camera_type != camera_type) {
+        g_set_error (error, UCA_PCOWIN_CAMERA_ERROR, UCA_PCOWIN_CAMERA_ERROR_UNSUPPORTED,
+                     "Snapshot of camera %u (type 0x%04X) does not fit camera type 0x%04X",
+                     header->serial_number, header->camera_type, camera_type);
+        return FALSE;
+    }
+
+    if (header->serial_number != serial_number)
+        g_debug ("Restoring snapshot of camera %u on camera %u", header->serial_number, serial_number);
+
+    return TRUE;
+}
+
+/*
+ * Decodes section @id into @data. The spans are written over @data, bytes
+ * that are not covered are zero. Fails if the section is missing or was
+ * written for a structure of another size.
+ */
+gboolean
+uca_pcowin_snapshot_lookup (GBytes *snapshot, guint16 id, gpointer data, gsize size, GError **error)
+{
+    const guint8 *bytes;
+    gsize total, pos;
+
+    bytes = g_bytes_get_data (snapshot, &total);
+    pos = sizeof (SnapshotHeader);
+
+    while (pos + sizeof (SectionHeader) <= total) {
+        SectionHeader section;
+        gsize end;
+
+        memcpy (&section, bytes + pos, sizeof (section));
+        pos += sizeof (section);
+        end = pos + section.length;
+
+        if (end > total)
+            break;
+
+        if (section.id != id) {
+            pos = end;
+            continue;
+        }
+
+        if (section.struct_size != size) {
+            g_set_error (error, UCA_PCOWIN_CAMERA_ERROR, UCA_PCOWIN_CAMERA_ERROR_UNSUPPORTED,
+                         "Snapshot section %u has %u bytes instead of %" G_GSIZE_FORMAT ", it was written with another SDK",
+                         id, section.struct_size, size);
+            return FALSE;
+        }
+
+        memset (data, 0, size);
+
+        for (guint i = 0; i < section.n_spans; i++) {
+            SpanHeader span;
+
+            if (pos + sizeof (span) > end)
+                break;
+
+            memcpy (&span, bytes + pos, sizeof (span));
+            pos += sizeof (span);
+
+            if ((gsize) span.offset + span.length > size || pos + span.length > end)
+                break;
+
+            memcpy ((guint8 *) data + span.offset, bytes + pos, span.length);
+            pos += span.length;
+        }
+
+        if (pos == end)
+            return TRUE;
+
+        break;
+    }
+
+    g_set_error (error, UCA_PCOWIN_CAMERA_ERROR, UCA_PCOWIN_CAMERA_ERROR_GENERAL,
+                 "Snapshot section %u is missing or damaged", id);
+
+    return FALSE;
+}
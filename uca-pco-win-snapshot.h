@@ -0,0 +1,45 @@
+/*
+Copyright (C) 2016  Sai Sasidhar Maddali <sai.sasidhar92@gmail.com>
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+
+#ifndef __UCA_PCOWIN_SNAPSHOT_H
+#define __UCA_PCOWIN_SNAPSHOT_H
+
+#include <glib.h>
+
+G_BEGIN_DECLS
+
+GByteArray         *uca_pcowin_snapshot_new         (guint16             camera_type,
+                                                     guint32             serial_number);
+void                uca_pcowin_snapshot_append      (GByteArray         *snapshot,
+                                                     guint16             id,
+                                                     gconstpointer       data,
+                                                     gsize               size);
+gboolean            uca_pcowin_snapshot_check       (GBytes             *snapshot,
+                                                     guint16             camera_type,
+                                                     guint32             serial_number,
+                                                     GError            **error);
+gboolean            uca_pcowin_snapshot_lookup      (GBytes             *snapshot,
+                                                     guint16             id,
+                                                     gpointer            data,
+                                                     gsize               size,
+                                                     GError            **error);
+
+G_END_DECLS
+
+#endif
@@ -0,0 +1,224 @@
+/**
+Copyright (C) 2016  Sai Sasidhar Maddali <sai.sasidhar92@gmail.com>
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+**/
+
+#include <minwindef.h>
+#include <sc2_defs.h>
+
+#include "uca-pco-win-transfer.h"
+
+// Frame rates within this relative distance count as equal
+#define FPS_TOLERANCE   1e-3
+
+/*
+ * Pixels per link clock as a fraction. The 80 bit pco.edge link carries five
+ * 16 bit or ten 8 bit pixels per clock, the 12 bit formats are packed.
+ */
+typedef struct {
+    guint32 data_format;
+    const gchar *name;
+    guint bits;
+    guint pixels_per_clock;
+    guint clocks;
+} FormatInfo;
+
+static const FormatInfo formats[] = {
+    { PCO_CL_DATAFORMAT_1x16,  "1x16",  16, 1,  1 },
+    { PCO_CL_DATAFORMAT_2x12,  "2x12",  12, 2,  1 },
+    { PCO_CL_DATAFORMAT_3x8,   "3x8",   8,  3,  1 },
+    { PCO_CL_DATAFORMAT_4x16,  "4x16",  16, 4,  1 },
+    { PCO_CL_DATAFORMAT_5x16,  "5x16",  16, 5,  1 },
+    { PCO_CL_DATAFORMAT_5x12,  "5x12",  12, 20, 3 },
+    { PCO_CL_DATAFORMAT_10x8,  "10x8",  8,  10, 1 },
+    { PCO_CL_DATAFORMAT_5x12L, "5x12L", 12, 20, 3 },
+    { PCO_CL_DATAFORMAT_5x12R, "5x12R", 12, 20, 3 },
+};
+
+static const FormatInfo *
+find_format (guint32 data_format)
+{
+    for (guint i = 0; i < G_N_ELEMENTS (formats); i++) {
+        if (formats[i].data_format == (data_format & PCO_CL_DATAFORMAT_MASK))
+            return &formats[i];
+    }
+
+    return NULL;
+}
+
+const gchar *
+uca_pcowin_transfer_format_name (guint32 data_format)
+{
+    const FormatInfo *info = find_format (data_format);
+
+    return info != NULL ? info->name : "unknown";
+}
+
+gboolean
+uca_pcowin_transfer_describe (guint32 data_format, guint16 lut, guint sensor_bits, UcaPcowinTransferMode *mode)
+{
+    const FormatInfo *info = find_format (data_format);
+
+    if (info == NULL)
+        return FALSE;
+
+    mode->data_format = info->data_format;
+    mode->lut = lut;
+    mode->bits = info->bits;
+    mode->lossless = lut == 0 && info->bits >= sensor_bits;
+
+    return TRUE;
+}
+
+static void
+add_mode (UcaPcowinTransferMode *modes, guint *n_modes, guint32 data_format, guint16 lut, guint sensor_bits)
+{
+    if (*n_modes < UCA_PCOWIN_TRANSFER_MAX_MODES &&
+        uca_pcowin_transfer_describe (data_format, lut, sensor_bits, &modes[*n_modes]))
+        (*n_modes)++;
+}
+
+/*
+ * Fills @modes with the transfer settings the camera supports, at most
+ * UCA_PCOWIN_TRANSFER_MAX_MODES. Formats narrower than the sensor are only
+ * listed together with a LUT that compresses into them, except for the
+ * pco.edge linear 12 bit formats which drop the lower or upper bits. Returns
+ * 0 for cameras whose transfer formats are unknown.
+ */
+guint
+uca_pcowin_transfer_list_modes (guint16 camera_type, guint sensor_bits, const UcaPcowinTransferLut *luts, guint n_luts, UcaPcowinTransferMode *modes)
+{
+    guint n_modes = 0;
+
+    if ((camera_type & 0xFF00) == CAMERATYPE_PCO_EDGE) {
+        add_mode (modes, &n_modes, PCO_CL_DATAFORMAT_5x16, 0, sensor_bits);
+        add_mode (modes, &n_modes, PCO_CL_DATAFORMAT_5x12L, 0, sensor_bits);
+        add_mode (modes, &n_modes, PCO_CL_DATAFORMAT_5x12R, 0, sensor_bits);
+
+        for (guint i = 0; i < n_luts; i++) {
+            if (luts[i].output_bits == 12)
+                add_mode (modes, &n_modes, PCO_CL_DATAFORMAT_5x12, luts[i].identifier, sensor_bits);
+            else if (luts[i].output_bits == 8)
+                add_mode (modes, &n_modes, PCO_CL_DATAFORMAT_10x8, luts[i].identifier, sensor_bits);
+        }
+    }
+    else if (camera_type == CAMERATYPE_PCO_DIMAX_STD) {
+        add_mode (modes, &n_modes, PCO_CL_DATAFORMAT_1x16, 0, sensor_bits);
+        add_mode (modes, &n_modes, PCO_CL_DATAFORMAT_2x12, 0, sensor_bits);
+
+        for (guint i = 0; i < n_luts; i++) {
+            if (luts[i].output_bits == 8)
+                add_mode (modes, &n_modes, PCO_CL_DATAFORMAT_3x8, luts[i].identifier, sensor_bits);
+        }
+    }
+
+    return n_modes;
+}
+
+/*
+ * Frame rate achievable with @mode, the lower of what the link carries at
+ * @clock_frequency and what the sensor delivers. Line and frame overhead of
+ * the link are ignored. @sensor_fps may be 0 if it is not known.
+ */
+gdouble
+uca_pcowin_transfer_get_fps (const UcaPcowinTransferMode *mode, guint32 clock_frequency, guint64 frame_pixels, gdouble sensor_fps)
+{
+    const FormatInfo *info = find_format (mode->data_format);
+    gdouble link_fps;
+
+    if (info == NULL || frame_pixels == 0)
+        return 0.0;
+
+    link_fps = (gdouble) clock_frequency * info->pixels_per_clock / info->clocks / frame_pixels;
+
+    return sensor_fps > 0.0 ? MIN (link_fps, sensor_fps) : link_fps;
+}
+
+/*
+ * Index of the mode with the highest achievable frame rate. Among modes that
+ * are equally fast the lossless and then the widest one wins, so that a LUT
+ * is only used if the link would otherwise limit the frame rate. Returns -1
+ * if @n_modes is 0.
+ */
+gint
+uca_pcowin_transfer_select (const UcaPcowinTransferMode *modes, guint n_modes, guint32 clock_frequency, guint64 frame_pixels, gdouble sensor_fps)
+{
+    gint best = -1;
+    gdouble best_fps = 0.0;
+
+    for (guint i = 0; i < n_modes; i++) {
+        gdouble fps = uca_pcowin_transfer_get_fps (&modes[i], clock_frequency, frame_pixels, sensor_fps);
+        gboolean better;
+
+        if (best < 0 || fps > best_fps * (1.0 + FPS_TOLERANCE))
+            better = TRUE;
+        else if (fps < best_fps * (1.0 - FPS_TOLERANCE))
+            better = FALSE;
+        else if (modes[i].lossless != modes[best].lossless)
+            better = modes[i].lossless;
+        else
+            better = modes[i].bits > modes[best].bits;
+
+        if (better) {
+            best = i;
+            best_fps = fps;
+        }
+    }
+
+    return best;
+}
+
+static void
+append_mode (GString *report, const UcaPcowinTransferMode *mode, guint32 clock_frequency, guint64 frame_pixels, gdouble sensor_fps, gboolean active, gboolean selected)
+{
+    g_string_append_printf (report, "%-5s lut=0x%04x bits=%u %s link=%.1f fps achievable=%.1f fps%s%s\n",
+                            uca_pcowin_transfer_format_name (mode->data_format), mode->lut, mode->bits,
+                            mode->lossless ? "lossless" : "lossy",
+                            uca_pcowin_transfer_get_fps (mode, clock_frequency, frame_pixels, 0.0),
+                            uca_pcowin_transfer_get_fps (mode, clock_frequency, frame_pixels, sensor_fps),
+                            active ? " active" : "", selected ? " selected" : "");
+}
+
+/*
+ * One line per mode with the frame rate the link allows and the frame rate
+ * achievable with the sensor, marking the @active mode and the one
+ * uca_pcowin_transfer_select() would pick. Free with g_free().
+ */
+gchar *
+uca_pcowin_transfer_report (const UcaPcowinTransferMode *modes, guint n_modes, const UcaPcowinTransferMode *active, guint32 clock_frequency, guint64 frame_pixels, gdouble sensor_fps)
+{
+    GString *report;
+    gboolean active_listed = FALSE;
+    gint selected;
+
+    report = g_string_new (NULL);
+    selected = uca_pcowin_transfer_select (modes, n_modes, clock_frequency, frame_pixels, sensor_fps);
+    g_string_append_printf (report, "clock=%u Hz frame=%" G_GUINT64_FORMAT " px sensor=%.1f fps\n",
+                            clock_frequency, frame_pixels, sensor_fps);
+
+    for (guint i = 0; i < n_modes; i++) {
+        gboolean is_active = active != NULL && modes[i].data_format == active->data_format && modes[i].lut == active->lut;
+
+        active_listed = active_listed || is_active;
+        append_mode (report, &modes[i], clock_frequency, frame_pixels, sensor_fps, is_active, (gint) i == selected);
+    }
+
+    if (active != NULL && !active_listed)
+        append_mode (report, active, clock_frequency, frame_pixels, sensor_fps, TRUE, FALSE);
+
+    return g_string_free (report, FALSE);
+}
@@ -0,0 +1,77 @@
+/*
+Copyright (C) 2016  Sai Sasidhar Maddali <sai.sasidhar92@gmail.com>
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+
+#ifndef __UCA_PCOWIN_TRANSFER_H
+#define __UCA_PCOWIN_TRANSFER_H
+
+#include <glib.h>
+
+G_BEGIN_DECLS
+
+#define UCA_PCOWIN_TRANSFER_MAX_MODES   32
+
+/*
+ * A CameraLink transfer setting. @data_format is one of the
+ * PCO_CL_DATAFORMAT_* values without the sCMOS readout order bits, @lut is
+ * the identifier of the camera LUT applied before sending or 0 if pixels are
+ * sent unchanged.
+ */
+typedef struct {
+    guint32 data_format;
+    guint16 lut;
+    guint bits;
+    gboolean lossless;
+} UcaPcowinTransferMode;
+
+// A lookup table of the camera, from PCO_GetLookupTableInfo
+typedef struct {
+    guint16 identifier;
+    guint input_bits;
+    guint output_bits;
+} UcaPcowinTransferLut;
+
+guint               uca_pcowin_transfer_list_modes  (guint16             camera_type,
+                                                     guint               sensor_bits,
+                                                     const UcaPcowinTransferLut *luts,
+                                                     guint               n_luts,
+                                                     UcaPcowinTransferMode *modes);
+gboolean            uca_pcowin_transfer_describe    (guint32             data_format,
+                                                     guint16             lut,
+                                                     guint               sensor_bits,
+                                                     UcaPcowinTransferMode *mode);
+gdouble             uca_pcowin_transfer_get_fps     (const UcaPcowinTransferMode *mode,
+                                                     guint32             clock_frequency,
+                                                     guint64             frame_pixels,
+                                                     gdouble             sensor_fps);
+gint                uca_pcowin_transfer_select      (const UcaPcowinTransferMode *modes,
+                                                     guint               n_modes,
+                                                     guint32             clock_frequency,
+                                                     guint64             frame_pixels,
+                                                     gdouble             sensor_fps);
+gchar              *uca_pcowin_transfer_report      (const UcaPcowinTransferMode *modes,
+                                                     guint               n_modes,
+                                                     const UcaPcowinTransferMode *active,
+                                                     guint32             clock_frequency,
+                                                     guint64             frame_pixels,
+                                                     gdouble             sensor_fps);
+const gchar        *uca_pcowin_transfer_format_name (guint32             data_format);
+
+G_END_DECLS
+
+#endif
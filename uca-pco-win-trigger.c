@@ -0,0 +1,249 @@
+/**
+Copyright (C) 2016  Sai Sasidhar Maddali <sai.sasidhar92@gmail.com>
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+**/
+
+#include <string.h>
+#include <minwindef.h>
+#include <sc2_SDKStructures.h>
+#include <sc2_defs.h>
+#include <SC2_CamExport.h>
+#include <PCO_err.h>
+#include <windows.h>
+
+#include "uca-pco-win-camera.h"
+#include "uca-pco-win-trigger.h"
+
+#define ERROR_TEXT_BUFFER_SIZE  500
+
+// Sleeping is only accurate to about a timer period, the rest is spent spinning
+#define SPIN_THRESHOLD_US       2000
+
+// Longest sleep, so that cancellation is noticed quickly
+#define MAX_SLEEP_MS            10
+
+struct _UcaPcowinTriggerSequence {
+    HANDLE pco;
+    UcaPcowinScheduler *scheduler;
+    GThread *thread;
+    gint cancelled;
+    gint issued;
+
+    guint n_triggers;
+    UcaPcowinTriggerRecord *records;
+
+    // Shortest time between triggers after which the camera cannot be busy anymore
+    gint64 frame_time;
+    gint library_errors;
+};
+
+static inline gint64
+ticks_to_us (gint64 ticks, gint64 frequency)
+{
+    return ticks / frequency * G_USEC_PER_SEC + (ticks % frequency) * G_USEC_PER_SEC / frequency;
+}
+
+/*
+ * Sleeps until shortly before @target and spins for the rest. Returns FALSE
+ * if the sequence was cancelled meanwhile.
+ */
+static gboolean
+wait_until (UcaPcowinTriggerSequence *sequence, gint64 start, gint64 target, gint64 frequency)
+{
+    LARGE_INTEGER now;
+
+    for (;;) {
+        gint64 remaining;
+
+        if (g_atomic_int_get (&sequence->cancelled))
+            return FALSE;
+
+        QueryPerformanceCounter (&now);
+        remaining = target - ticks_to_us (now.QuadPart - start, frequency);
+
+        if (remaining <= 0)
+            return TRUE;
+
+        if (remaining > SPIN_THRESHOLD_US)
+            Sleep ((DWORD) MIN ((remaining - SPIN_THRESHOLD_US) / 1000 + 1, MAX_SLEEP_MS));
+        else
+            YieldProcessor ();
+    }
+}
+
+static gpointer
+run_sequence (UcaPcowinTriggerSequence *sequence)
+{
+    LARGE_INTEGER frequency, start, now;
+    gboolean has_triggered = FALSE;
+    gint64 last_trigger = 0;
+
+    SetThreadPriority (GetCurrentThread (), THREAD_PRIORITY_TIME_CRITICAL);
+    timeBeginPeriod (1);
+    QueryPerformanceFrequency (&frequency);
+    QueryPerformanceCounter (&start);
+
+    for (guint i = 0; i < sequence->n_triggers; i++) {
+        UcaPcowinTriggerRecord *record = &sequence->records[i];
+        WORD is_camera_busy = 0;
+        WORD trigger_state = 0;
+        gint library_errors;
+
+        if (!wait_until (sequence, start.QuadPart, record->scheduled, frequency.QuadPart))
+            break;
+
+        QueryPerformanceCounter (&now);
+
+        /*
+         * A trigger sent to a busy camera does not trigger future exposures
+         * either, but once a whole frame time has passed since the last one
+         * the camera must be idle and the round trip can be saved.
+         */
+        if (!has_triggered || ticks_to_us (now.QuadPart - start.QuadPart, frequency.QuadPart) - last_trigger < sequence->frame_time) {
+            library_errors = UCA_PCOWIN_SCHEDULE (sequence->scheduler, UCA_PCOWIN_PRIORITY_TRANSFER,
+                                                  PCO_GetCameraBusyStatus (sequence->pco, &is_camera_busy));
+
+            if (library_errors) {
+                sequence->library_errors = library_errors;
+                break;
+            }
+        }
+
+        if (!is_camera_busy) {
+            library_errors = UCA_PCOWIN_SCHEDULE (sequence->scheduler, UCA_PCOWIN_PRIORITY_TRANSFER,
+                                                  PCO_ForceTrigger (sequence->pco, &trigger_state));
+
+            if (library_errors) {
+                sequence->library_errors = library_errors;
+                break;
+            }
+        }
+
+        QueryPerformanceCounter (&now);
+
+        if (trigger_state) {
+            record->issued = ticks_to_us (now.QuadPart - start.QuadPart, frequency.QuadPart);
+            record->latency = record->issued - record->scheduled;
+            last_trigger = record->issued;
+            has_triggered = TRUE;
+        }
+        else
+            record->skipped = TRUE;
+
+        g_atomic_int_inc (&sequence->issued);
+    }
+
+    timeEndPeriod (1);
+
+    return NULL;
+}
+
+/*
+ * Starts issuing software triggers at @times microseconds after now on a
+ * dedicated time-critical thread. @times must be in ascending order.
+ */
+UcaPcowinTriggerSequence *
+uca_pcowin_trigger_sequence_start (gpointer pco_handle, UcaPcowinScheduler *scheduler, const gint64 *times, guint n_triggers, GError **error)
+{
+    UcaPcowinTriggerSequence *sequence;
+    DWORD runtime_s = 0, runtime_ns = 0;
+
+    sequence = g_new0 (UcaPcowinTriggerSequence, 1);
+    sequence->pco = pco_handle;
+    sequence->scheduler = scheduler;
+    sequence->n_triggers = n_triggers;
+    sequence->records = g_new0 (UcaPcowinTriggerRecord, n_triggers);
+
+    for (guint i = 0; i < n_triggers; i++) {
+        sequence->records[i].scheduled = times[i];
+        sequence->records[i].issued = -1;
+    }
+
+    // Without a known frame time every trigger is preceded by a busy check
+    if (UCA_PCOWIN_SCHEDULE (scheduler, UCA_PCOWIN_PRIORITY_QUERY, PCO_GetCOCRuntime (pco_handle, &runtime_s, &runtime_ns)) == PCO_NOERROR)
+        sequence->frame_time = (gint64) runtime_s * G_USEC_PER_SEC + runtime_ns / 1000 + 1;
+    else
+        sequence->frame_time = G_MAXINT64;
+
+    sequence->thread = g_thread_try_new ("pco-trigger", (GThreadFunc) run_sequence, sequence, error);
+
+    if (sequence->thread == NULL) {
+        uca_pcowin_trigger_sequence_free (sequence);
+        return NULL;
+    }
+
+    return sequence;
+}
+
+/*
+ * Waits for the sequence to end, cancelling the remaining triggers first if
+ * @cancel is set.
+ */
+gboolean
+uca_pcowin_trigger_sequence_finish (UcaPcowinTriggerSequence *sequence, gboolean cancel, GError **error)
+{
+    if (cancel)
+        g_atomic_int_set (&sequence->cancelled, TRUE);
+
+    if (sequence->thread != NULL) {
+        g_thread_join (sequence->thread);
+        sequence->thread = NULL;
+    }
+
+    if (sequence->library_errors) {
+        gchar error_text[ERROR_TEXT_BUFFER_SIZE];
+
+        PCO_GetErrorText (sequence->library_errors, error_text, ERROR_TEXT_BUFFER_SIZE);
+        g_set_error (error, UCA_PCOWIN_CAMERA_ERROR, UCA_PCOWIN_CAMERA_ERROR_SDKERROR,
+                     "Trigger %u failed, PCO SDK error code 0x%X: %s",
+                     uca_pcowin_trigger_sequence_get_issued (sequence), sequence->library_errors, error_text);
+        return FALSE;
+    }
+
+    return TRUE;
+}
+
+void
+uca_pcowin_trigger_sequence_free (UcaPcowinTriggerSequence *sequence)
+{
+    if (sequence == NULL)
+        return;
+
+    uca_pcowin_trigger_sequence_finish (sequence, TRUE, NULL);
+    g_free (sequence->records);
+    g_free (sequence);
+}
+
+// Number of triggers issued or skipped so far, safe to call while running
+guint
+uca_pcowin_trigger_sequence_get_issued (UcaPcowinTriggerSequence *sequence)
+{
+    return (guint) g_atomic_int_get (&sequence->issued);
+}
+
+/*
+ * Records of all triggers, only the first uca_pcowin_trigger_sequence_get_issued()
+ * are meaningful once the sequence finished.
+ */
+const UcaPcowinTriggerRecord *
+uca_pcowin_trigger_sequence_get_records (UcaPcowinTriggerSequence *sequence, guint *n_records)
+{
+    if (n_records)
+        *n_records = uca_pcowin_trigger_sequence_get_issued (sequence);
+
+    return sequence->records;
+}
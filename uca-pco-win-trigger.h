@@ -0,0 +1,64 @@
+/*
+Copyright (C) 2016  Sai Sasidhar Maddali <sai.sasidhar92@gmail.com>
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+
+#ifndef __UCA_PCOWIN_TRIGGER_H
+#define __UCA_PCOWIN_TRIGGER_H
+
+#include <glib.h>
+#include "uca-pco-win-scheduler.h"
+
+G_BEGIN_DECLS
+
+/*
+ * Outcome of one software trigger of a sequence. Times are in microseconds
+ * relative to the start of the sequence, @issued is taken when
+ * PCO_ForceTrigger returned and is -1 for skipped triggers.
+ */
+typedef struct {
+    gint64 scheduled;
+    gint64 issued;
+    gint64 latency;
+    gboolean skipped;
+} UcaPcowinTriggerRecord;
+
+typedef struct _UcaPcowinTriggerSequence UcaPcowinTriggerSequence;
+
+UcaPcowinTriggerSequence *
+                    uca_pcowin_trigger_sequence_start
+                                                    (gpointer            pco_handle,
+                                                     UcaPcowinScheduler *scheduler,
+                                                     const gint64       *times,
+                                                     guint               n_triggers,
+                                                     GError            **error);
+gboolean            uca_pcowin_trigger_sequence_finish
+                                                    (UcaPcowinTriggerSequence *sequence,
+                                                     gboolean            cancel,
+                                                     GError            **error);
+void                uca_pcowin_trigger_sequence_free
+                                                    (UcaPcowinTriggerSequence *sequence);
+guint               uca_pcowin_trigger_sequence_get_issued
+                                                    (UcaPcowinTriggerSequence *sequence);
+const UcaPcowinTriggerRecord *
+                    uca_pcowin_trigger_sequence_get_records
+                                                    (UcaPcowinTriggerSequence *sequence,
+                                                     guint              *n_records);
+
+G_END_DECLS
+
+#endif